@@ -0,0 +1,137 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// This benchmark measures the speed of JSON.parse and JSON.stringify on
+// a text that looks like a typical web service response: an array of records that share
+// the same keys, with nested objects and arrays, strings with and
+// without escape sequences, integers and floating point numbers.
+
+var JSONBenchmark = new BenchmarkSuite('JSON', 63000, [
+  new Benchmark("JSONParse", JSONParseRun, JSONParseSetup, JSONParseTearDown),
+  new Benchmark("JSONStringify", JSONStringifyRun, JSONStringifySetup,
+                JSONStringifyTearDown)
+]);
+
+
+// Configuration.
+var kJSONRecordCount = 500;
+
+var jsonText = null;
+var jsonChecksum = 0;
+var jsonObject = null;
+
+
+function JSONGenerateString(length) {
+  var result = "";
+  for (var i = 0; i < length; i++) {
+    result += String.fromCharCode(97 + Math.floor(Math.random() * 26));
+  }
+  return result;
+}
+
+
+function JSONGenerateRecord(id) {
+  var tags = [];
+  var tagCount = Math.floor(Math.random() * 5);
+  for (var i = 0; i < tagCount; i++) tags.push(JSONGenerateString(6));
+  return {
+    id: id,
+    name: JSONGenerateString(12),
+    email: JSONGenerateString(8) + "@" + JSONGenerateString(6) + ".com",
+    active: Math.random() < 0.5,
+    score: Math.floor(Math.random() * 1000000) / 1000,
+    tags: tags,
+    address: {
+      street: Math.floor(Math.random() * 1000) + " " + JSONGenerateString(10),
+      city: JSONGenerateString(9),
+      zip: Math.floor(Math.random() * 100000)
+    },
+    note: "line \"" + JSONGenerateString(5) + "\"\n\ttab\\slash/" +
+        String.fromCharCode(0x2028),
+    parent: null
+  };
+}
+
+
+function JSONRecordChecksum(record) {
+  return record.id + record.name.length + record.tags.length +
+      record.address.zip + (record.active ? 1 : 0) + record.note.length;
+}
+
+
+function JSONParseSetup() {
+  var records = [];
+  jsonChecksum = 0;
+  for (var i = 0; i < kJSONRecordCount; i++) {
+    var record = JSONGenerateRecord(i);
+    jsonChecksum += JSONRecordChecksum(record);
+    records.push(record);
+  }
+  jsonText = JSON.stringify({ status: "ok", count: records.length,
+                              records: records });
+}
+
+
+function JSONParseTearDown() {
+  jsonText = null;
+}
+
+
+function JSONParseRun() {
+  var result = JSON.parse(jsonText);
+  if (result.count != kJSONRecordCount) {
+    throw new Error("JSON.parse returned the wrong number of records");
+  }
+  var checksum = 0;
+  var records = result.records;
+  for (var i = 0; i < records.length; i++) {
+    checksum += JSONRecordChecksum(records[i]);
+  }
+  if (checksum != jsonChecksum) {
+    throw new Error("JSON.parse returned the wrong records");
+  }
+}
+
+
+function JSONStringifySetup() {
+  JSONParseSetup();
+  jsonObject = JSON.parse(jsonText);
+}
+
+
+function JSONStringifyTearDown() {
+  jsonObject = null;
+  JSONParseTearDown();
+}
+
+
+function JSONStringifyRun() {
+  var text = JSON.stringify(jsonObject);
+  if (text.length != jsonText.length) {
+    throw new Error("JSON.stringify returned the wrong text");
+  }
+}
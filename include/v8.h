@@ -2313,10 +2313,15 @@ class V8EXPORT ResourceConstraints {
   uint32_t* stack_limit() const { return stack_limit_; }
   // Sets an address beyond which the VM's stack may not grow.
   void set_stack_limit(uint32_t* value) { stack_limit_ = value; }
+  int target_footprint() const { return target_footprint_; }
+  // Sets the committed heap size in bytes below which idle notifications
+  // do not shrink the heap.
+  void set_target_footprint(int value) { target_footprint_ = value; }
  private:
   int max_young_space_size_;
   int max_old_space_size_;
   uint32_t* stack_limit_;
+  int target_footprint_;
 };
 
 
@@ -2424,13 +2429,18 @@ class V8EXPORT HeapStatistics {
   HeapStatistics();
   size_t total_heap_size() { return total_heap_size_; }
   size_t used_heap_size() { return used_heap_size_; }
+  // Bytes that idle notifications and low memory notifications returned
+  // to the operating system so far.
+  size_t reclaimed_heap_size() { return reclaimed_heap_size_; }
 
  private:
   void set_total_heap_size(size_t size) { total_heap_size_ = size; }
   void set_used_heap_size(size_t size) { used_heap_size_ = size; }
+  void set_reclaimed_heap_size(size_t size) { reclaimed_heap_size_ = size; }
 
   size_t total_heap_size_;
   size_t used_heap_size_;
+  size_t reclaimed_heap_size_;
 
   friend class V8;
 };
@@ -2768,7 +2778,10 @@ class V8EXPORT V8 {
 
   /**
    * Optional notification that the embedder is idle.
-   * V8 uses the notification to reduce memory footprint.
+   * V8 uses the notification to reduce memory footprint.  If much more
+   * memory is committed for the heap than the live objects need, and more
+   * than the target footprint (see ResourceConstraints), the heap is
+   * compacted and the unused memory returned to the operating system.
    * This call can be used repeatedly if the embedder remains idle.
    * Returns true if the embedder should stop calling IdleNotification
    * until real work has been done.  This indicates that V8 has done
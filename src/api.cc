@@ -392,7 +392,8 @@ v8::Handle<Boolean> False() {
 ResourceConstraints::ResourceConstraints()
   : max_young_space_size_(0),
     max_old_space_size_(0),
-    stack_limit_(NULL) { }
+    stack_limit_(NULL),
+    target_footprint_(0) { }
 
 
 bool SetResourceConstraints(ResourceConstraints* constraints) {
@@ -406,6 +407,9 @@ bool SetResourceConstraints(ResourceConstraints* constraints) {
     uintptr_t limit = reinterpret_cast<uintptr_t>(constraints->stack_limit());
     i::StackGuard::SetStackLimit(limit);
   }
+  if (constraints->target_footprint() != 0) {
+    i::Heap::SetTargetFootprint(constraints->target_footprint());
+  }
   return true;
 }
 
@@ -3191,12 +3195,15 @@ bool v8::V8::Dispose() {
 }
 
 
-HeapStatistics::HeapStatistics(): total_heap_size_(0), used_heap_size_(0) { }
+HeapStatistics::HeapStatistics(): total_heap_size_(0),
+                                  used_heap_size_(0),
+                                  reclaimed_heap_size_(0) { }
 
 
 void v8::V8::GetHeapStatistics(HeapStatistics* heap_statistics) {
   heap_statistics->set_total_heap_size(i::Heap::CommittedMemory());
   heap_statistics->set_used_heap_size(i::Heap::SizeOfObjects());
+  heap_statistics->set_reclaimed_heap_size(i::Heap::ReclaimedMemory());
 }
 
 
@@ -3210,7 +3217,7 @@ bool v8::V8::IdleNotification() {
 
 void v8::V8::LowMemoryNotification() {
   if (!i::V8::IsRunning()) return;
-  i::Heap::CollectAllGarbage(true);
+  i::Heap::ReduceMemoryFootprint();
 }
 
 
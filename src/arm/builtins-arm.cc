@@ -558,6 +558,21 @@ static void Generate_JSConstructStubHelper(MacroAssembler* masm,
     __ CompareInstanceType(r2, r3, JS_FUNCTION_TYPE);
     __ b(eq, &rt_call);
 
+    // Leave the allocation to the runtime while the allocation site of the
+    // constructor collects feedback, or when it tenures the objects.
+    // r1: constructor function
+    // r2: initial map
+    // r7: undefined value
+    Label allocate;
+    __ ldr(r3, FieldMemOperand(r1, JSFunction::kSharedFunctionInfoOffset));
+    __ ldr(r3, FieldMemOperand(r3, SharedFunctionInfo::kAllocationSiteOffset));
+    __ cmp(r3, r7);
+    __ b(eq, &allocate);
+    __ ldr(r3, FieldMemOperand(r3, AllocationSite::kStateOffset));
+    __ cmp(r3, Operand(Smi::FromInt(AllocationSite::kPending)));
+    __ b(lt, &rt_call);
+    __ bind(&allocate);
+
     // Now allocate the JSObject on the heap.
     // r1: constructor function
     // r2: initial map
@@ -930,6 +945,29 @@ void Builtins::Generate_LazyCompile(MacroAssembler* masm) {
 }
 
 
+void Builtins::Generate_LazyRecompile(MacroAssembler* masm) {
+  // Enter an internal frame.
+  __ EnterInternalFrame();
+
+  // Preserve the function.
+  __ push(r1);
+
+  // Push the function on the stack as the argument to the runtime function.
+  __ push(r1);
+  __ CallRuntime(Runtime::kLazyRecompile, 1);
+  // Calculate the entry point.
+  __ add(r2, r0, Operand(Code::kHeaderSize - kHeapObjectTag));
+  // Restore saved function.
+  __ pop(r1);
+
+  // Tear down temporary frame.
+  __ LeaveInternalFrame();
+
+  // Do a tail-call of the recompiled function.
+  __ Jump(r2);
+}
+
+
 void Builtins::Generate_FunctionCall(MacroAssembler* masm) {
   // 1. Make sure we have at least one argument.
   // r0: actual number of arguments
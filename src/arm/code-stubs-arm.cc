@@ -178,6 +178,20 @@ void FastCloneShallowArrayStub::Generate(MacroAssembler* masm) {
   __ cmp(r3, ip);
   __ b(eq, &slow_case);
 
+  // Leave the cloning to the runtime while the allocation site of the literal
+  // collects feedback, or when it tenures the arrays.
+  Label allocate;
+  __ ldr(r1, MemOperand(sp, 2 * kPointerSize));
+  __ add(r1, r1, Operand(FixedArray::kHeaderSize + kPointerSize -
+                         kHeapObjectTag));
+  __ ldr(r1, MemOperand(r1, r0, LSL, kPointerSizeLog2 - kSmiTagSize));
+  __ cmp(r1, ip);
+  __ b(eq, &allocate);
+  __ ldr(r1, FieldMemOperand(r1, AllocationSite::kStateOffset));
+  __ cmp(r1, Operand(Smi::FromInt(AllocationSite::kPending)));
+  __ b(lt, &slow_case);
+  __ bind(&allocate);
+
   if (FLAG_debug_code) {
     const char* message;
     Heap::RootListIndex expected_map_index;
@@ -3616,6 +3630,62 @@ int CompareStub::MinorKey() {
 }
 
 
+// The ARM code generators still call CompareStub directly.
+Token::Value ICCompareStub::ComputeOperation(Condition cc, bool strict) {
+  switch (cc) {
+    case eq: return strict ? Token::EQ_STRICT : Token::EQ;
+    case lt: return Token::LT;
+    case gt: return Token::GT;
+    case le: return Token::LTE;
+    case ge: return Token::GTE;
+    default:
+      UNREACHABLE();
+      return Token::ILLEGAL;
+  }
+}
+
+
+Condition ICCompareStub::GetCondition() {
+  switch (op_) {
+    case Token::EQ:
+    case Token::EQ_STRICT:
+      return eq;
+    case Token::LT: return lt;
+    case Token::GT: return gt;
+    case Token::LTE: return le;
+    case Token::GTE: return ge;
+    default:
+      UNREACHABLE();
+      return no_condition;
+  }
+}
+
+
+void ICCompareStub::GenerateHeapNumbers(MacroAssembler* masm) {
+  UNIMPLEMENTED();
+}
+
+
+void ICCompareStub::GenerateSymbols(MacroAssembler* masm) {
+  UNIMPLEMENTED();
+}
+
+
+void ICCompareStub::GenerateStrings(MacroAssembler* masm) {
+  UNIMPLEMENTED();
+}
+
+
+void ICCompareStub::GenerateObjects(MacroAssembler* masm) {
+  UNIMPLEMENTED();
+}
+
+
+void ICCompareStub::GenerateMiss(MacroAssembler* masm) {
+  UNIMPLEMENTED();
+}
+
+
 // StringCharCodeAtGenerator
 
 void StringCharCodeAtGenerator::GenerateFast(MacroAssembler* masm) {
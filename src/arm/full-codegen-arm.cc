@@ -62,6 +62,8 @@ void FullCodeGenerator::Generate(CompilationInfo* info) {
   SetFunctionPosition(function());
   Comment cmnt(masm_, "[ function compiled by full code generator");
 
+  EmitTierUpCheck();
+
   int locals_count = scope()->num_stack_slots();
 
   __ Push(lr, fp, cp, r1);
@@ -199,6 +201,43 @@ void FullCodeGenerator::Generate(CompilationInfo* info) {
 }
 
 
+void FullCodeGenerator::EmitTierUpCheck() {
+  if (!info_->has_tier_up_check()) return;
+  Comment cmnt(masm_, "[ Tier-up check");
+  // Call stubs embedding this code can still reach it after the function
+  // has been recompiled.  Continue in the current code of the function
+  // then, as frames find their code through the function.
+  __ mov(r2, Operand(masm_->CodeObject()));
+  __ add(r2, r2, Operand(Code::kHeaderSize - kHeapObjectTag));
+  __ ldr(r3, FieldMemOperand(r1, JSFunction::kCodeEntryOffset));
+  __ cmp(r2, r3);
+  __ Jump(r3, ne);
+
+  // Count the call and recompile the function once it gets hot.  The
+  // frame has not been built yet, so the recompiled code can be entered
+  // with a tail call.
+  __ ldr(r2, FieldMemOperand(r1, JSFunction::kSharedFunctionInfoOffset));
+  __ ldr(r3, FieldMemOperand(r2, SharedFunctionInfo::kTierUpCounterOffset));
+  __ sub(r3, r3, Operand(Smi::FromInt(1)), SetCC);
+  __ str(r3, FieldMemOperand(r2, SharedFunctionInfo::kTierUpCounterOffset));
+  __ Jump(Handle<Code>(Builtins::builtin(Builtins::LazyRecompile)),
+          RelocInfo::CODE_TARGET,
+          le);
+}
+
+
+void FullCodeGenerator::EmitBackEdgeCheck(IterationStatement* stmt) {
+  if (!info_->has_tier_up_check()) return;
+  // On-stack replacement is not implemented on ARM yet, so hot loops only
+  // count towards recompilation on the next call.
+  __ ldr(r2, MemOperand(fp, JavaScriptFrameConstants::kFunctionOffset));
+  __ ldr(r2, FieldMemOperand(r2, JSFunction::kSharedFunctionInfoOffset));
+  __ ldr(r3, FieldMemOperand(r2, SharedFunctionInfo::kTierUpCounterOffset));
+  __ sub(r3, r3, Operand(Smi::FromInt(1)));
+  __ str(r3, FieldMemOperand(r2, SharedFunctionInfo::kTierUpCounterOffset));
+}
+
+
 void FullCodeGenerator::EmitReturnSequence() {
   Comment cmnt(masm_, "[ Return sequence");
   if (return_label_.is_bound()) {
@@ -848,6 +848,25 @@ static Object* GenerateCheckPropertyCell(MacroAssembler* masm,
 }
 
 
+// Checks the map of the receiver against each of the maps and jumps to
+// the corresponding handler on a match. Falls through on a mismatch.
+static void GenerateMapDispatch(MacroAssembler* masm,
+                                Register receiver,
+                                Register scratch,
+                                List<Map*>* maps,
+                                List<Code*>* handlers,
+                                Label* miss) {
+  ASSERT(maps->length() == handlers->length());
+  __ tst(receiver, Operand(kSmiTagMask));
+  __ b(eq, miss);
+  __ ldr(scratch, FieldMemOperand(receiver, HeapObject::kMapOffset));
+  for (int i = 0; i < maps->length(); i++) {
+    __ cmp(scratch, Operand(Handle<Map>(maps->at(i))));
+    __ Jump(Handle<Code>(handlers->at(i)), RelocInfo::CODE_TARGET, eq);
+  }
+}
+
+
 #undef __
 #define __ ACCESS_MASM(masm())
 
@@ -1789,6 +1808,33 @@ Object* CallStubCompiler::CompileCallGlobal(JSObject* object,
   return GetCode(NORMAL, name);
 }
 
+Object* CallStubCompiler::CompileCallPolymorphic(List<Map*>* maps,
+                                                 List<Code*>* handlers,
+                                                 String* name) {
+  // ----------- S t a t e -------------
+  //  -- r2    : name
+  //  -- lr    : return address
+  // -----------------------------------
+  Label miss;
+
+  GenerateNameCheck(name, &miss);
+
+  // Get the receiver from the stack.
+  const int argc = arguments().immediate();
+  __ ldr(r1, MemOperand(sp, argc * kPointerSize));
+
+  GenerateMapDispatch(masm(), r1, r3, maps, handlers, &miss);
+
+  // Handle call cache miss.
+  __ bind(&miss);
+  Object* obj = GenerateMissBranch();
+  if (obj->IsFailure()) return obj;
+
+  // Return the generated code.
+  return GetPolymorphicCode(name);
+}
+
+
 
 Object* StoreStubCompiler::CompileStoreField(JSObject* object,
                                              int index,
@@ -1943,6 +1989,29 @@ Object* StoreStubCompiler::CompileStoreGlobal(GlobalObject* object,
   return GetCode(NORMAL, name);
 }
 
+Object* StoreStubCompiler::CompileStorePolymorphic(List<Map*>* maps,
+                                                   List<Code*>* handlers,
+                                                   String* name) {
+  // ----------- S t a t e -------------
+  //  -- r0    : value
+  //  -- r1    : receiver
+  //  -- r2    : name
+  //  -- lr    : return address
+  // -----------------------------------
+  Label miss;
+
+  GenerateMapDispatch(masm(), r1, r3, maps, handlers, &miss);
+
+  // Handle store cache miss.
+  __ bind(&miss);
+  Handle<Code> ic(Builtins::builtin(Builtins::StoreIC_Miss));
+  __ Jump(ic, RelocInfo::CODE_TARGET);
+
+  // Return the generated code.
+  return GetPolymorphicCode(name);
+}
+
+
 
 Object* LoadStubCompiler::CompileLoadNonexistent(String* name,
                                                  JSObject* object,
@@ -2124,6 +2193,26 @@ Object* LoadStubCompiler::CompileLoadGlobal(JSObject* object,
   return GetCode(NORMAL, name);
 }
 
+Object* LoadStubCompiler::CompileLoadPolymorphic(List<Map*>* maps,
+                                                 List<Code*>* handlers,
+                                                 String* name) {
+  // ----------- S t a t e -------------
+  //  -- r0    : receiver
+  //  -- r2    : name
+  //  -- lr    : return address
+  // -----------------------------------
+  Label miss;
+
+  GenerateMapDispatch(masm(), r0, r3, maps, handlers, &miss);
+
+  __ bind(&miss);
+  GenerateLoadMiss(masm(), Code::LOAD_IC);
+
+  // Return the generated code.
+  return GetPolymorphicCode(name);
+}
+
+
 
 Object* KeyedLoadStubCompiler::CompileLoadField(String* name,
                                                 JSObject* receiver,
@@ -2368,6 +2457,21 @@ Object* ConstructStubCompiler::CompileConstructStub(
   __ Check(ne, "Function constructed by construct stub.");
 #endif
 
+  // Leave the allocation to the generic stub while the allocation site of the
+  // constructor collects feedback, or when it tenures the objects.
+  // r1: constructor function
+  // r2: initial map
+  // r7: undefined
+  Label allocate;
+  __ ldr(r3, FieldMemOperand(r1, JSFunction::kSharedFunctionInfoOffset));
+  __ ldr(r3, FieldMemOperand(r3, SharedFunctionInfo::kAllocationSiteOffset));
+  __ cmp(r3, r7);
+  __ b(eq, &allocate);
+  __ ldr(r3, FieldMemOperand(r3, AllocationSite::kStateOffset));
+  __ cmp(r3, Operand(Smi::FromInt(AllocationSite::kPending)));
+  __ b(lt, &generic_stub_call);
+  __ bind(&allocate);
+
   // Now allocate the JSObject in new space.
   // r0: argc
   // r1: constructor function
@@ -655,6 +655,16 @@ ExternalReference ExternalReference::new_space_allocation_limit_address() {
 }
 
 
+ExternalReference ExternalReference::store_buffer_top() {
+  return ExternalReference(StoreBuffer::top_address());
+}
+
+
+ExternalReference ExternalReference::store_buffer_limit() {
+  return ExternalReference(StoreBuffer::limit_address());
+}
+
+
 ExternalReference ExternalReference::handle_scope_extensions_address() {
   return ExternalReference(HandleScope::current_extensions_address());
 }
@@ -476,6 +476,10 @@ class ExternalReference BASE_EMBEDDED {
   static ExternalReference new_space_allocation_top_address();
   static ExternalReference new_space_allocation_limit_address();
 
+  // Used by the write barrier in generated code.
+  static ExternalReference store_buffer_top();
+  static ExternalReference store_buffer_limit();
+
   static ExternalReference double_fp_operation(Token::Value operation);
   static ExternalReference compare_doubles();
 
@@ -32,6 +32,7 @@
 #include "bootstrapper.h"
 #include "builtins.h"
 #include "ic-inl.h"
+#include "sweeper.h"
 
 namespace v8 {
 namespace internal {
@@ -310,6 +311,7 @@ static FixedArray* LeftTrimFixedArray(FixedArray* elms, int to_trim) {
   // In large object space the object's start must coincide with chunk
   // and thus the trick is just not applicable.
   ASSERT(!Heap::lo_space()->Contains(elms));
+  Sweeper::EnsureSwept(elms->address());
 
   STATIC_ASSERT(FixedArray::kMapOffset == 0);
   STATIC_ASSERT(FixedArray::kLengthOffset == kPointerSize);
@@ -338,8 +340,11 @@ static FixedArray* LeftTrimFixedArray(FixedArray* elms, int to_trim) {
   former_start[to_trim] = Heap::fixed_array_map();
   former_start[to_trim + 1] = Smi::FromInt(len - to_trim);
 
-  return FixedArray::cast(HeapObject::FromAddress(
+  FixedArray* trimmed = FixedArray::cast(HeapObject::FromAddress(
       elms->address() + to_trim * kPointerSize));
+  // Callers store the trimmed array without a write barrier.
+  IncrementalMarking::RecordWriteOf(trimmed);
+  return trimmed;
 }
 
 
@@ -492,6 +492,36 @@ const char* GenericUnaryOpStub::GetName() {
 }
 
 
+void ICCompareStub::Generate(MacroAssembler* masm) {
+  switch (type_info_) {
+    case CompareIC::DEFAULT: GenerateMiss(masm); break;
+    case CompareIC::HEAP_NUMBERS: GenerateHeapNumbers(masm); break;
+    case CompareIC::SYMBOLS: GenerateSymbols(masm); break;
+    case CompareIC::STRINGS: GenerateStrings(masm); break;
+    case CompareIC::OBJECTS: GenerateObjects(masm); break;
+    case CompareIC::GENERIC: {
+      CompareStub stub(GetCondition(), op_ == Token::EQ_STRICT);
+      stub.Generate(masm);
+      break;
+    }
+    default: UNREACHABLE();
+  }
+}
+
+
+const char* ICCompareStub::GetName() {
+  if (name_ != NULL) return name_;
+  const int kMaxNameLength = 100;
+  name_ = Bootstrapper::AllocateAutoDeletedArray(kMaxNameLength);
+  if (name_ == NULL) return "OOM";
+  OS::SNPrintF(Vector<char>(name_, kMaxNameLength),
+               "ICCompareStub_%s_%s",
+               Token::Name(op_),
+               CompareIC::GetName(type_info_));
+  return name_;
+}
+
+
 void ArgumentsAccessStub::Generate(MacroAssembler* masm) {
   switch (type_) {
     case READ_ELEMENT: GenerateReadElement(masm); break;
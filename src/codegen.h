@@ -29,6 +29,7 @@
 #define V8_CODEGEN_H_
 
 #include "code-stubs.h"
+#include "ic.h"
 #include "runtime.h"
 #include "type-info.h"
 
@@ -563,6 +564,61 @@ class CompareStub: public CodeStub {
 };
 
 
+// Compare stub installed at a compare IC call site. The operands are passed
+// in the same registers as for CompareStub. Misses call the runtime which
+// patches the call site with a stub specialized for the operand types seen
+// so far.
+class ICCompareStub: public CodeStub {
+ public:
+  ICCompareStub(Token::Value op, CompareIC::TypeInfo type_info)
+      : op_(op), type_info_(type_info), name_(NULL) {
+    ASSERT(Token::EQ <= op && op <= Token::GTE);
+  }
+
+  void Generate(MacroAssembler* masm);
+
+  // Compute the operation for a comparison on the condition code and
+  // strictness used by the code generators.
+  static Token::Value ComputeOperation(Condition cc, bool strict);
+
+ private:
+  class OpField: public BitField<int, 0, 3> { };
+  class TypeInfoField: public BitField<CompareIC::TypeInfo, 3, 3> { };
+
+  virtual int GetCodeKind() { return Code::COMPARE_IC; }
+  virtual InlineCacheState GetICState() {
+    return CompareIC::ToState(type_info_);
+  }
+
+  Major MajorKey() { return CompareIC; }
+  int MinorKey() {
+    return OpField::encode(op_ - Token::EQ) |
+           TypeInfoField::encode(type_info_);
+  }
+
+  Condition GetCondition();
+
+  void GenerateHeapNumbers(MacroAssembler* masm);
+  void GenerateSymbols(MacroAssembler* masm);
+  void GenerateStrings(MacroAssembler* masm);
+  void GenerateObjects(MacroAssembler* masm);
+  void GenerateMiss(MacroAssembler* masm);
+
+  Token::Value op_;
+  CompareIC::TypeInfo type_info_;
+
+  char* name_;
+  const char* GetName();
+#ifdef DEBUG
+  void Print() {
+    PrintF("ICCompareStub (op %s), (type_info %s)\n",
+           Token::Name(op_),
+           CompareIC::GetName(type_info_));
+  }
+#endif
+};
+
+
 class CEntryStub : public CodeStub {
  public:
   explicit CEntryStub(int result_size,
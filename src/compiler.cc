@@ -39,6 +39,7 @@
 #include "rewriter.h"
 #include "scopes.h"
 #include "scopeinfo.h"
+#include "v8threads.h"
 
 namespace v8 {
 namespace internal {
@@ -58,6 +59,25 @@ static bool AlwaysFullCompiler() {
 }
 
 
+// With --tiered-compilation lazily compiled functions start out on the full
+// code generator, which counts calls and loop iterations, and are recompiled
+// with the classic code generator once they get hot.
+static bool UseTieredCompilation(CompilationInfo* info) {
+// Mips has not implemented full-codegen yet.
+#if defined(V8_TARGET_ARCH_MIPS)
+  return false;
+#else
+  if (!FLAG_tiered_compilation || info->is_optimizing() || info->is_eval()) {
+    return false;
+  }
+  Handle<SharedFunctionInfo> shared = info->shared_info();
+  return !shared.is_null() &&
+      shared->allows_lazy_compilation() &&
+      !shared->is_toplevel();
+#endif
+}
+
+
 static Handle<Code> MakeCode(Handle<Context> context, CompilationInfo* info) {
   FunctionLiteral* function = info->function();
   ASSERT(function != NULL);
@@ -111,6 +131,11 @@ static Handle<Code> MakeCode(Handle<Context> context, CompilationInfo* info) {
     return FullCodeGenerator::MakeCode(info);
   }
 
+  if (UseTieredCompilation(info)) {
+    info->set_has_tier_up_check(true);
+    return FullCodeGenerator::MakeCode(info);
+  }
+
   AssignedVariablesAnalyzer ava(function);
   if (!ava.Analyze()) return Handle<Code>::null();
   return CodeGenerator::MakeCode(info);
@@ -428,6 +453,11 @@ bool Compiler::CompileLazy(CompilationInfo* info) {
       lit->has_only_simple_this_property_assignments(),
       *lit->this_property_assignments());
 
+  // Start counting towards recompilation with the optimizing code
+  // generator again.
+  shared->set_is_optimized(false);
+  shared->set_tier_up_counter(FLAG_tier_up_threshold);
+
   // Check the function has compiled code.
   ASSERT(shared->is_compiled());
   shared->set_code_age(0);
@@ -435,6 +465,170 @@ bool Compiler::CompileLazy(CompilationInfo* info) {
 }
 
 
+// Looks for activations of a closure on the stacks of all threads. The
+// frames of a closure find their code through the closure, so its code
+// must not be replaced while it is running.
+class ActivationFinder : public ThreadVisitor {
+ public:
+  explicit ActivationFinder(JSFunction* function)
+      : function_(function), count_(0) { }
+
+  void VisitThread(ThreadLocalTop* top) {
+    for (JavaScriptFrameIterator it(top); !it.done(); it.Advance()) {
+      if (it.frame()->function() == function_) count_++;
+    }
+  }
+
+  int count() { return count_; }
+
+ private:
+  JSFunction* function_;
+  int count_;
+};
+
+
+// Count the activations of a closure on all threads.  Frames find their
+// code through the closure, so its code can only be replaced when the
+// activations are known.
+static int CountActivations(Handle<JSFunction> function) {
+  ActivationFinder finder(*function);
+  Top::IterateThread(&finder);
+  ThreadManager::IterateArchivedThreads(&finder);
+  return finder.count();
+}
+
+
+static bool CanRecompile(Handle<SharedFunctionInfo> shared) {
+  // Functions that got their code through %SetCode have no source to
+  // recompile. Stop counting for them.
+  if (!shared->script()->IsScript()) {
+    shared->set_tier_up_counter(Smi::kMaxValue);
+    return false;
+  }
+
+#ifdef ENABLE_DEBUGGER_SUPPORT
+  // Recompiling would lose break points and change the code seen by the
+  // debugger.
+  if (Debugger::IsDebuggerActive() || Debug::HasDebugInfo(shared)) {
+    return false;
+  }
+#endif
+  if (LiveEditFunctionTracker::IsActive()) return false;
+
+  // Don't turn a stack overflow during recompilation into an exception, the
+  // function can keep running its current code.
+  StackLimitCheck check;
+  return !check.HasOverflowed();
+}
+
+
+// Compile the function of a full-codegen closure again with the optimizing
+// code generator.  Returns a null handle if that fails.
+Handle<Code> Compiler::MakeOptimizedCode(CompilationInfo* info) {
+  Handle<SharedFunctionInfo> shared = info->shared_info();
+  info->set_is_optimizing(true);
+
+  Handle<String> name(String::cast(shared->name()));
+  FunctionLiteral* lit = MakeLazyAST(info->script(),
+                                     name,
+                                     shared->start_position(),
+                                     shared->end_position(),
+                                     shared->is_expression());
+  if (lit == NULL) {
+    Top::clear_pending_exception();
+    return Handle<Code>::null();
+  }
+  info->set_function(lit);
+
+  Handle<Code> code = MakeCode(Handle<Context>::null(), info);
+  if (code.is_null()) return code;
+  RecordFunctionCompilation(Logger::LAZY_COMPILE_TAG,
+                            name,
+                            Handle<String>(shared->inferred_name()),
+                            shared->start_position(),
+                            info->script(),
+                            code);
+  return code;
+}
+
+
+static void TraceRecompilation(Handle<SharedFunctionInfo> shared,
+                               const char* reason) {
+  if (!FLAG_trace_tier_up) return;
+  Handle<String> name(String::cast(shared->name()));
+  if (name->length() == 0) name = Handle<String>(shared->inferred_name());
+  SmartPointer<char> trace_string = name->ToCString();
+  PrintF("[tier-up: %s %s]\n", *trace_string, reason);
+}
+
+
+bool Compiler::RecompileOptimized(Handle<JSFunction> function) {
+  Handle<SharedFunctionInfo> shared(function->shared());
+  if (!shared->is_compiled()) return false;
+  if (!CanRecompile(shared)) return false;
+  if (CountActivations(function) > 0) return false;
+
+  // Another closure for the same function got hot first.
+  if (shared->is_optimized()) {
+    function->set_code(shared->code());
+    return true;
+  }
+
+  CompilationZoneScope zone_scope(DELETE_ON_EXIT);
+  VMState state(COMPILER);
+  PostponeInterruptsScope postpone;
+
+  // Compile as if in a loop like Runtime_LazyCompile does.
+  CompilationInfo info(function, 1, Handle<Object>::null());
+  Handle<Code> code = MakeOptimizedCode(&info);
+  if (code.is_null()) return false;
+  TraceRecompilation(shared, "on entry");
+
+  shared->set_code(*code);
+  shared->set_is_optimized(true);
+  shared->set_tier_up_counter(FLAG_tier_up_threshold);
+  function->set_code(*code);
+  return true;
+}
+
+
+int Compiler::CompileForOnStackReplacement(Handle<JSFunction> function,
+                                           int loop_position) {
+  Handle<SharedFunctionInfo> shared(function->shared());
+  ASSERT(shared->is_compiled());
+  if (!FLAG_use_osr) return -1;
+  if (!CanRecompile(shared)) return -1;
+
+  // The activation running the loop is the topmost JavaScript frame.  Any
+  // other activation would be attributed to the new code.
+#ifdef DEBUG
+  JavaScriptFrameIterator it;
+  ASSERT(it.frame()->function() == *function);
+#endif
+  if (CountActivations(function) > 1) return -1;
+
+  CompilationZoneScope zone_scope(DELETE_ON_EXIT);
+  VMState state(COMPILER);
+  PostponeInterruptsScope postpone;
+
+  CompilationInfo info(function, 1, Handle<Object>::null());
+  info.set_osr_loop_position(loop_position);
+  Handle<Code> code = MakeOptimizedCode(&info);
+  if (code.is_null() || info.osr_entry_offset() < 0) return -1;
+  TraceRecompilation(shared, "in loop");
+
+  // The code is complete and can be used by other closures too, unless
+  // they already share optimized code.
+  if (!shared->is_optimized()) {
+    shared->set_code(*code);
+    shared->set_is_optimized(true);
+  }
+  shared->set_tier_up_counter(FLAG_tier_up_threshold);
+  function->set_code(*code);
+  return info.osr_entry_offset();
+}
+
+
 Handle<SharedFunctionInfo> Compiler::BuildFunctionInfo(FunctionLiteral* literal,
                                                        Handle<Script> script,
                                                        AstVisitor* caller) {
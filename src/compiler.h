@@ -129,6 +129,24 @@ class CompilationInfo BASE_EMBEDDED {
   bool has_globals() { return has_globals_; }
   void set_has_globals(bool flag) { has_globals_ = flag; }
 
+  // Recompilation of hot full-codegen code with the optimizing code
+  // generator (see --tiered-compilation).
+  bool is_optimizing() { return is_optimizing_; }
+  void set_is_optimizing(bool flag) { is_optimizing_ = flag; }
+
+  // Whether the generated code should count calls and loop iterations
+  // and ask to be recompiled once it gets hot.
+  bool has_tier_up_check() { return has_tier_up_check_; }
+  void set_has_tier_up_check(bool flag) { has_tier_up_check_ = flag; }
+
+  // On-stack replacement: the source position of the loop that full code
+  // is running, and the offset of the entry for that loop in the generated
+  // code (-1 if the code generator could not provide one).
+  int osr_loop_position() { return osr_loop_position_; }
+  void set_osr_loop_position(int position) { osr_loop_position_ = position; }
+  int osr_entry_offset() { return osr_entry_offset_; }
+  void set_osr_entry_offset(int offset) { osr_entry_offset_ = offset; }
+
   // Derived accessors.
   Scope* scope() { return function()->scope(); }
 
@@ -136,6 +154,10 @@ class CompilationInfo BASE_EMBEDDED {
   void Initialize() {
     has_this_properties_ = false;
     has_globals_ = false;
+    is_optimizing_ = false;
+    has_tier_up_check_ = false;
+    osr_loop_position_ = RelocInfo::kNoPosition;
+    osr_entry_offset_ = -1;
   }
 
   Handle<JSFunction> closure_;
@@ -151,6 +173,10 @@ class CompilationInfo BASE_EMBEDDED {
 
   bool has_this_properties_;
   bool has_globals_;
+  bool is_optimizing_;
+  bool has_tier_up_check_;
+  int osr_loop_position_;
+  int osr_entry_offset_;
 
   DISALLOW_COPY_AND_ASSIGN(CompilationInfo);
 };
@@ -196,6 +222,19 @@ class Compiler : public AllStatic {
   // overflow.
   static bool CompileLazy(CompilationInfo* info);
 
+  // Recompile hot full-codegen code for a function with the optimizing
+  // code generator. Returns false if the function cannot be recompiled
+  // at this point. Never leaves a pending exception.
+  static bool RecompileOptimized(Handle<JSFunction> function);
+
+  // Recompile a function whose full code is running the loop at the given
+  // source position in its only activation, so the activation can continue
+  // in the new code.  Returns the offset of the loop entry in the new code,
+  // which is installed on the function, or -1 if the loop cannot be
+  // replaced at this point.  Never leaves a pending exception.
+  static int CompileForOnStackReplacement(Handle<JSFunction> function,
+                                          int loop_position);
+
   // Compile a shared function info object (the function is possibly
   // lazily compiled). Called recursively from a backend code
   // generator 'caller' to build the shared function info.
@@ -210,6 +249,8 @@ class Compiler : public AllStatic {
                               Handle<Script> script);
 
  private:
+  static Handle<Code> MakeOptimizedCode(CompilationInfo* info);
+
   static void RecordFunctionCompilation(Logger::LogEventsAndTags tag,
                                         Handle<String> name,
                                         Handle<String> inferred_name,
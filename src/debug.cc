@@ -140,7 +140,8 @@ void BreakLocationIterator::Next() {
       Address target = original_rinfo()->target_address();
       Code* code = Code::GetCodeFromTargetAddress(target);
       if ((code->is_inline_cache_stub() &&
-           code->kind() != Code::BINARY_OP_IC) ||
+           code->kind() != Code::BINARY_OP_IC &&
+           code->kind() != Code::COMPARE_IC) ||
           RelocInfo::IsConstructCall(rmode())) {
         break_point_++;
         return;
@@ -384,6 +385,7 @@ void BreakLocationIterator::PrepareStepIn() {
     } else {
       rinfo()->set_target_address(stub->entry());
     }
+    IncrementalMarking::RecordWriteOf(*stub);
   } else {
 #ifdef DEBUG
     // All the following stuff is needed only for assertion checks so the code
@@ -439,6 +441,8 @@ void BreakLocationIterator::SetDebugBreakAtIC() {
   // Patch the original code with the current address as the current address
   // might have changed by the inline caching since the code was copied.
   original_rinfo()->set_target_address(rinfo()->target_address());
+  IncrementalMarking::RecordWriteOf(
+      Code::GetCodeFromTargetAddress(rinfo()->target_address()));
 
   RelocInfo::Mode mode = rmode();
   if (RelocInfo::IsCodeTarget(mode)) {
@@ -471,6 +475,8 @@ void BreakLocationIterator::SetDebugBreakAtIC() {
 void BreakLocationIterator::ClearDebugBreakAtIC() {
   // Patch the code to the original invoke.
   rinfo()->set_target_address(original_rinfo()->target_address());
+  IncrementalMarking::RecordWriteOf(
+      Code::GetCodeFromTargetAddress(original_rinfo()->target_address()));
 
   RelocInfo::Mode mode = rmode();
   if (RelocInfo::IsCodeTarget(mode)) {
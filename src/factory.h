@@ -54,6 +54,9 @@ class Factory : public AllStatic {
 
   static Handle<DescriptorArray> NewDescriptorArray(int number_of_descriptors);
 
+  // Allocates a tenured allocation site that starts collecting feedback.
+  static Handle<AllocationSite> NewAllocationSite();
+
   static Handle<String> LookupSymbol(Vector<const char> str);
   static Handle<String> LookupAsciiSymbol(const char* str) {
     return LookupSymbol(CStrVector(str));
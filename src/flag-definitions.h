@@ -140,6 +140,15 @@ DEFINE_bool(stack_trace_on_abort, true,
 // codegen-ia32.cc / codegen-arm.cc
 DEFINE_bool(trace, false, "trace function calls")
 DEFINE_bool(defer_negation, true, "defer negation operation")
+DEFINE_bool(unbox_doubles, true,
+            "compute arithmetic expressions in loops with unboxed doubles "
+            "(X64 only)")
+DEFINE_bool(inline_calls, true,
+            "inline calls to small global functions and monomorphic "
+            "methods (X64 only)")
+DEFINE_int(max_inlined_nodes, 30,
+           "maximum number of AST nodes in the body of an inlined function")
+DEFINE_bool(trace_inlining, false, "trace inlining of calls")
 
 // codegen.cc
 DEFINE_bool(lazy, true, "use lazy compilation")
@@ -157,6 +166,15 @@ DEFINE_bool(trace_bailout, false,
 DEFINE_bool(safe_int32_compiler, true,
             "enable optimized side-effect-free int32 expressions.")
 DEFINE_bool(use_flow_graph, false, "perform flow-graph based optimizations")
+DEFINE_bool(tiered_compilation, false,
+            "compile lazily with the full compiler and recompile hot "
+            "functions with the optimizing code generator")
+DEFINE_int(tier_up_threshold, 1000,
+           "number of calls and loop iterations before a function is "
+           "recompiled with the optimizing code generator")
+DEFINE_bool(use_osr, true,
+            "continue hot loops of full code in the recompiled code")
+DEFINE_bool(trace_tier_up, false, "trace recompilation of hot functions")
 
 // compilation-cache.cc
 DEFINE_bool(compilation_cache, true, "enable compilation cache")
@@ -190,16 +208,27 @@ DEFINE_bool(print_cumulative_gc_stat, false,
             "print cumulative GC statistics in name=value format on exit")
 DEFINE_bool(trace_gc_verbose, false,
             "print more details following each garbage collection")
+DEFINE_bool(memory_reducer, true,
+            "compact the heap and release unused memory in idle "
+            "notifications when much more memory is committed than needed")
 DEFINE_bool(collect_maps, true,
             "garbage collect maps from which no objects can be reached")
 DEFINE_bool(flush_code, true,
             "flush code that we expect not to use again before full gc")
+DEFINE_bool(allocation_site_pretenuring, true,
+            "allocate objects from literals and constructors whose objects "
+            "mostly survive scavenges directly in old space")
+DEFINE_bool(trace_pretenuring, false,
+            "trace the pretenuring decisions of allocation sites")
 
 // v8.cc
 DEFINE_bool(use_idle_notification, true,
             "Use idle notification to reduce memory footprint.")
 // ic.cc
 DEFINE_bool(use_ic, true, "use inline caching")
+DEFINE_int(max_polymorphism, 4,
+           "maximum number of receiver maps checked by a polymorphic "
+           "inline cache before it goes megamorphic")
 
 // macro-assembler-ia32.cc
 DEFINE_bool(native_code_counters, false,
@@ -213,6 +242,36 @@ DEFINE_bool(cleanup_ics_at_gc, true,
             "Flush inline caches prior to mark compact collection.")
 DEFINE_bool(cleanup_caches_in_maps_at_gc, true,
             "Flush code caches in maps during mark compact cycle.")
+DEFINE_bool(parallel_marking, false,
+            "Use several threads to mark live objects during full GC "
+            "(disables code flushing).")
+DEFINE_int(marking_threads, 4,
+           "Number of threads, including the main thread, used for "
+           "parallel marking.")
+DEFINE_bool(parallel_scavenge, false,
+            "Use several threads to copy live objects during scavenges.")
+DEFINE_int(scavenge_threads, 4,
+           "Number of threads, including the main thread, used for "
+           "parallel scavenges.")
+
+// incremental-marking.cc
+DEFINE_bool(incremental_marking, false,
+            "Mark the old generation in steps taken at scavenges to "
+            "shorten full GC pauses.")
+DEFINE_int(incremental_marking_speed, 8,
+           "Number of bytes visited by an incremental marking step for "
+           "each byte allocated since the previous step.")
+
+// store-buffer.cc
+DEFINE_bool(store_buffer, false,
+            "Record the slots of old objects that new-space objects are "
+            "stored into, so that scavenges do not rescan dirty regions.")
+
+// sweeper.cc
+DEFINE_string(sweeping, "eager",
+              "When to sweep the old spaces after a non-compacting full GC: "
+              "eager (in the pause), lazy (when allocation needs memory) "
+              "or concurrent (on a background thread).")
 DEFINE_int(random_seed, 0,
            "Default seed for initializing random generator "
            "(0, the default, means to use system random).")
@@ -228,6 +287,15 @@ DEFINE_int(max_map_space_pages, MapSpace::kMaxMapPageIndex - 1,
            "forwarding pointers.  That's actually a constant, but it's useful "
            "to control it with a flag for better testing.")
 
+DEFINE_int(heap_chunk_size, 0,
+           "size in KB of the chunks by which the old spaces grow "
+           "(0 for the default of 128 KB, or 256 KB on x64)")
+
+// platform-linux.cc
+DEFINE_bool(transparent_huge_pages, true,
+            "back heap chunks and code range blocks of at least 2MB "
+            "with transparent huge pages")
+
 // mksnapshot.cc
 DEFINE_bool(h, false, "print this message")
 DEFINE_bool(new_snapshot, true, "use new snapshot implementation")
@@ -756,6 +756,7 @@ void FullCodeGenerator::VisitDoWhileStatement(DoWhileStatement* stmt) {
   // Check stack before looping.
   __ StackLimitCheck(&stack_limit_hit);
   __ bind(&stack_check_success);
+  EmitBackEdgeCheck(stmt);
 
   // Record the position of the do while condition and make sure it is
   // possible to break on the condition.
@@ -805,6 +806,7 @@ void FullCodeGenerator::VisitWhileStatement(WhileStatement* stmt) {
   // Check stack before looping.
   __ StackLimitCheck(&stack_limit_hit);
   __ bind(&stack_check_success);
+  EmitBackEdgeCheck(stmt);
 
   VisitForControl(stmt->cond(),
                   &body,
@@ -852,6 +854,7 @@ void FullCodeGenerator::VisitForStatement(ForStatement* stmt) {
   // Check stack before looping.
   __ StackLimitCheck(&stack_limit_hit);
   __ bind(&stack_check_success);
+  EmitBackEdgeCheck(stmt);
 
   if (stmt->cond() != NULL) {
     VisitForControl(stmt->cond(),
@@ -1065,6 +1068,23 @@ void FullCodeGenerator::VisitIncrementOperation(IncrementOperation* expr) {
 }
 
 
+bool FullCodeGenerator::CanReplaceOnStack() {
+  // Try statements keep handlers and for-in loops keep their state on
+  // the stack.
+  for (NestedStatement* current = nesting_stack_;
+       current != NULL;
+       current = current->outer()) {
+    if (current->AsTryCatch() != NULL ||
+        current->AsTryFinally() != NULL ||
+        current->AsFinally() != NULL ||
+        current->AsForIn() != NULL) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
 int FullCodeGenerator::TryFinally::Exit(int stack_depth) {
   // The macros used here must preserve the result register.
   __ Drop(stack_depth);
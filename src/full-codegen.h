@@ -350,6 +350,18 @@ class FullCodeGenerator: public AstVisitor {
   // Platform-specific return sequence
   void EmitReturnSequence();
 
+  // Platform-specific code counting calls (on function entry, before the
+  // frame is built) and loop iterations (at loop back edges) towards
+  // recompilation with the optimizing code generator.  Only emitted when
+  // the compilation info asks for a tier-up check.  A hot loop can
+  // continue in the recompiled code if CanReplaceOnStack() holds there.
+  void EmitTierUpCheck();
+  void EmitBackEdgeCheck(IterationStatement* stmt);
+
+  // Whether nothing but the locals is on the stack of the frame, which
+  // then has the same layout in code from the optimizing code generator.
+  bool CanReplaceOnStack();
+
   // Platform-specific code sequences for calls
   void EmitCallWithStub(Call* expr);
   void EmitCallWithIC(Call* expr, Handle<Object> name, RelocInfo::Mode mode);
@@ -260,8 +260,19 @@ const Address kFromSpaceZapValue = reinterpret_cast<Address>(0xbeefdad);
 
 
 // Number of bits to represent the page size for paged spaces. The value of 13
-// gives 8K bytes per page.
-const int kPageSizeBits = 13;
+// gives 8K bytes per page.  It can be set at build time through
+// V8_PAGE_SIZE_BITS, from 4K up to 1M pages on 64-bit hosts and up to 64K
+// pages on 32-bit hosts, where map words have fewer bits to spare.
+#ifndef V8_PAGE_SIZE_BITS
+#define V8_PAGE_SIZE_BITS 13
+#endif
+#if V8_PAGE_SIZE_BITS < 12 || V8_PAGE_SIZE_BITS > 20
+#error V8_PAGE_SIZE_BITS must be between 12 and 20
+#endif
+#if V8_HOST_ARCH_32_BIT && V8_PAGE_SIZE_BITS > 16
+#error V8_PAGE_SIZE_BITS must be at most 16 on 32-bit hosts
+#endif
+const int kPageSizeBits = V8_PAGE_SIZE_BITS;
 
 // On Intel architecture, cache line size is 64 bytes.
 // On ARM it may be less (32 bytes), but as far this constant is
@@ -451,6 +462,8 @@ enum InlineCacheState {
   MONOMORPHIC,
   // Like MONOMORPHIC but check failed due to prototype.
   MONOMORPHIC_PROTOTYPE_FAILURE,
+  // A few receiver types have been seen and are checked inline.
+  POLYMORPHIC,
   // Multiple receiver types have been seen.
   MEGAMORPHIC,
   // Special states for debug break or step in prepare stubs.
@@ -29,6 +29,7 @@
 #define V8_HEAP_INL_H_
 
 #include "log.h"
+#include "store-buffer.h"
 #include "v8-counters.h"
 
 namespace v8 {
@@ -185,11 +186,34 @@ bool Heap::ShouldBePromoted(Address old_address, int object_size) {
 }
 
 
+AllocationMemento* Heap::FindAllocationMemento(HeapObject* object,
+                                               int object_size) {
+  // Memory above the limit is left over from earlier cycles and may look
+  // like a memento of a site that no longer exists.
+  Address memento_address = object->address() + object_size;
+  if (memento_address + AllocationMemento::kSize > allocation_memento_limit_) {
+    return NULL;
+  }
+  HeapObject* candidate = HeapObject::FromAddress(memento_address);
+  if (candidate->map_word().ToMap() != allocation_memento_map()) return NULL;
+  return AllocationMemento::cast(candidate);
+}
+
+
 void Heap::RecordWrite(Address address, int offset) {
   if (new_space_.Contains(address)) return;
   ASSERT(!new_space_.FromSpaceContains(address));
   SLOW_ASSERT(Contains(address + offset));
-  Page::FromAddress(address)->MarkRegionDirty(address + offset);
+  Address slot = address + offset;
+  // The mark-compact collector relies on region marks only.
+  if (FLAG_store_buffer &&
+      gc_state_ != MARK_COMPACT &&
+      InNewSpace(Memory::Object_at(slot)) &&
+      Page::FromAddress(address) == Page::FromAddress(slot)) {
+    StoreBuffer::Mark(slot);
+  } else {
+    Page::FromAddress(address)->MarkRegionDirty(slot);
+  }
 }
 
 
@@ -35,12 +35,16 @@
 #include "debug.h"
 #include "heap-profiler.h"
 #include "global-handles.h"
+#include "incremental-marking.h"
 #include "mark-compact.h"
 #include "natives.h"
 #include "objects-visiting.h"
+#include "parallel-scavenger.h"
 #include "scanner.h"
 #include "scopeinfo.h"
 #include "snapshot.h"
+#include "store-buffer.h"
+#include "sweeper.h"
 #include "v8threads.h"
 #if V8_TARGET_ARCH_ARM && !V8_INTERPRETED_REGEXP
 #include "regexp-macro-assembler.h"
@@ -69,6 +73,7 @@ static const int kMinimumAllocationLimit = 8*MB;
 
 int Heap::old_gen_promotion_limit_ = kMinimumPromotionLimit;
 int Heap::old_gen_allocation_limit_ = kMinimumAllocationLimit;
+int Heap::old_gen_incremental_marking_limit_ = kMinimumPromotionLimit / 2;
 
 int Heap::old_gen_exhausted_ = false;
 
@@ -127,6 +132,15 @@ int Heap::always_allocate_scope_depth_ = 0;
 int Heap::linear_allocation_scope_depth_ = 0;
 int Heap::contexts_disposed_ = 0;
 
+bool Heap::memory_reduction_pending_ = false;
+int Heap::target_footprint_ = 0;
+int Heap::committed_memory_after_reduction_ = 0;
+intptr_t Heap::reclaimed_memory_ = 0;
+
+List<AllocationSite*> Heap::allocation_sites_with_mementos_;
+Address Heap::allocation_memento_limit_ = NULL;
+int Heap::pretenured_bytes_since_last_scavenge_ = 0;
+
 int Heap::young_survivors_after_last_gc_ = 0;
 int Heap::high_survival_rate_period_length_ = 0;
 double Heap::survival_rate_ = 0;
@@ -206,6 +220,12 @@ GarbageCollector Heap::SelectGarbageCollector(AllocationSpace space) {
     return MARK_COMPACTOR;
   }
 
+  // Has incremental marking finished marking the old generation?
+  if (IncrementalMarking::IsComplete()) {
+    Counters::gc_compactor_caused_by_incremental_marking.Increment();
+    return MARK_COMPACTOR;
+  }
+
   // Have allocation in OLD and LO failed?
   if (old_gen_exhausted_) {
     Counters::gc_compactor_caused_by_oldspace_exhaustion.Increment();
@@ -366,6 +386,8 @@ void Heap::GarbageCollectionEpilogue() {
 
   Counters::alive_after_last_gc.Set(SizeOfObjects());
 
+  CheckMemoryReduction();
+
   Counters::symbol_table_capacity.Set(symbol_table()->Capacity());
   Counters::number_of_symbols.Set(symbol_table()->NumberOfElements());
 #if defined(DEBUG) || defined(ENABLE_LOGGING_AND_PROFILING)
@@ -643,6 +665,12 @@ void Heap::PerformGarbageCollection(AllocationSpace space,
     bool high_survival_rate_during_scavenges = IsHighSurvivalRate() &&
         IsStableOrIncreasingSurvivalTrend();
 
+    // Without scavenges in between, the objects that allocation sites placed
+    // in old space stand in for the survivors.
+    if (pretenured_bytes_since_last_scavenge_ > 0) {
+      IncrementYoungSurvivorsCounter(pretenured_bytes_since_last_scavenge_);
+      pretenured_bytes_since_last_scavenge_ = 0;
+    }
     UpdateSurvivalRateTrend(start_new_space_size);
 
     int old_gen_size = PromotedSpaceSize();
@@ -663,6 +691,9 @@ void Heap::PerformGarbageCollection(AllocationSpace space,
       old_gen_allocation_limit_ *= 2;
     }
 
+    old_gen_incremental_marking_limit_ =
+        old_gen_size + (old_gen_promotion_limit_ - old_gen_size) / 2;
+
     old_gen_exhausted_ = false;
   } else {
     tracer_ = tracer;
@@ -670,6 +701,15 @@ void Heap::PerformGarbageCollection(AllocationSpace space,
     tracer_ = NULL;
 
     UpdateSurvivalRateTrend(start_new_space_size);
+
+    if (IncrementalMarking::IsMarking()) {
+      GCTracer::Scope scope(tracer, GCTracer::Scope::INCREMENTAL_MARKING);
+      IncrementalMarking::Step(start_new_space_size);
+    } else if (FLAG_incremental_marking &&
+               OldGenerationIncrementalMarkingLimitReached()) {
+      GCTracer::Scope scope(tracer, GCTracer::Scope::INCREMENTAL_MARKING);
+      IncrementalMarking::Start();
+    }
   }
 
   Counters::objs_since_last_young.Set(0);
@@ -711,6 +751,18 @@ void Heap::MarkCompact(GCTracer* tracer) {
   gc_state_ = MARK_COMPACT;
   LOG(ResourceEvent("markcompact", "begin"));
 
+  // Pages left unswept by the previous collection cannot be iterated.
+  Sweeper::EnsureCompleted();
+
+  // The collector moves and frees old objects and keeps track of pointers
+  // to the new space through region marks only.
+  StoreBuffer::FlushToRegionMarks();
+
+  if (IncrementalMarking::IsMarking()) {
+    GCTracer::Scope scope(tracer, GCTracer::Scope::INCREMENTAL_MARKING);
+    IncrementalMarking::Finalize();
+  }
+
   MarkCompactCollector::Prepare(tracer);
 
   bool is_compacting = MarkCompactCollector::IsCompacting();
@@ -726,6 +778,8 @@ void Heap::MarkCompact(GCTracer* tracer) {
 
   MarkCompactCollector::CollectGarbage();
 
+  IncrementalMarking::Stop();
+
   MarkCompactEpilogue(is_compacting);
 
   LOG(ResourceEvent("markcompact", "end"));
@@ -755,6 +809,8 @@ void Heap::MarkCompactPrologue(bool is_compacting) {
   CompletelyClearInstanceofCache();
 
   if (is_compacting) FlushNumberStringCache();
+
+  ResetPretenuringFeedback();
 }
 
 
@@ -905,74 +961,102 @@ void Heap::Scavenge() {
 
   CheckNewSpaceExpansionCriteria();
 
+  // Mementos can only be found below the current allocation top.
+  if (!allocation_sites_with_mementos_.is_empty()) {
+    allocation_memento_limit_ = new_space_.top();
+  }
+
   // Flip the semispaces.  After flipping, to space is empty, from space has
   // live objects.
   new_space_.Flip();
   new_space_.ResetAllocationInfo();
 
-  // We need to sweep newly copied objects which can be either in the
-  // to space or promoted to the old generation.  For to-space
-  // objects, we treat the bottom of the to space as a queue.  Newly
-  // copied and unswept objects lie between a 'front' mark and the
-  // allocation pointer.
-  //
-  // Promoted objects can go into various old-generation spaces, and
-  // can be allocated internally in the spaces (from the free list).
-  // We treat the top of the to space as a queue of addresses of
-  // promoted objects.  The addresses of newly promoted and unswept
-  // objects lie between a 'front' mark and a 'rear' mark that is
-  // updated as a side effect of promoting an object.
-  //
-  // There is guaranteed to be enough room at the top of the to space
-  // for the addresses of promoted objects: every object promoted
-  // frees up its size in bytes from the top of the new space, and
-  // objects are at least one pointer in size.
-  Address new_space_front = new_space_.ToSpaceLow();
-  promotion_queue.Initialize(new_space_.ToSpaceHigh());
-
-  ScavengeVisitor scavenge_visitor;
-  // Copy roots.
-  IterateRoots(&scavenge_visitor, VISIT_ALL_IN_SCAVENGE);
-
-  // Copy objects reachable from the old generation.  By definition,
-  // there are no intergenerational pointers in code or data spaces.
-  IterateDirtyRegions(old_pointer_space_,
-                      &IteratePointersInDirtyRegion,
-                      &ScavengePointer,
-                      WATERMARK_CAN_BE_INVALID);
-
-  IterateDirtyRegions(map_space_,
-                      &IteratePointersInDirtyMapsRegion,
-                      &ScavengePointer,
-                      WATERMARK_CAN_BE_INVALID);
-
-  lo_space_->IterateDirtyRegions(&ScavengePointer);
-
-  // Copy objects reachable from cells by scavenging cell values directly.
-  HeapObjectIterator cell_iterator(cell_space_);
-  for (HeapObject* cell = cell_iterator.next();
-       cell != NULL; cell = cell_iterator.next()) {
-    if (cell->IsJSGlobalPropertyCell()) {
-      Address value_address =
-          reinterpret_cast<Address>(cell) +
-          (JSGlobalPropertyCell::kValueOffset - kHeapObjectTag);
-      scavenge_visitor.VisitPointer(reinterpret_cast<Object**>(value_address));
-    }
+  // Incremental marking needs every write to be visible as a dirty region,
+  // and the parallel scavenger only scans dirty regions.
+  if (IncrementalMarking::IsMarking() || ParallelScavenger::IsEnabled()) {
+    StoreBuffer::FlushToRegionMarks();
   }
 
-  new_space_front = DoScavenge(&scavenge_visitor, new_space_front);
+  if (ParallelScavenger::IsEnabled()) {
+    ParallelScavenger::Scavenge();
+  } else {
+    // We need to sweep newly copied objects which can be either in the
+    // to space or promoted to the old generation.  For to-space
+    // objects, we treat the bottom of the to space as a queue.  Newly
+    // copied and unswept objects lie between a 'front' mark and the
+    // allocation pointer.
+    //
+    // Promoted objects can go into various old-generation spaces, and
+    // can be allocated internally in the spaces (from the free list).
+    // We treat the top of the to space as a queue of addresses of
+    // promoted objects.  The addresses of newly promoted and unswept
+    // objects lie between a 'front' mark and a 'rear' mark that is
+    // updated as a side effect of promoting an object.
+    //
+    // There is guaranteed to be enough room at the top of the to space
+    // for the addresses of promoted objects: every object promoted
+    // frees up its size in bytes from the top of the new space, and
+    // objects are at least one pointer in size.
+    Address new_space_front = new_space_.ToSpaceLow();
+    promotion_queue.Initialize(new_space_.ToSpaceHigh());
+
+    ScavengeVisitor scavenge_visitor;
+    // Copy roots.
+    IterateRoots(&scavenge_visitor, VISIT_ALL_IN_SCAVENGE);
+
+    // Copy objects reachable from the old generation.  By definition,
+    // there are no intergenerational pointers in code or data spaces.
+    IterateDirtyRegions(old_pointer_space_,
+                        &IteratePointersInDirtyRegion,
+                        &ScavengePointer,
+                        WATERMARK_CAN_BE_INVALID);
+
+    IterateDirtyRegions(map_space_,
+                        &IteratePointersInDirtyMapsRegion,
+                        &ScavengePointer,
+                        WATERMARK_CAN_BE_INVALID);
+
+    lo_space_->IterateDirtyRegions(&ScavengePointer);
+
+    // Slots in the store buffer might have been visited as part of a dirty
+    // region, so they are visited last and only if they still point into
+    // from space.
+    StoreBuffer::IteratePointersToNewSpace(&ScavengePointer);
+
+    // Copy objects reachable from cells by scavenging cell values directly.
+    HeapObjectIterator cell_iterator(cell_space_);
+    for (HeapObject* cell = cell_iterator.next();
+         cell != NULL; cell = cell_iterator.next()) {
+      if (cell->IsJSGlobalPropertyCell()) {
+        Address value_address =
+            reinterpret_cast<Address>(cell) +
+            (JSGlobalPropertyCell::kValueOffset - kHeapObjectTag);
+        scavenge_visitor.VisitPointer(
+            reinterpret_cast<Object**>(value_address));
+      }
+    }
+
+    new_space_front = DoScavenge(&scavenge_visitor, new_space_front);
+
+    ASSERT(new_space_front == new_space_.top());
+  }
 
   UpdateNewSpaceReferencesInExternalStringTable(
       &UpdateNewSpaceReferenceInExternalStringTableEntry);
 
-  ASSERT(new_space_front == new_space_.top());
-
   // Set age mark.
   new_space_.set_age_mark(new_space_.top());
 
+  if (allocation_memento_limit_ != NULL) {
+    allocation_memento_limit_ = NULL;
+    ProcessPretenuringFeedback();
+  }
+
   // Update how much has survived scavenge.
   IncrementYoungSurvivorsCounter(
-      (PromotedSpaceSize() - survived_watermark) + new_space_.Size());
+      (PromotedSpaceSize() - survived_watermark) + new_space_.Size() +
+      pretenured_bytes_since_last_scavenge_);
+  pretenured_bytes_since_last_scavenge_ = 0;
 
   LOG(ResourceEvent("scavenge", "end"));
 
@@ -980,6 +1064,31 @@ void Heap::Scavenge() {
 }
 
 
+void Heap::ProcessPretenuringFeedback() {
+  List<AllocationSite*>& sites = allocation_sites_with_mementos_;
+  int i = 0;
+  while (i < sites.length()) {
+    AllocationSite* site = sites[i];
+    if (site->state() == AllocationSite::kPending) {
+      site->DigestPretenuringFeedback();
+      sites[i] = sites.last();
+      sites.RemoveLast();
+    } else {
+      ASSERT(site->state() == AllocationSite::kCollecting);
+      i++;
+    }
+  }
+}
+
+
+void Heap::ResetPretenuringFeedback() {
+  for (int i = 0; i < allocation_sites_with_mementos_.length(); i++) {
+    allocation_sites_with_mementos_[i]->ResetPretenuringFeedback();
+  }
+  allocation_sites_with_mementos_.Clear();
+}
+
+
 String* Heap::UpdateNewSpaceReferenceInExternalStringTableEntry(Object** p) {
   MapWord first_word = HeapObject::cast(*p)->map_word();
 
@@ -1160,6 +1269,12 @@ class ScavengingVisitor : public StaticVisitorBase {
            (object_size <= Page::kMaxHeapObjectSize));
     ASSERT(object->Size() == object_size);
 
+    AllocationMemento* memento =
+        Heap::FindAllocationMemento(object, object_size);
+    if (memento != NULL) {
+      memento->allocation_site()->IncrementMementoFoundCount();
+    }
+
     if (Heap::ShouldBePromoted(object->address(), object_size)) {
       Object* result;
 
@@ -1534,6 +1649,10 @@ bool Heap::CreateInitialMaps() {
   if (obj->IsFailure()) return false;
   set_two_pointer_filler_map(Map::cast(obj));
 
+  obj = AllocateMap(FILLER_TYPE, AllocationMemento::kSize);
+  if (obj->IsFailure()) return false;
+  set_allocation_memento_map(Map::cast(obj));
+
   for (unsigned i = 0; i < ARRAY_SIZE(struct_table); i++) {
     const StructTable& entry = struct_table[i];
     obj = AllocateMap(entry.type, entry.size);
@@ -1607,6 +1726,14 @@ Object* Heap::AllocateJSGlobalPropertyCell(Object* value) {
 }
 
 
+Object* Heap::AllocateAllocationSite() {
+  Object* result = AllocateFixedArray(AllocationSite::kLength, TENURED);
+  if (result->IsFailure()) return result;
+  reinterpret_cast<AllocationSite*>(result)->ResetPretenuringFeedback();
+  return result;
+}
+
+
 Object* Heap::CreateOddball(const char* to_string,
                             Object* to_number) {
   Object* result = Allocate(oddball_map(), OLD_DATA_SPACE);
@@ -1992,7 +2119,9 @@ Object* Heap::AllocateSharedFunctionInfo(Object* name) {
   share->set_inferred_name(empty_string());
   share->set_compiler_hints(0);
   share->set_this_property_assignments_count(0);
+  share->set_tier_up_counter(FLAG_tier_up_threshold);
   share->set_this_property_assignments(undefined_value());
+  share->set_allocation_site(undefined_value());
   share->set_num_literals(0);
   share->set_end_position(0);
   share->set_function_token_position(0);
@@ -2763,7 +2892,9 @@ Object* Heap::AllocateGlobalObject(JSFunction* constructor) {
 }
 
 
-Object* Heap::CopyJSObject(JSObject* source) {
+Object* Heap::CopyJSObject(JSObject* source,
+                           PretenureFlag pretenure,
+                           AllocationSite* site) {
   // Never used to copy functions.  If functions need to be copied we
   // have to be careful to clear the literals array.
   ASSERT(!source->IsJSFunction());
@@ -2773,10 +2904,13 @@ Object* Heap::CopyJSObject(JSObject* source) {
   int object_size = map->instance_size();
   Object* clone;
 
-  // If we're forced to always allocate, we use the general allocation
-  // functions which may leave us with an object in old space.
-  if (always_allocate()) {
-    clone = AllocateRaw(object_size, NEW_SPACE, OLD_POINTER_SPACE);
+  // If we're forced to always allocate, or asked to pretenure, we use the
+  // general allocation functions which may leave us with an object in old
+  // space.
+  if (always_allocate() || pretenure == TENURED) {
+    AllocationSpace space =
+        (pretenure == TENURED) ? OLD_POINTER_SPACE : NEW_SPACE;
+    clone = AllocateRaw(object_size, space, OLD_POINTER_SPACE);
     if (clone->IsFailure()) return clone;
     Address clone_address = HeapObject::cast(clone)->address();
     CopyBlock(clone_address,
@@ -2795,6 +2929,7 @@ Object* Heap::CopyJSObject(JSObject* source) {
     CopyBlock(HeapObject::cast(clone)->address(),
               source->address(),
               object_size);
+    if (site != NULL) CreateAllocationMemento(HeapObject::cast(clone), site);
   }
 
   FixedArray* elements = FixedArray::cast(source->elements());
@@ -2803,13 +2938,13 @@ Object* Heap::CopyJSObject(JSObject* source) {
   if (elements->length() > 0) {
     Object* elem =
         (elements->map() == fixed_cow_array_map()) ?
-        elements : CopyFixedArray(elements);
+        elements : CopyFixedArray(elements, pretenure);
     if (elem->IsFailure()) return elem;
     JSObject::cast(clone)->set_elements(FixedArray::cast(elem));
   }
   // Update properties if necessary.
   if (properties->length() > 0) {
-    Object* prop = CopyFixedArray(properties);
+    Object* prop = CopyFixedArray(properties, pretenure);
     if (prop->IsFailure()) return prop;
     JSObject::cast(clone)->set_properties(FixedArray::cast(prop));
   }
@@ -2821,6 +2956,25 @@ Object* Heap::CopyJSObject(JSObject* source) {
 }
 
 
+void Heap::CreateAllocationMemento(HeapObject* object, AllocationSite* site) {
+  ASSERT(site->state() == AllocationSite::kCollecting);
+  if (object->address() + object->Size() != new_space_.top()) return;
+  Object* result = new_space_.AllocateRaw(AllocationMemento::kSize);
+  if (result->IsFailure()) return;
+  AllocationMemento* memento = reinterpret_cast<AllocationMemento*>(result);
+  memento->set_map(allocation_memento_map());
+  memento->set_allocation_site(site);
+
+  if (site->memento_create_count() == 0) {
+    allocation_sites_with_mementos_.Add(site);
+  }
+  site->IncrementMementoCreateCount();
+  if (site->memento_create_count() == AllocationSite::kMementoSampleSize) {
+    site->set_state(AllocationSite::kPending);
+  }
+}
+
+
 Object* Heap::ReinitializeJSGlobalProxy(JSFunction* constructor,
                                         JSGlobalProxy* object) {
   // Allocate initial map if absent.
@@ -3092,13 +3246,12 @@ Object* Heap::AllocateRawFixedArray(int length) {
 }
 
 
-Object* Heap::CopyFixedArray(FixedArray* src) {
-  int len = src->length();
-  Object* obj = AllocateRawFixedArray(len);
+static Object* CopyFixedArrayInto(FixedArray* src, Object* obj) {
   if (obj->IsFailure()) return obj;
+  int len = src->length();
   if (Heap::InNewSpace(obj)) {
     HeapObject* dst = HeapObject::cast(obj);
-    CopyBlock(dst->address(), src->address(), FixedArray::SizeFor(len));
+    Heap::CopyBlock(dst->address(), src->address(), FixedArray::SizeFor(len));
     return obj;
   }
   HeapObject::cast(obj)->set_map(src->map());
@@ -3113,6 +3266,17 @@ Object* Heap::CopyFixedArray(FixedArray* src) {
 }
 
 
+Object* Heap::CopyFixedArray(FixedArray* src) {
+  return CopyFixedArrayInto(src, AllocateRawFixedArray(src->length()));
+}
+
+
+Object* Heap::CopyFixedArray(FixedArray* src, PretenureFlag pretenure) {
+  return CopyFixedArrayInto(src,
+                            AllocateRawFixedArray(src->length(), pretenure));
+}
+
+
 Object* Heap::AllocateFixedArray(int length) {
   ASSERT(length >= 0);
   if (length == 0) return empty_fixed_array();
@@ -3289,6 +3453,15 @@ bool Heap::IdleNotification() {
     last_gc_count = gc_count_;
   }
 
+  if (memory_reduction_pending_ && contexts_disposed_ == 0) {
+    // A full compacting collection is part of the reduction, so this is as
+    // much cleanup as the idle collections below could do.
+    ReduceMemoryFootprint();
+    last_gc_count = gc_count_;
+    number_idle_notifications = 0;
+    return true;
+  }
+
   if (number_idle_notifications == kIdlesBeforeScavenge) {
     if (contexts_disposed_ > 0) {
       HistogramTimerScope scope(&Counters::gc_context);
@@ -3342,6 +3515,45 @@ bool Heap::IdleNotification() {
 }
 
 
+// Heaps that could give back less than this are not worth a compacting
+// collection.
+static const int kMinMemoryReduction = 2 * MB;
+
+
+void Heap::CheckMemoryReduction() {
+  if (!FLAG_memory_reducer) return;
+  int live = SizeOfObjects();
+  // Leave room for the live objects to grow by half before the next
+  // collection.
+  int footprint = Max(Max(target_footprint_, live + live / 2),
+                      committed_memory_after_reduction_);
+  memory_reduction_pending_ =
+      CommittedMemory() - footprint >= kMinMemoryReduction;
+}
+
+
+void Heap::ReduceMemoryFootprint() {
+  int committed_before = CommittedMemory();
+  // The compacting collection moves the live objects to the first pages of
+  // each space and releases the chunks behind them (see Shrink).
+  CollectAllGarbage(true);
+  new_space_.Shrink();
+  UncommitFromSpace();
+  int committed_after = CommittedMemory();
+  if (committed_after < committed_before) {
+    reclaimed_memory_ += committed_before - committed_after;
+  }
+  committed_memory_after_reduction_ = committed_after;
+  memory_reduction_pending_ = false;
+  if (FLAG_trace_gc) {
+    PrintF("Memory reducer: %d -> %d KB committed, %d KB live.\n",
+           committed_before / KB,
+           committed_after / KB,
+           SizeOfObjects() / KB);
+  }
+}
+
+
 #ifdef DEBUG
 
 void Heap::Print() {
@@ -3493,9 +3705,29 @@ static void VerifyPointersUnderWatermark(LargeObjectSpace* space) {
 }
 
 
+void VerifyPointersAndDirtyRegionsVisitor::VisitPointers(Object** start,
+                                                         Object** end) {
+  for (Object** current = start; current < end; current++) {
+    if ((*current)->IsHeapObject()) {
+      HeapObject* object = HeapObject::cast(*current);
+      ASSERT(Heap::Contains(object));
+      ASSERT(object->map()->IsMap());
+      if (Heap::InNewSpace(object)) {
+        ASSERT(Heap::InToSpace(object));
+        Address addr = reinterpret_cast<Address>(current);
+        ASSERT(Page::FromAddress(addr)->IsRegionDirty(addr) ||
+               StoreBuffer::CellIsInStoreBuffer(addr));
+      }
+    }
+  }
+}
+
+
 void Heap::Verify() {
   ASSERT(HasBeenSetup());
 
+  Sweeper::EnsureCompleted();
+
   VerifyPointersVisitor visitor;
   IterateRoots(&visitor, VISIT_ONLY_STRONG);
 
@@ -3693,7 +3925,7 @@ void Heap::IterateAndMarkPointersToFromSpace(Address start,
   Address slot_address = start;
   Page* page = Page::FromAddress(start);
 
-  uint32_t marks = page->GetRegionMarks();
+  uint32_t marks = Page::kAllRegionsCleanMarks;
 
   while (slot_address < end) {
     Object** slot = reinterpret_cast<Object**>(slot_address);
@@ -3702,13 +3934,18 @@ void Heap::IterateAndMarkPointersToFromSpace(Address start,
       callback(reinterpret_cast<HeapObject**>(slot));
       if (Heap::InNewSpace(*slot)) {
         ASSERT((*slot)->IsHeapObject());
-        marks |= page->GetRegionMaskForAddress(slot_address);
+        if (FLAG_store_buffer && Page::FromAddress(slot_address) == page) {
+          StoreBuffer::Mark(slot_address);
+        } else {
+          marks |= page->GetRegionMaskForAddress(slot_address);
+        }
       }
     }
     slot_address += kPointerSize;
   }
 
-  page->SetRegionMarks(marks);
+  // The store buffer may have been turned into region marks meanwhile.
+  page->SetRegionMarks(page->GetRegionMarks() | marks);
 }
 
 
@@ -3808,11 +4045,15 @@ void Heap::IterateDirtyRegions(
              (space == map_space_ &&
               ((page->ObjectAreaStart() - end) % Map::kSize == 0)));
 
-      page->SetRegionMarks(IterateDirtyRegions(marks,
-                                               start,
-                                               end,
-                                               visit_dirty_region,
-                                               copy_object_func));
+      uint32_t newmarks = IterateDirtyRegions(marks,
+                                              start,
+                                              end,
+                                              visit_dirty_region,
+                                              copy_object_func);
+      // While incremental marking is in progress dirty marks also record
+      // writes into marked objects, so they are kept until the next full GC.
+      if (IncrementalMarking::IsMarking()) newmarks |= marks;
+      page->SetRegionMarks(newmarks);
     }
 
     // Mark page watermark as invalid to maintain watermark validity invariant.
@@ -4087,6 +4328,8 @@ bool Heap::Setup(bool create_heap_objects) {
   if (lo_space_ == NULL) return false;
   if (!lo_space_->Setup()) return false;
 
+  StoreBuffer::Setup();
+
   if (create_heap_objects) {
     // Create initial maps.
     if (!CreateInitialMaps()) return false;
@@ -4139,6 +4382,18 @@ void Heap::TearDown() {
 
   ExternalStringTable::TearDown();
 
+  MarkCompactCollector::TearDown();
+
+  ParallelScavenger::TearDown();
+
+  allocation_sites_with_mementos_.Clear();
+
+  IncrementalMarking::TearDown();
+
+  StoreBuffer::TearDown();
+
+  Sweeper::TearDown();
+
   new_space_.TearDown();
 
   if (old_pointer_space_ != NULL) {
@@ -4629,6 +4884,8 @@ GCTracer::GCTracer()
       full_gc_count_(0),
       is_compacting_(false),
       marked_count_(0),
+      marking_threads_(0),
+      scavenging_threads_(0),
       allocated_since_last_gc_(0),
       spent_in_mutator_(0),
       promoted_objects_size_(0) {
@@ -4636,6 +4893,14 @@ GCTracer::GCTracer()
   // Set them before they are changed by the collector.
   previous_has_compacted_ = MarkCompactCollector::HasCompacted();
   previous_marked_count_ = MarkCompactCollector::previous_marked_count();
+  for (int i = 0; i < kMaxMarkingThreads; i++) {
+    marking_thread_time_[i] = 0;
+    marking_thread_marked_count_[i] = 0;
+  }
+  for (int i = 0; i < kMaxScavengingThreads; i++) {
+    scavenging_thread_time_[i] = 0;
+    scavenging_thread_copied_bytes_[i] = 0;
+  }
   if (!FLAG_trace_gc && !FLAG_print_cumulative_gc_stat) return;
   start_time_ = OS::TimeCurrentMillis();
   start_size_ = Heap::SizeOfObjects();
@@ -4705,9 +4970,25 @@ GCTracer::~GCTracer() {
 
     PrintF("external=%d ", static_cast<int>(scopes_[Scope::EXTERNAL]));
     PrintF("mark=%d ", static_cast<int>(scopes_[Scope::MC_MARK]));
+    for (int i = 0; i < marking_threads_; i++) {
+      PrintF("mark_thread%d=%d ", i,
+             static_cast<int>(marking_thread_time_[i]));
+      PrintF("marked_thread%d=%d ", i, marking_thread_marked_count_[i]);
+    }
+    for (int i = 0; i < scavenging_threads_; i++) {
+      PrintF("scavenge_thread%d=%d ", i,
+             static_cast<int>(scavenging_thread_time_[i]));
+      PrintF("scavenged_thread%d=%d ", i, scavenging_thread_copied_bytes_[i]);
+    }
     PrintF("sweep=%d ", static_cast<int>(scopes_[Scope::MC_SWEEP]));
     PrintF("sweepns=%d ", static_cast<int>(scopes_[Scope::MC_SWEEP_NEWSPACE]));
     PrintF("compact=%d ", static_cast<int>(scopes_[Scope::MC_COMPACT]));
+    PrintF("incremental=%d ",
+           static_cast<int>(scopes_[Scope::INCREMENTAL_MARKING]));
+    PrintF("lazy_sweep=%d ",
+           static_cast<int>(Sweeper::TakeLazySweepingTime()));
+    PrintF("concurrent_sweep=%d ",
+           static_cast<int>(Sweeper::TakeConcurrentSweepingTime()));
 
     PrintF("total_size_before=%d ", start_size_);
     PrintF("total_size_after=%d ", Heap::SizeOfObjects());
@@ -92,6 +92,7 @@ namespace internal {
   V(Map, global_property_cell_map, GlobalPropertyCellMap)                      \
   V(Map, shared_function_info_map, SharedFunctionInfoMap)                      \
   V(Map, proxy_map, ProxyMap)                                                  \
+  V(Map, allocation_memento_map, AllocationMementoMap)                         \
   V(Object, nan_value, NanValue)                                               \
   V(Object, minus_zero_value, MinusZeroValue)                                  \
   V(Object, instanceof_cache_function, InstanceofCacheFunction)                \
@@ -166,6 +167,7 @@ namespace internal {
   V(Date_symbol, "Date")                                                 \
   V(this_symbol, "this")                                                 \
   V(to_string_symbol, "toString")                                        \
+  V(to_json_symbol, "toJSON")                                            \
   V(char_at_symbol, "CharAt")                                            \
   V(undefined_symbol, "undefined")                                       \
   V(value_of_symbol, "valueOf")                                          \
@@ -324,8 +326,13 @@ class Heap : public AllStatic {
 
   // Returns a deep copy of the JavaScript object.
   // Properties and elements are copied too.
+  // The copy is allocated in old space if pretenure is TENURED.  If a site
+  // is given, an allocation memento for it is placed behind a copy that is
+  // allocated in new space.
   // Returns failure if allocation failed.
-  static Object* CopyJSObject(JSObject* source);
+  static Object* CopyJSObject(JSObject* source,
+                              PretenureFlag pretenure = NOT_TENURED,
+                              AllocationSite* site = NULL);
 
   // Allocates the function prototype.
   // Returns Failure::RetryAfterGC(requested_bytes, space) if the allocation
@@ -473,6 +480,12 @@ class Heap : public AllStatic {
   // Please note this does not perform a garbage collection.
   static Object* AllocateJSGlobalPropertyCell(Object* value);
 
+  // Allocate a tenured allocation site that collects feedback.
+  // Returns Failure::RetryAfterGC(requested_bytes, space) if the allocation
+  // failed.
+  // Please note this does not perform a garbage collection.
+  static Object* AllocateAllocationSite();
+
   // Allocates a fixed array initialized with undefined values
   // Returns Failure::RetryAfterGC(requested_bytes, space) if the allocation
   // failed.
@@ -491,6 +504,7 @@ class Heap : public AllStatic {
   // Make a copy of src and return it. Returns
   // Failure::RetryAfterGC(requested_bytes, space) if the allocation failed.
   static Object* CopyFixedArray(FixedArray* src);
+  static Object* CopyFixedArray(FixedArray* src, PretenureFlag pretenure);
 
   // Allocates a fixed array initialized with the hole values.
   // Returns Failure::RetryAfterGC(requested_bytes, space) if the allocation
@@ -875,6 +889,9 @@ class Heap : public AllStatic {
   enum HeapState { NOT_IN_GC, SCAVENGE, MARK_COMPACT };
   static inline HeapState gc_state() { return gc_state_; }
 
+  // Number of garbage collections performed so far.
+  static int gc_count() { return gc_count_; }
+
 #ifdef DEBUG
   static bool IsAllocationAllowed() { return allocation_allowed_; }
   static inline bool allow_allocation(bool enable);
@@ -952,9 +969,32 @@ class Heap : public AllStatic {
     return OldGenerationSpaceAvailable() < 0;
   }
 
+  // True if the old generation has grown enough that incremental marking
+  // should start, so that it can finish before the promotion limit is
+  // reached.
+  static bool OldGenerationIncrementalMarkingLimitReached() {
+    return (PromotedSpaceSize() + PromotedExternalMemorySize())
+           > old_gen_incremental_marking_limit_;
+  }
+
   // Can be called when the embedding application is idle.
   static bool IdleNotification();
 
+  // Compacts the heap and returns the memory it no longer needs to the
+  // operating system: whole chunks of the paged spaces behind the
+  // allocation tops, the unused part of the semispaces and the from space.
+  static void ReduceMemoryFootprint();
+
+  // The committed heap size below which idle notifications do not shrink
+  // the heap.
+  static void SetTargetFootprint(int target_footprint) {
+    target_footprint_ = target_footprint;
+  }
+
+  // Total number of bytes ReduceMemoryFootprint returned to the operating
+  // system.
+  static intptr_t ReclaimedMemory() { return reclaimed_memory_; }
+
   // Declare all the root indices.
   enum RootListIndex {
 #define ROOT_INDEX_DECLARATION(type, name, camel_name) k##camel_name##RootIndex,
@@ -1017,6 +1057,24 @@ class Heap : public AllStatic {
   // we try to promote this object.
   static inline bool ShouldBePromoted(Address old_address, int object_size);
 
+  // Places an allocation memento for the site directly behind the object,
+  // which has to be the most recent allocation in new space.  Does nothing
+  // if it is not, or if new space is full.
+  static void CreateAllocationMemento(HeapObject* object,
+                                      AllocationSite* site);
+
+  // Records an object that its allocation site placed in old space.  Such
+  // objects count as survivors of the next scavenge, so that pretenuring
+  // does not hide a high survival rate from the old generation limits.
+  static void RecordPretenuredAllocation(int size_in_bytes) {
+    pretenured_bytes_since_last_scavenge_ += size_in_bytes;
+  }
+
+  // Returns the allocation memento behind an object that a scavenge
+  // evacuates from the from space, or NULL if there is none.
+  static inline AllocationMemento* FindAllocationMemento(HeapObject* object,
+                                                         int object_size);
+
   static int MaxObjectSizeInNewSpace() { return kMaxObjectSizeInNewSpace; }
 
   static void ClearJSFunctionResultCaches();
@@ -1040,6 +1098,30 @@ class Heap : public AllStatic {
   // For keeping track of context disposals.
   static int contexts_disposed_;
 
+  // The memory reducer.  After each collection it compares the committed
+  // memory with the memory the live objects need, and sets
+  // memory_reduction_pending_ if the next idle notification should reduce
+  // the footprint.
+  static void CheckMemoryReduction();
+
+  static bool memory_reduction_pending_;
+  static int target_footprint_;
+  // Committed memory after the last reduction.  It could not be reduced
+  // further at the time, so it does not trigger another reduction.
+  static int committed_memory_after_reduction_;
+  static intptr_t reclaimed_memory_;
+
+  // Allocation sites that placed mementos since the last full GC.  Sites are
+  // tenured, so the list only has to be cleared before full GCs, which also
+  // discard all mementos.
+  static List<AllocationSite*> allocation_sites_with_mementos_;
+
+  // During a scavenge, the top of the from space if any allocation site
+  // placed mementos, NULL otherwise.
+  static Address allocation_memento_limit_;
+
+  static int pretenured_bytes_since_last_scavenge_;
+
 #if defined(V8_TARGET_ARCH_X64)
   static const int kMaxObjectSizeInNewSpace = 512*KB;
 #else
@@ -1098,6 +1180,11 @@ class Heap : public AllStatic {
   // every allocation in large object space.
   static int old_gen_allocation_limit_;
 
+  // Limit that starts incremental marking at the end of a scavenge.  It is
+  // halfway between the old generation size after the last global GC and
+  // the promotion limit.
+  static int old_gen_incremental_marking_limit_;
+
   // Limit on the amount of externally allocated memory allowed
   // between global GCs. If reached a global GC is forced.
   static int external_allocation_limit_;
@@ -1224,6 +1311,14 @@ class Heap : public AllStatic {
   static void MarkCompactPrologue(bool is_compacting);
   static void MarkCompactEpilogue(bool is_compacting);
 
+  // Lets the pending allocation sites decide after a scavenge found the
+  // mementos of their surviving objects.
+  static void ProcessPretenuringFeedback();
+
+  // Restarts the feedback collection of all allocation sites that placed
+  // mementos, before a full GC discards the mementos.
+  static void ResetPretenuringFeedback();
+
   // Completely clear the Instanceof cache (to stop it keeping objects alive
   // around a GC).
   static void CompletelyClearInstanceofCache() {
@@ -1405,22 +1500,10 @@ class VerifyPointersVisitor: public ObjectVisitor {
 // to keep track of intergenerational references.
 // As VerifyPointersVisitor but also checks that dirty marks are set
 // for regions covering intergenerational references.
+// References recorded in the store buffer need not be covered.
 class VerifyPointersAndDirtyRegionsVisitor: public ObjectVisitor {
  public:
-  void VisitPointers(Object** start, Object** end) {
-    for (Object** current = start; current < end; current++) {
-      if ((*current)->IsHeapObject()) {
-        HeapObject* object = HeapObject::cast(*current);
-        ASSERT(Heap::Contains(object));
-        ASSERT(object->map()->IsMap());
-        if (Heap::InNewSpace(object)) {
-          ASSERT(Heap::InToSpace(object));
-          Address addr = reinterpret_cast<Address>(current);
-          ASSERT(Page::FromAddress(addr)->IsRegionDirty(addr));
-        }
-      }
-    }
-  }
+  void VisitPointers(Object** start, Object** end);
 };
 #endif
 
@@ -1727,6 +1810,7 @@ class GCTracer BASE_EMBEDDED {
       MC_SWEEP_NEWSPACE,
       MC_COMPACT,
       MC_FLUSH_CODE,
+      INCREMENTAL_MARKING,
       kNumberOfScopes
     };
 
@@ -1769,6 +1853,32 @@ class GCTracer BASE_EMBEDDED {
 
   int marked_count() { return marked_count_; }
 
+  // Maximum number of threads taking part in parallel marking.
+  static const int kMaxMarkingThreads = 16;
+
+  // Records the time (in ms) a thread spent marking objects during a
+  // parallel marking phase and the number of objects it marked.  A full
+  // GC may run several parallel marking phases; the numbers accumulate.
+  void AddMarkingThreadStats(int thread, double time, int marked_count) {
+    ASSERT((0 <= thread) && (thread < kMaxMarkingThreads));
+    if (thread >= marking_threads_) marking_threads_ = thread + 1;
+    marking_thread_time_[thread] += time;
+    marking_thread_marked_count_[thread] += marked_count;
+    marked_count_ += marked_count;
+  }
+
+  // Maximum number of threads taking part in a parallel scavenge.
+  static const int kMaxScavengingThreads = 16;
+
+  // Records the time (in ms) a thread spent in a parallel scavenge and the
+  // number of bytes it copied.
+  void AddScavengingThreadStats(int thread, double time, int copied_bytes) {
+    ASSERT((0 <= thread) && (thread < kMaxScavengingThreads));
+    if (thread >= scavenging_threads_) scavenging_threads_ = thread + 1;
+    scavenging_thread_time_[thread] += time;
+    scavenging_thread_copied_bytes_[thread] += copied_bytes;
+  }
+
   void increment_promoted_objects_size(int object_size) {
     promoted_objects_size_ += object_size;
   }
@@ -1822,6 +1932,18 @@ class GCTracer BASE_EMBEDDED {
   // Amounts of time spent in different scopes during GC.
   double scopes_[Scope::kNumberOfScopes];
 
+  // Number of threads that took part in parallel marking, the time each of
+  // them spent marking and the number of objects each of them marked.
+  int marking_threads_;
+  double marking_thread_time_[kMaxMarkingThreads];
+  int marking_thread_marked_count_[kMaxMarkingThreads];
+
+  // Number of threads that took part in a parallel scavenge, the time each
+  // of them spent and the number of bytes each of them copied.
+  int scavenging_threads_;
+  double scavenging_thread_time_[kMaxScavengingThreads];
+  int scavenging_thread_copied_bytes_[kMaxScavengingThreads];
+
   // Total amount of space either wasted or contained in one of free lists
   // before the current GC.
   int in_free_list_or_wasted_before_gc_;
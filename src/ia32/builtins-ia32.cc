@@ -147,6 +147,20 @@ static void Generate_JSConstructStubHelper(MacroAssembler* masm,
     __ CmpInstanceType(eax, JS_FUNCTION_TYPE);
     __ j(equal, &rt_call);
 
+    // Leave the allocation to the runtime while the allocation site of the
+    // constructor collects feedback, or when it tenures the objects.
+    // edi: constructor
+    // eax: initial map
+    Label allocate;
+    __ mov(ebx, FieldOperand(edi, JSFunction::kSharedFunctionInfoOffset));
+    __ mov(ebx, FieldOperand(ebx, SharedFunctionInfo::kAllocationSiteOffset));
+    __ cmp(ebx, Factory::undefined_value());
+    __ j(equal, &allocate);
+    __ cmp(FieldOperand(ebx, AllocationSite::kStateOffset),
+           Immediate(Smi::FromInt(AllocationSite::kPending)));
+    __ j(less, &rt_call);
+    __ bind(&allocate);
+
     // Now allocate the JSObject on the heap.
     // edi: constructor
     // eax: initial map
@@ -445,6 +459,26 @@ void Builtins::Generate_LazyCompile(MacroAssembler* masm) {
 }
 
 
+void Builtins::Generate_LazyRecompile(MacroAssembler* masm) {
+  // Enter an internal frame.
+  __ EnterInternalFrame();
+
+  // Push a copy of the function onto the stack.
+  __ push(edi);
+
+  __ push(edi);  // Function is also the parameter to the runtime call.
+  __ CallRuntime(Runtime::kLazyRecompile, 1);
+  __ pop(edi);
+
+  // Tear down temporary frame.
+  __ LeaveInternalFrame();
+
+  // Do a tail-call of the recompiled function.
+  __ lea(ecx, FieldOperand(eax, Code::kHeaderSize));
+  __ jmp(Operand(ecx));
+}
+
+
 void Builtins::Generate_FunctionCall(MacroAssembler* masm) {
   // 1. Make sure we have at least one argument.
   { Label done;
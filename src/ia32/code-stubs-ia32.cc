@@ -153,6 +153,18 @@ void FastCloneShallowArrayStub::Generate(MacroAssembler* masm) {
   __ cmp(ecx, Factory::undefined_value());
   __ j(equal, &slow_case);
 
+  // Leave the cloning to the runtime while the allocation site of the literal
+  // collects feedback, or when it tenures the arrays.
+  Label allocate;
+  __ mov(ebx, Operand(esp, 3 * kPointerSize));
+  __ mov(ebx, CodeGenerator::FixedArrayElementOperand(ebx, eax, 1));
+  __ cmp(ebx, Factory::undefined_value());
+  __ j(equal, &allocate);
+  __ cmp(FieldOperand(ebx, AllocationSite::kStateOffset),
+         Immediate(Smi::FromInt(AllocationSite::kPending)));
+  __ j(less, &slow_case);
+  __ bind(&allocate);
+
   if (FLAG_debug_code) {
     const char* message;
     Handle<Map> expected_map;
@@ -3561,6 +3573,196 @@ const char* CompareStub::GetName() {
 }
 
 
+Token::Value ICCompareStub::ComputeOperation(Condition cc, bool strict) {
+  switch (cc) {
+    case equal: return strict ? Token::EQ_STRICT : Token::EQ;
+    case less: return Token::LT;
+    case greater: return Token::GT;
+    case less_equal: return Token::LTE;
+    case greater_equal: return Token::GTE;
+    default:
+      UNREACHABLE();
+      return Token::ILLEGAL;
+  }
+}
+
+
+Condition ICCompareStub::GetCondition() {
+  switch (op_) {
+    case Token::EQ:
+    case Token::EQ_STRICT:
+      return equal;
+    case Token::LT: return less;
+    case Token::GT: return greater;
+    case Token::LTE: return less_equal;
+    case Token::GTE: return greater_equal;
+    default:
+      UNREACHABLE();
+      return no_condition;
+  }
+}
+
+
+void ICCompareStub::GenerateHeapNumbers(MacroAssembler* masm) {
+  ASSERT(type_info_ == CompareIC::HEAP_NUMBERS);
+
+  // Without SSE2 the first miss moves the call site to the generic stub.
+  if (!CpuFeatures::IsSupported(SSE2)) {
+    GenerateMiss(masm);
+    return;
+  }
+
+  CpuFeatures::Scope use_sse2(SSE2);
+  Label unordered, miss;
+
+  // Load left and right operand, which must be smis or heap numbers.
+  FloatingPointHelper::LoadSSE2Operands(masm, &miss);
+  __ ucomisd(xmm0, xmm1);
+
+  // Don't base result on EFLAGS when a NaN is involved.
+  __ j(parity_even, &unordered, not_taken);
+  // Return a result of -1, 0, or 1, based on EFLAGS. Performing mov,
+  // because xor would destroy the flag register.
+  __ mov(eax, 0);
+  __ mov(ecx, 0);
+  __ setcc(above, eax);
+  __ setcc(below, ecx);
+  __ sub(eax, Operand(ecx));
+  __ ret(0);
+
+  // If one of the numbers was NaN, then the result is always false.
+  __ bind(&unordered);
+  Condition cc = GetCondition();
+  if (cc == less || cc == less_equal) {
+    __ mov(eax, Immediate(Smi::FromInt(1)));
+  } else {
+    __ mov(eax, Immediate(Smi::FromInt(-1)));
+  }
+  __ ret(0);
+
+  __ bind(&miss);
+  GenerateMiss(masm);
+}
+
+
+void ICCompareStub::GenerateSymbols(MacroAssembler* masm) {
+  ASSERT(type_info_ == CompareIC::SYMBOLS);
+  ASSERT(GetCondition() == equal);
+  Label miss;
+
+  // Check that both operands are heap objects.
+  __ mov(ecx, Operand(edx));
+  __ and_(ecx, Operand(eax));
+  __ test(ecx, Immediate(kSmiTagMask));
+  __ j(zero, &miss, not_taken);
+
+  // Check that both operands are symbols.
+  __ mov(ecx, FieldOperand(edx, HeapObject::kMapOffset));
+  __ mov(ebx, FieldOperand(eax, HeapObject::kMapOffset));
+  __ movzx_b(ecx, FieldOperand(ecx, Map::kInstanceTypeOffset));
+  __ movzx_b(ebx, FieldOperand(ebx, Map::kInstanceTypeOffset));
+  STATIC_ASSERT(LAST_TYPE < kNotStringTag + kIsSymbolMask);
+  STATIC_ASSERT(kSymbolTag != 0);
+  __ and_(ecx, Operand(ebx));
+  __ test(ecx, Immediate(kIsSymbolMask));
+  __ j(zero, &miss, not_taken);
+
+  // Symbols are equal only if they are identical. Register eax already
+  // holds a non-zero value, which indicates not equal.
+  Label done;
+  __ cmp(edx, Operand(eax));
+  __ j(not_equal, &done);
+  __ Set(eax, Immediate(Smi::FromInt(EQUAL)));
+  __ bind(&done);
+  __ ret(0);
+
+  __ bind(&miss);
+  GenerateMiss(masm);
+}
+
+
+void ICCompareStub::GenerateStrings(MacroAssembler* masm) {
+  ASSERT(type_info_ == CompareIC::STRINGS);
+  Label miss;
+
+  // Identical strings are equal. This also holds for the relational
+  // operators, as no string is NaN.
+  Label not_identical;
+  __ cmp(edx, Operand(eax));
+  __ j(not_equal, &not_identical);
+  __ Set(eax, Immediate(Smi::FromInt(EQUAL)));
+  __ ret(0);
+
+  // Check that both operands are flat ascii strings and compare them.
+  __ bind(&not_identical);
+  __ JumpIfNotBothSequentialAsciiStrings(edx, eax, ecx, ebx, &miss);
+  StringCompareStub::GenerateCompareFlatAsciiStrings(masm,
+                                                     edx,
+                                                     eax,
+                                                     ecx,
+                                                     ebx,
+                                                     edi);
+
+  __ bind(&miss);
+  GenerateMiss(masm);
+}
+
+
+void ICCompareStub::GenerateObjects(MacroAssembler* masm) {
+  ASSERT(type_info_ == CompareIC::OBJECTS);
+  ASSERT(GetCondition() == equal);
+  Label miss;
+
+  // Check that both operands are JS objects.
+  __ mov(ecx, Operand(edx));
+  __ and_(ecx, Operand(eax));
+  __ test(ecx, Immediate(kSmiTagMask));
+  __ j(zero, &miss, not_taken);
+  __ CmpObjectType(eax, FIRST_JS_OBJECT_TYPE, ecx);
+  __ j(below, &miss, not_taken);
+  __ CmpObjectType(edx, FIRST_JS_OBJECT_TYPE, ecx);
+  __ j(below, &miss, not_taken);
+
+  // Objects are equal only if they are identical.
+  __ sub(eax, Operand(edx));
+  __ ret(0);
+
+  __ bind(&miss);
+  GenerateMiss(masm);
+}
+
+
+void ICCompareStub::GenerateMiss(MacroAssembler* masm) {
+  // Save the operands below the return address, where they survive the
+  // call to the runtime system.
+  __ pop(ecx);
+  __ push(edx);
+  __ push(eax);
+  __ push(ecx);
+
+  // Call the runtime system in a fresh internal frame. It patches the call
+  // site and returns the code object of the new stub.
+  ExternalReference miss = ExternalReference(IC_Utility(IC::kCompareIC_Miss));
+  __ EnterInternalFrame();
+  __ push(edx);
+  __ push(eax);
+  __ push(Immediate(Smi::FromInt(op_)));
+  __ push(Immediate(Smi::FromInt(type_info_)));
+  __ CallExternalReference(miss, 4);
+  __ LeaveInternalFrame();
+
+  // Compute the entry point of the new stub.
+  __ lea(edi, FieldOperand(eax, Code::kHeaderSize));
+
+  // Restore the operands and tail call the new stub.
+  __ pop(ecx);
+  __ pop(eax);
+  __ pop(edx);
+  __ push(ecx);
+  __ jmp(Operand(edi));
+}
+
+
 // -------------------------------------------------------------------------
 // StringCharCodeAtGenerator
 
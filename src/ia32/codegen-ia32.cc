@@ -2851,9 +2851,9 @@ void CodeGenerator::Comparison(AstNode* node,
         GenerateInlineNumberComparison(&left_side, &right_side, cc, dest);
       }
 
-      // End of in-line compare, call out to the compare stub. Don't include
-      // number comparison in the stub if it was inlined.
-      CompareStub stub(cc, strict, nan_info, !inline_number_compare);
+      // End of in-line compare, call out to the compare IC.
+      ICCompareStub stub(ICCompareStub::ComputeOperation(cc, strict),
+                         CompareIC::DEFAULT);
       Result answer = frame_->CallStub(&stub, &left_side, &right_side);
       __ test(answer.reg(), Operand(answer.reg()));
       answer.Unuse();
@@ -2884,9 +2884,9 @@ void CodeGenerator::Comparison(AstNode* node,
           GenerateInlineNumberComparison(&left_side, &right_side, cc, dest);
         }
 
-        // End of in-line compare, call out to the compare stub. Don't include
-        // number comparison in the stub if it was inlined.
-        CompareStub stub(cc, strict, nan_info, !inline_number_compare);
+        // End of in-line compare, call out to the compare IC.
+        ICCompareStub stub(ICCompareStub::ComputeOperation(cc, strict),
+                           CompareIC::DEFAULT);
         Result answer = frame_->CallStub(&stub, &left_side, &right_side);
         __ test(answer.reg(), Operand(answer.reg()));
         answer.Unuse();
@@ -3923,15 +3923,18 @@ void CodeGenerator::VisitDoWhileStatement(DoWhileStatement* node) {
     case ALWAYS_TRUE:
       // Use the continue target.
       node->continue_target()->set_direction(JumpTarget::BIDIRECTIONAL);
+      GenerateOsrEntry(node);
       node->continue_target()->Bind();
       break;
     case ALWAYS_FALSE:
       // No need to label it.
       node->continue_target()->set_direction(JumpTarget::FORWARD_ONLY);
+      GenerateOsrEntry(node, node->continue_target());
       break;
     case DONT_KNOW:
       // Continue is the test, so use the backward body target.
       node->continue_target()->set_direction(JumpTarget::FORWARD_ONLY);
+      GenerateOsrEntry(node, node->continue_target());
       body.Bind();
       break;
   }
@@ -3994,6 +3997,9 @@ void CodeGenerator::VisitWhileStatement(WhileStatement* node) {
   ConditionAnalysis info = AnalyzeCondition(node->cond());
   if (info == ALWAYS_FALSE) return;
 
+  // Full code running the loop continues with the test.
+  GenerateOsrEntry(node);
+
   // Do not duplicate conditions that may have function literal
   // subexpressions.  This can cause us to compile the function literal
   // twice.
@@ -4118,6 +4124,42 @@ void CodeGenerator::SetTypeForStackSlot(Slot* slot, TypeInfo info) {
 }
 
 
+bool CodeGenerator::IsOsrLoop(IterationStatement* node) {
+  return info_->osr_loop_position() != RelocInfo::kNoPosition &&
+      info_->osr_loop_position() == node->statement_pos();
+}
+
+
+void CodeGenerator::GenerateOsrEntry(IterationStatement* node,
+                                     JumpTarget* target) {
+  // Full code only replaces frames holding nothing but the locals.
+  if (!IsOsrLoop(node) || !has_valid_frame() || frame_->height() != 0) {
+    return;
+  }
+  Comment cmnt(masm_, "[ OSR entry");
+  // The full code keeps all values in memory, and they can be of any type.
+  frame_->SpillAll();
+  frame_->ForgetTypeInfo();
+  if (target == NULL) {
+    info_->set_osr_entry_offset(masm_->pc_offset());
+    frame_->RestoreContextRegister();
+    return;
+  }
+
+  // Emit the entry out of line.
+  VirtualFrame* fall_through_frame = frame_;
+  RegisterFile non_frame_registers;
+  SetFrame(new VirtualFrame(fall_through_frame), &non_frame_registers);
+  Label fall_through;
+  __ jmp(&fall_through);
+  info_->set_osr_entry_offset(masm_->pc_offset());
+  frame_->RestoreContextRegister();
+  target->Jump();
+  SetFrame(fall_through_frame, &non_frame_registers);
+  __ bind(&fall_through);
+}
+
+
 void CodeGenerator::VisitForStatement(ForStatement* node) {
   ASSERT(!in_spilled_code());
   Comment cmnt(masm_, "[ ForStatement");
@@ -4133,6 +4175,15 @@ void CodeGenerator::VisitForStatement(ForStatement* node) {
   ConditionAnalysis info = AnalyzeCondition(node->cond());
   if (info == ALWAYS_FALSE) return;
 
+  // Full code running the loop continues with the test.
+  GenerateOsrEntry(node);
+
+  // We know that the loop index is a smi if it is not modified in the
+  // loop body and it is checked against a constant limit in the loop
+  // condition.  That does not hold for values from full code running the
+  // loop.
+  bool is_fast_smi_loop = node->is_fast_smi_loop() && !IsOsrLoop(node);
+
   // Do not duplicate conditions that may have function literal
   // subexpressions.  This can cause us to compile the function literal
   // twice.
@@ -4212,12 +4263,10 @@ void CodeGenerator::VisitForStatement(ForStatement* node) {
 
   CheckStack();  // TODO(1222600): ignore if body contains calls.
 
-  // We know that the loop index is a smi if it is not modified in the
-  // loop body and it is checked against a constant limit in the loop
-  // condition.  In this case, we reset the static type information of the
-  // loop index to smi before compiling the body, the update expression, and
+  // In a fast smi loop, we reset the static type information of the loop
+  // index to smi before compiling the body, the update expression, and
   // the bottom check of the loop condition.
-  if (node->is_fast_smi_loop()) {
+  if (is_fast_smi_loop) {
     // Set number type of the loop variable to smi.
     SetTypeForStackSlot(node->loop_variable()->slot(), TypeInfo::Smi());
   }
@@ -4243,7 +4292,7 @@ void CodeGenerator::VisitForStatement(ForStatement* node) {
 
   // Set the type of the loop variable to smi before compiling the test
   // expression if we are in a fast smi loop condition.
-  if (node->is_fast_smi_loop() && has_valid_frame()) {
+  if (is_fast_smi_loop && has_valid_frame()) {
     // Set number type of the loop variable to smi.
     SetTypeForStackSlot(node->loop_variable()->slot(), TypeInfo::Smi());
   }
@@ -8581,9 +8630,11 @@ void CodeGenerator::Int32BinaryOperation(BinaryOperation* node) {
       }
       right.Unuse();
       frame_->Push(&left);
-      if (!node->to_int32()) {
-        // If ToInt32 is called on the result of ADD, SUB, or MUL, we don't
-        // care about overflows.
+      if (!node->to_int32() || op == Token::MUL) {
+        // If ToInt32 is called on the result of ADD or SUB, we don't care
+        // about overflows.  An overflowing product may not be exactly
+        // representable as a double, so its low 32 bits can differ from
+        // those of the double product.
         unsafe_bailout_->Branch(overflow);
       }
       break;
@@ -749,6 +749,12 @@ class CodeGenerator: public AstVisitor {
 
   void SetTypeForStackSlot(Slot* slot, TypeInfo info);
 
+  // On-stack replacement of full code running a loop (see
+  // --tiered-compilation).  The entry is emitted at the current position,
+  // or jumps to the given target of the loop.
+  bool IsOsrLoop(IterationStatement* node);
+  void GenerateOsrEntry(IterationStatement* node, JumpTarget* target = NULL);
+
 #ifdef DEBUG
   // True if the registers are valid for entry to a block.  There should
   // be no frame-external references to (non-reserved) registers.
@@ -61,6 +61,8 @@ void FullCodeGenerator::Generate(CompilationInfo* info) {
   SetFunctionPosition(function());
   Comment cmnt(masm_, "[ function compiled by full code generator");
 
+  EmitTierUpCheck();
+
   __ push(ebp);  // Caller's frame pointer.
   __ mov(ebp, esp);
   __ push(esi);  // Callee's context.
@@ -190,6 +192,60 @@ void FullCodeGenerator::Generate(CompilationInfo* info) {
 }
 
 
+void FullCodeGenerator::EmitTierUpCheck() {
+  if (!info_->has_tier_up_check()) return;
+  Comment cmnt(masm_, "[ Tier-up check");
+  // Call stubs embedding this code can still reach it after the function
+  // has been recompiled.  Continue in the current code of the function
+  // then, as frames find their code through the function.
+  Label current, ok;
+  __ mov(ecx, Immediate(masm_->CodeObject()));
+  __ lea(ecx, FieldOperand(ecx, Code::kHeaderSize));
+  __ cmp(ecx, FieldOperand(edi, JSFunction::kCodeEntryOffset));
+  __ j(equal, &current, taken);
+  __ jmp(FieldOperand(edi, JSFunction::kCodeEntryOffset));
+  __ bind(&current);
+
+  // Count the call and recompile the function once it gets hot.  The
+  // frame has not been built yet, so the recompiled code can be entered
+  // with a tail call.
+  __ mov(ecx, FieldOperand(edi, JSFunction::kSharedFunctionInfoOffset));
+  __ sub(FieldOperand(ecx, SharedFunctionInfo::kTierUpCounterOffset),
+         Immediate(Smi::FromInt(1)));
+  __ j(greater, &ok, taken);
+  __ jmp(Handle<Code>(Builtins::builtin(Builtins::LazyRecompile)),
+         RelocInfo::CODE_TARGET);
+  __ bind(&ok);
+}
+
+
+void FullCodeGenerator::EmitBackEdgeCheck(IterationStatement* stmt) {
+  if (!info_->has_tier_up_check()) return;
+  Comment cmnt(masm_, "[ Back edge check");
+  __ mov(ecx, Operand(ebp, JavaScriptFrameConstants::kFunctionOffset));
+  __ mov(ecx, FieldOperand(ecx, JSFunction::kSharedFunctionInfoOffset));
+  __ sub(FieldOperand(ecx, SharedFunctionInfo::kTierUpCounterOffset),
+         Immediate(Smi::FromInt(1)));
+  if (!FLAG_use_osr || !CanReplaceOnStack()) return;
+
+  // The function got hot in this loop.  Recompile it and continue the
+  // loop in the new code, which has the same frame layout.
+  Label ok;
+  __ j(greater, &ok, taken);
+  __ push(Operand(ebp, JavaScriptFrameConstants::kFunctionOffset));
+  __ push(Immediate(Smi::FromInt(stmt->statement_pos())));
+  __ CallRuntime(Runtime::kCompileForOnStackReplacement, 2);
+  // eax: smi offset of the loop entry in the new code, or zero.
+  __ test(eax, Operand(eax));
+  __ j(zero, &ok, taken);
+  __ SmiUntag(eax);
+  __ mov(ecx, Operand(ebp, JavaScriptFrameConstants::kFunctionOffset));
+  __ add(eax, FieldOperand(ecx, JSFunction::kCodeEntryOffset));
+  __ jmp(Operand(eax));
+  __ bind(&ok);
+}
+
+
 void FullCodeGenerator::EmitReturnSequence() {
   Comment cmnt(masm_, "[ Return sequence");
   if (return_label_.is_bound()) {
@@ -682,7 +738,7 @@ void FullCodeGenerator::VisitSwitchStatement(SwitchStatement* stmt) {
     __ jmp(clause->body_target()->entry_label());
 
     __ bind(&slow_case);
-    CompareStub stub(equal, true);
+    ICCompareStub stub(Token::EQ_STRICT, CompareIC::DEFAULT);
     __ CallStub(&stub);
     __ test(eax, Operand(eax));
     __ j(not_equal, &next_test);
@@ -3073,7 +3129,8 @@ void FullCodeGenerator::VisitCompareOperation(CompareOperation* expr) {
       __ jmp(if_false);
 
       __ bind(&slow_case);
-      CompareStub stub(cc, strict);
+      ICCompareStub stub(ICCompareStub::ComputeOperation(cc, strict),
+                         CompareIC::DEFAULT);
       __ CallStub(&stub);
       __ test(eax, Operand(eax));
       Split(cc, if_true, if_false, fall_through);
@@ -855,6 +855,25 @@ static Object* GenerateCheckPropertyCells(MacroAssembler* masm,
 }
 
 
+// Checks the map of the receiver against each of the maps and jumps to
+// the corresponding handler on a match. Falls through on a mismatch.
+static void GenerateMapDispatch(MacroAssembler* masm,
+                                Register receiver,
+                                Register scratch,
+                                List<Map*>* maps,
+                                List<Code*>* handlers,
+                                Label* miss) {
+  ASSERT(maps->length() == handlers->length());
+  __ test(receiver, Immediate(kSmiTagMask));
+  __ j(zero, miss, not_taken);
+  __ mov(scratch, FieldOperand(receiver, HeapObject::kMapOffset));
+  for (int i = 0; i < maps->length(); i++) {
+    __ cmp(Operand(scratch), Immediate(Handle<Map>(maps->at(i))));
+    __ j(equal, Handle<Code>(handlers->at(i)));
+  }
+}
+
+
 #undef __
 #define __ ACCESS_MASM(masm())
 
@@ -2003,6 +2022,36 @@ Object* CallStubCompiler::CompileCallGlobal(JSObject* object,
   return GetCode(NORMAL, name);
 }
 
+Object* CallStubCompiler::CompileCallPolymorphic(List<Map*>* maps,
+                                                 List<Code*>* handlers,
+                                                 String* name) {
+  // ----------- S t a t e -------------
+  //  -- ecx                 : name
+  //  -- esp[0]              : return address
+  //  -- esp[(argc - n) * 4] : arg[n] (zero-based)
+  //  -- ...
+  //  -- esp[(argc + 1) * 4] : receiver
+  // -----------------------------------
+  Label miss;
+
+  GenerateNameCheck(name, &miss);
+
+  // Get the receiver from the stack.
+  const int argc = arguments().immediate();
+  __ mov(edx, Operand(esp, (argc + 1) * kPointerSize));
+
+  GenerateMapDispatch(masm(), edx, ebx, maps, handlers, &miss);
+
+  // Handle call cache miss.
+  __ bind(&miss);
+  Object* obj = GenerateMissBranch();
+  if (obj->IsFailure()) return obj;
+
+  // Return the generated code.
+  return GetPolymorphicCode(name);
+}
+
+
 
 Object* StoreStubCompiler::CompileStoreField(JSObject* object,
                                              int index,
@@ -2169,6 +2218,29 @@ Object* StoreStubCompiler::CompileStoreGlobal(GlobalObject* object,
   return GetCode(NORMAL, name);
 }
 
+Object* StoreStubCompiler::CompileStorePolymorphic(List<Map*>* maps,
+                                                   List<Code*>* handlers,
+                                                   String* name) {
+  // ----------- S t a t e -------------
+  //  -- eax    : value
+  //  -- ecx    : name
+  //  -- edx    : receiver
+  //  -- esp[0] : return address
+  // -----------------------------------
+  Label miss;
+
+  GenerateMapDispatch(masm(), edx, ebx, maps, handlers, &miss);
+
+  // Handle store cache miss.
+  __ bind(&miss);
+  Handle<Code> ic(Builtins::builtin(Builtins::StoreIC_Miss));
+  __ jmp(ic, RelocInfo::CODE_TARGET);
+
+  // Return the generated code.
+  return GetPolymorphicCode(name);
+}
+
+
 
 Object* KeyedStoreStubCompiler::CompileStoreField(JSObject* object,
                                                   int index,
@@ -2398,6 +2470,26 @@ Object* LoadStubCompiler::CompileLoadGlobal(JSObject* object,
   return GetCode(NORMAL, name);
 }
 
+Object* LoadStubCompiler::CompileLoadPolymorphic(List<Map*>* maps,
+                                                 List<Code*>* handlers,
+                                                 String* name) {
+  // ----------- S t a t e -------------
+  //  -- eax    : receiver
+  //  -- ecx    : name
+  //  -- esp[0] : return address
+  // -----------------------------------
+  Label miss;
+
+  GenerateMapDispatch(masm(), eax, ebx, maps, handlers, &miss);
+
+  __ bind(&miss);
+  GenerateLoadMiss(masm(), Code::LOAD_IC);
+
+  // Return the generated code.
+  return GetPolymorphicCode(name);
+}
+
+
 
 Object* KeyedLoadStubCompiler::CompileLoadField(String* name,
                                                 JSObject* receiver,
@@ -2634,6 +2726,20 @@ Object* ConstructStubCompiler::CompileConstructStub(
   __ Assert(not_equal, "Function constructed by construct stub.");
 #endif
 
+  // Leave the allocation to the generic stub while the allocation site of the
+  // constructor collects feedback, or when it tenures the objects.
+  // edi: constructor
+  // ebx: initial map
+  Label allocate;
+  __ mov(ecx, FieldOperand(edi, JSFunction::kSharedFunctionInfoOffset));
+  __ mov(ecx, FieldOperand(ecx, SharedFunctionInfo::kAllocationSiteOffset));
+  __ cmp(ecx, Factory::undefined_value());
+  __ j(equal, &allocate);
+  __ cmp(FieldOperand(ecx, AllocationSite::kStateOffset),
+         Immediate(Smi::FromInt(AllocationSite::kPending)));
+  __ j(less, &generic_stub_call);
+  __ bind(&allocate);
+
   // Now allocate the JSObject on the heap by moving the new space allocation
   // top forward.
   // edi: constructor
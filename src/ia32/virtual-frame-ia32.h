@@ -464,6 +464,10 @@ class VirtualFrame: public ZoneObject {
   inline void SetTypeForLocalAt(int index, TypeInfo info);
   inline void SetTypeForParamAt(int index, TypeInfo info);
 
+  // Forget the type information of all (spilled) frame elements, e.g.
+  // when the frame may have been filled by other code.
+  inline void ForgetTypeInfo();
+
  private:
   static const int kLocal0Offset = JavaScriptFrameConstants::kLocal0Offset;
   static const int kFunctionOffset = JavaScriptFrameConstants::kFunctionOffset;
@@ -77,6 +77,7 @@ Code* IC::GetTargetAtAddress(Address address) {
 void IC::SetTargetAtAddress(Address address, Code* target) {
   ASSERT(target->is_inline_cache_stub());
   Assembler::set_target_address_at(address, target->instruction_start());
+  IncrementalMarking::RecordWriteOf(target);
 }
 
 
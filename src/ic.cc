@@ -30,6 +30,7 @@
 #include "accessors.h"
 #include "api.h"
 #include "arguments.h"
+#include "codegen.h"
 #include "execution.h"
 #include "ic-inl.h"
 #include "runtime.h"
@@ -45,6 +46,7 @@ static char TransitionMarkFromState(IC::State state) {
     case PREMONOMORPHIC: return 'P';
     case MONOMORPHIC: return '1';
     case MONOMORPHIC_PROTOTYPE_FAILURE: return '^';
+    case POLYMORPHIC: return 'p';
     case MEGAMORPHIC: return 'N';
 
     // We never see the debugger states here, because the state is
@@ -153,9 +155,114 @@ static bool HasNormalObjectsInPrototypeChain(LookupResult* lookup,
 }
 
 
+// Returns true if the monomorphic stub has been compiled for receivers
+// with the given map, i.e. it is held by the code cache of that map.
+// Stubs for nonexistent properties are shared between names and cached
+// under the empty string.
+static bool IsMonomorphicStubFor(Map* map, String* name, Code* code) {
+  return map->IndexInCodeCache(name, code) >= 0 ||
+      map->IndexInCodeCache(Heap::empty_string(), code) >= 0;
+}
+
+
+// Collects the receiver maps checked by a monomorphic or polymorphic
+// stub together with the monomorphic handler used for each of them. A
+// polymorphic stub embeds each map followed by the jump to its handler.
+// For a monomorphic stub the first embedded map is the receiver map it
+// checks; the stub itself is the handler. Returns false if the maps
+// cannot be determined.
+static bool CollectPolymorphicTargets(Code* target,
+                                      String* name,
+                                      List<Map*>* maps,
+                                      List<Code*>* handlers) {
+  if (target->ic_state() == MONOMORPHIC) {
+    if (Code::ExtractCacheHolderFromFlags(target->flags()) != OWN_MAP) {
+      return false;
+    }
+    int mode_mask = RelocInfo::ModeMask(RelocInfo::EMBEDDED_OBJECT);
+    for (RelocIterator it(target, mode_mask); !it.done(); it.next()) {
+      Object* object = it.rinfo()->target_object();
+      if (!object->IsMap()) continue;
+      Map* map = Map::cast(object);
+      if (!IsMonomorphicStubFor(map, name, target)) return false;
+      maps->Add(map);
+      handlers->Add(target);
+      return true;
+    }
+    return false;
+  }
+
+  ASSERT(target->ic_state() == POLYMORPHIC);
+  int mode_mask = RelocInfo::ModeMask(RelocInfo::EMBEDDED_OBJECT) |
+                  RelocInfo::kCodeTargetMask;
+  for (RelocIterator it(target, mode_mask); !it.done(); it.next()) {
+    RelocInfo* info = it.rinfo();
+    if (info->rmode() == RelocInfo::EMBEDDED_OBJECT) {
+      Object* object = info->target_object();
+      if (object->IsMap()) maps->Add(Map::cast(object));
+    } else if (handlers->length() < maps->length()) {
+      handlers->Add(Code::GetCodeFromTargetAddress(info->target_address()));
+    }
+  }
+  ASSERT(maps->length() == handlers->length());
+  return true;
+}
+
+
+// Computes the maps and handlers of a polymorphic stub that extends the
+// current target with a handler for receivers with the given map. An
+// existing entry for the map is replaced. Returns false if the stub would
+// check a single map or more than --max-polymorphism maps, if it would
+// not change, or if the handlers are not specific to their receiver maps.
+static bool ComputePolymorphicTargets(Code* target,
+                                      String* name,
+                                      Map* map,
+                                      Code* handler,
+                                      List<Map*>* maps,
+                                      List<Code*>* handlers) {
+  if (!IsMonomorphicStubFor(map, name, handler)) return false;
+  if (!CollectPolymorphicTargets(target, name, maps, handlers)) return false;
+  for (int i = 0; i < maps->length(); i++) {
+    if (maps->at(i) == map) {
+      if (handlers->at(i) == handler) return false;
+      handlers->at(i) = handler;
+      return maps->length() > 1;
+    }
+  }
+  maps->Add(map);
+  handlers->Add(handler);
+  return maps->length() <= FLAG_max_polymorphism;
+}
+
+
 IC::State IC::StateFrom(Code* target, Object* receiver, Object* name) {
   IC::State state = target->ic_state();
 
+  if (state == POLYMORPHIC) {
+    if (!receiver->IsJSObject() || !name->IsString()) return state;
+
+    // If the receiver map is checked by the stub, its handler failed.
+    // As in the monomorphic case below, this is most likely due to a
+    // prototype change, so remove the handler from the code cache to
+    // have it recompiled.
+    Map* map = JSObject::cast(receiver)->map();
+    List<Map*> maps;
+    List<Code*> handlers;
+    CollectPolymorphicTargets(target, String::cast(name), &maps, &handlers);
+    for (int i = 0; i < maps.length(); i++) {
+      if (maps[i] != map) continue;
+      int index = map->IndexInCodeCache(name, handlers[i]);
+      if (index >= 0) {
+        map->RemoveFromCodeCache(String::cast(name), handlers[i], index);
+      }
+      index = map->IndexInCodeCache(Heap::empty_string(), handlers[i]);
+      if (index >= 0) {
+        map->RemoveFromCodeCache(Heap::empty_string(), handlers[i], index);
+      }
+    }
+    return state;
+  }
+
   if (state != MONOMORPHIC) return state;
   if (receiver->IsUndefined() || receiver->IsNull()) return state;
 
@@ -261,6 +368,7 @@ void IC::Clear(Address address) {
     case Code::KEYED_CALL_IC:  return KeyedCallIC::Clear(address, target);
     case Code::BINARY_OP_IC: return;  // Clearing these is tricky and does not
                                       // make any performance difference.
+    case Code::COMPARE_IC: return;  // Like binary op ICs, keep the feedback.
     default: UNREACHABLE();
   }
 }
@@ -581,7 +689,7 @@ void CallICBase::UpdateCaches(LookupResult* lookup,
     // Set the target to the pre monomorphic stub to delay
     // setting the monomorphic state.
     code = StubCache::ComputeCallPreMonomorphic(argc, in_loop, kind_);
-  } else if (state == MONOMORPHIC) {
+  } else if (state == MONOMORPHIC && kind_ != Code::CALL_IC) {
     code = StubCache::ComputeCallMegamorphic(argc, in_loop, kind_);
   } else {
     // Compute monomorphic stub.
@@ -664,8 +772,30 @@ void CallICBase::UpdateCaches(LookupResult* lookup,
   // Patch the call site depending on the state of the cache.
   if (state == UNINITIALIZED ||
       state == PREMONOMORPHIC ||
-      state == MONOMORPHIC ||
-      state == MONOMORPHIC_PROTOTYPE_FAILURE) {
+      state == MONOMORPHIC_PROTOTYPE_FAILURE ||
+      (state == MONOMORPHIC && kind_ != Code::CALL_IC)) {
+    set_target(Code::cast(code));
+  } else if (state == MONOMORPHIC || state == POLYMORPHIC) {
+    // Check a few receiver maps inline before going megamorphic.
+    List<Map*> maps;
+    List<Code*> handlers;
+    if (object->IsJSObject() &&
+        ComputePolymorphicTargets(target(),
+                                  *name,
+                                  JSObject::cast(*object)->map(),
+                                  Code::cast(code),
+                                  &maps,
+                                  &handlers)) {
+      code = StubCache::ComputeCallPolymorphic(argc,
+                                               in_loop,
+                                               kind_,
+                                               *name,
+                                               &maps,
+                                               &handlers);
+    } else {
+      code = StubCache::ComputeCallMegamorphic(argc, in_loop, kind_);
+    }
+    if (code->IsFailure()) return;
     set_target(Code::cast(code));
   } else if (state == MEGAMORPHIC) {
     // Cache code holding map should be consistent with
@@ -745,6 +875,7 @@ Object* LoadIC::Load(State state, Handle<Object> object, Handle<String> name) {
       Map* map = HeapObject::cast(*object)->map();
       if (object->IsString()) {
         const int offset = String::kLengthOffset;
+        IncrementalMarking::RecordWriteOf(map);
         PatchInlinedLoad(address(), map, offset);
       }
 
@@ -761,6 +892,7 @@ Object* LoadIC::Load(State state, Handle<Object> object, Handle<String> name) {
 #endif
       Map* map = HeapObject::cast(*object)->map();
       const int offset = JSArray::kLengthOffset;
+      IncrementalMarking::RecordWriteOf(map);
       PatchInlinedLoad(address(), map, offset);
 
       Code* target = Builtins::builtin(Builtins::LoadIC_ArrayLength);
@@ -814,8 +946,11 @@ Object* LoadIC::Load(State state, Handle<Object> object, Handle<String> name) {
     if (index < 0) {
       // Index is an offset from the end of the object.
       int offset = map->instance_size() + (index * kPointerSize);
+      IncrementalMarking::RecordWriteOf(map);
       if (PatchInlinedLoad(address(), map, offset)) {
-        set_target(megamorphic_stub());
+        // Receivers with other maps fail the inlined check and end up
+        // in the stub, so let it go polymorphic from here.
+        UpdateCaches(&lookup, state, object, name);
 #ifdef DEBUG
         if (FLAG_trace_ic) {
           PrintF("[LoadIC : inline patch %s]\n", *name->ToCString());
@@ -955,8 +1090,22 @@ void LoadIC::UpdateCaches(LookupResult* lookup,
   if (state == UNINITIALIZED || state == PREMONOMORPHIC ||
       state == MONOMORPHIC_PROTOTYPE_FAILURE) {
     set_target(Code::cast(code));
-  } else if (state == MONOMORPHIC) {
-    set_target(megamorphic_stub());
+  } else if (state == MONOMORPHIC || state == POLYMORPHIC) {
+    // Check a few receiver maps inline before going megamorphic.
+    List<Map*> maps;
+    List<Code*> handlers;
+    if (ComputePolymorphicTargets(target(),
+                                  *name,
+                                  receiver->map(),
+                                  Code::cast(code),
+                                  &maps,
+                                  &handlers)) {
+      code = StubCache::ComputeLoadPolymorphic(*name, &maps, &handlers);
+      if (code->IsFailure()) return;
+      set_target(Code::cast(code));
+    } else {
+      set_target(megamorphic_stub());
+    }
   } else if (state == MEGAMORPHIC) {
     // Cache code holding map should be consistent with
     // GenerateMonomorphicCacheProbe.
@@ -1092,6 +1241,7 @@ Object* KeyedLoadIC::Load(State state,
         !JSObject::cast(*object)->HasIndexedInterceptor() &&
         JSObject::cast(*object)->HasFastElements()) {
       Map* map = JSObject::cast(*object)->map();
+      IncrementalMarking::RecordWriteOf(map);
       PatchInlinedLoad(address(), map);
     }
   }
@@ -1263,8 +1413,11 @@ Object* StoreIC::Store(State state,
         if (index < 0) {
           // Index is an offset from the end of the object.
           int offset = map->instance_size() + (index * kPointerSize);
+          IncrementalMarking::RecordWriteOf(map);
           if (PatchInlinedStore(address(), map, offset)) {
-            set_target(megamorphic_stub());
+            // Receivers with other maps fail the inlined check and end
+            // up in the stub, so let it go polymorphic from here.
+            UpdateCaches(&lookup, state, receiver, name, value);
 #ifdef DEBUG
             if (FLAG_trace_ic) {
               PrintF("[StoreIC : inline patch %s]\n", *name->ToCString());
@@ -1378,9 +1531,25 @@ void StoreIC::UpdateCaches(LookupResult* lookup,
   // Patch the call site depending on the state of the cache.
   if (state == UNINITIALIZED || state == MONOMORPHIC_PROTOTYPE_FAILURE) {
     set_target(Code::cast(code));
-  } else if (state == MONOMORPHIC) {
-    // Only move to megamorphic if the target changes.
-    if (target() != Code::cast(code)) set_target(megamorphic_stub());
+  } else if (state == MONOMORPHIC || state == POLYMORPHIC) {
+    // Only move on if the target changes. Check a few receiver maps
+    // inline before going megamorphic.
+    if (target() != Code::cast(code)) {
+      List<Map*> maps;
+      List<Code*> handlers;
+      if (ComputePolymorphicTargets(target(),
+                                    *name,
+                                    receiver->map(),
+                                    Code::cast(code),
+                                    &maps,
+                                    &handlers)) {
+        code = StubCache::ComputeStorePolymorphic(*name, &maps, &handlers);
+        if (code->IsFailure()) return;
+        set_target(Code::cast(code));
+      } else {
+        set_target(megamorphic_stub());
+      }
+    }
   } else if (state == MEGAMORPHIC) {
     // Update the stub cache.
     StubCache::Set(*name, receiver->map(), Code::cast(code));
@@ -1811,6 +1980,85 @@ Object* BinaryOp_Patch(Arguments args) {
 }
 
 
+const char* CompareIC::GetName(TypeInfo type_info) {
+  switch (type_info) {
+    case DEFAULT: return "Default";
+    case HEAP_NUMBERS: return "HeapNumbers";
+    case SYMBOLS: return "Symbols";
+    case STRINGS: return "Strings";
+    case OBJECTS: return "Objects";
+    case GENERIC: return "Generic";
+    default: return "Invalid";
+  }
+}
+
+
+CompareIC::State CompareIC::ToState(TypeInfo type_info) {
+  switch (type_info) {
+    case DEFAULT: return UNINITIALIZED;
+    case GENERIC: return MEGAMORPHIC;
+    default: return MONOMORPHIC;
+  }
+}
+
+
+static bool IsFlatAsciiString(Object* object) {
+  if (!object->IsString()) return false;
+  return StringShape(String::cast(object)).IsSequentialAscii();
+}
+
+
+CompareIC::TypeInfo CompareIC::TargetTypeInfo(TypeInfo previous,
+                                              Object* left,
+                                              Object* right) {
+  // A specialized stub that misses goes generic, except that symbol
+  // equality widens to string comparison when a non-symbol string shows up.
+  if (previous == SYMBOLS &&
+      IsFlatAsciiString(left) &&
+      IsFlatAsciiString(right)) {
+    return STRINGS;
+  }
+  if (previous != DEFAULT) return GENERIC;
+
+  if (left->IsNumber() && right->IsNumber()) return HEAP_NUMBERS;
+  if (left->IsSymbol() && right->IsSymbol() && is_equality()) return SYMBOLS;
+  if (IsFlatAsciiString(left) && IsFlatAsciiString(right)) return STRINGS;
+  if (left->IsJSObject() && right->IsJSObject() && is_equality()) {
+    return OBJECTS;
+  }
+  return GENERIC;
+}
+
+
+Code* CompareIC::UpdateCaches(TypeInfo previous, Object* left, Object* right) {
+  HandleScope scope;
+  TypeInfo type_info =
+      FLAG_use_ic ? TargetTypeInfo(previous, left, right) : GENERIC;
+  Handle<Code> code = ICCompareStub(op_, type_info).GetCode();
+  set_target(*code);
+#ifdef DEBUG
+  if (FLAG_trace_ic) {
+    PrintF("[CompareIC (%s->%s)#%s]\n",
+           GetName(previous),
+           GetName(type_info),
+           Token::Name(op_));
+  }
+#endif
+  return *code;
+}
+
+
+// Used from ICCompareStub::GenerateMiss in code-stubs-<arch>.cc.
+Object* CompareIC_Miss(Arguments args) {
+  ASSERT(args.length() == 4);
+  Token::Value op = static_cast<Token::Value>(Smi::cast(args[2])->value());
+  CompareIC::TypeInfo previous =
+      static_cast<CompareIC::TypeInfo>(Smi::cast(args[3])->value());
+  CompareIC ic(op);
+  return ic.UpdateCaches(previous, args[0], args[1]);
+}
+
+
 static Address IC_utilities[] = {
 #define ADDR(name) FUNCTION_ADDR(name),
     IC_UTIL_LIST(ADDR)
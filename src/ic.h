@@ -53,7 +53,8 @@ namespace internal {
   ICU(LoadPropertyWithInterceptorForCall)             \
   ICU(KeyedLoadPropertyWithInterceptor)               \
   ICU(StoreInterceptorProperty)                       \
-  ICU(BinaryOp_Patch)
+  ICU(BinaryOp_Patch)                                 \
+  ICU(CompareIC_Miss)
 
 //
 // IC is the base class for LoadIC, StoreIC, CallIC, KeyedLoadIC,
@@ -510,6 +511,40 @@ class BinaryOpIC: public IC {
   static TypeInfo GetTypeInfo(Object* left, Object* right);
 };
 
+
+class CompareIC: public IC {
+ public:
+
+  enum TypeInfo {
+    DEFAULT,  // Initial state. When first executed, patches to one
+              // of the following states depending on the operands types.
+    HEAP_NUMBERS,  // Both arguments are smis or HeapNumbers.
+    SYMBOLS,  // Both arguments are symbols (equality only).
+    STRINGS,  // Both arguments are flat ascii strings.
+    OBJECTS,  // Both arguments are JSObjects (equality only).
+    GENERIC   // Non-specialized case (processes any type combination).
+  };
+
+  explicit CompareIC(Token::Value op) : IC(EXTRA_CALL_FRAME), op_(op) { }
+
+  // Patch the call site to a stub specialized for the given operands. The
+  // previous type info is the one of the stub that missed.
+  Code* UpdateCaches(TypeInfo previous, Object* left, Object* right);
+
+  static const char* GetName(TypeInfo type_info);
+
+  static State ToState(TypeInfo type_info);
+
+ private:
+  TypeInfo TargetTypeInfo(TypeInfo previous, Object* left, Object* right);
+
+  bool is_equality() {
+    return op_ == Token::EQ || op_ == Token::EQ_STRICT;
+  }
+
+  Token::Value op_;
+};
+
 } }  // namespace v8::internal
 
 #endif  // V8_IC_H_
@@ -0,0 +1,444 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "v8.h"
+
+#include "hashmap.h"
+#include "incremental-marking.h"
+#include "mark-compact.h"
+
+namespace v8 {
+namespace internal {
+
+IncrementalMarking::State IncrementalMarking::state_ = STOPPED;
+
+// Mark bitmaps indexed by memory chunk id.  The bitmap of a chunk has one
+// bit for each pointer-aligned address in the chunk and is allocated when
+// the first object in the chunk is marked.
+static uint32_t** chunk_marks = NULL;
+
+// Large objects do not live in chunks owned by the memory allocator, so
+// they are marked by adding their address to this set.
+static HashMap* large_object_marks = NULL;
+
+// Marked objects whose children have not been marked yet.
+static List<HeapObject*>* marking_deque = NULL;
+
+// Objects allocated in the old generation since the last step, and the
+// number of bytes they occupy.
+static List<HeapObject*>* allocated_objects = NULL;
+static intptr_t allocated_bytes = 0;
+
+// Objects in the new space that are referenced from marked objects.  Only
+// collected by Finalize(), when no scavenge can move them any more.
+static List<HeapObject*>* new_space_targets = NULL;
+static bool record_new_space_targets = false;
+
+static const int kInitialDequeCapacity = 1024;
+
+
+static bool AddressMatch(void* key1, void* key2) {
+  return key1 == key2;
+}
+
+
+static uint32_t AddressHash(Address address) {
+  return ComputeIntegerHash(
+      static_cast<uint32_t>(OffsetFrom(address) >> kPageSizeBits));
+}
+
+
+class IncrementalMarkingVisitor : public ObjectVisitor {
+ public:
+  void VisitPointer(Object** p) {
+    MarkObjectByPointer(p);
+  }
+
+  void VisitPointers(Object** start, Object** end) {
+    for (Object** p = start; p < end; p++) MarkObjectByPointer(p);
+  }
+
+ private:
+  void MarkObjectByPointer(Object** p) {
+    if (!(*p)->IsHeapObject()) return;
+    IncrementalMarking::MarkObject(HeapObject::cast(*p));
+  }
+};
+
+
+void IncrementalMarking::Start() {
+  ASSERT(state_ == STOPPED);
+  if (chunk_marks == NULL) {
+    chunk_marks = NewArray<uint32_t*>(MemoryAllocator::kMaxNofChunks);
+    for (int i = 0; i < MemoryAllocator::kMaxNofChunks; i++) {
+      chunk_marks[i] = NULL;
+    }
+    large_object_marks = new HashMap(&AddressMatch);
+    marking_deque = new List<HeapObject*>(kInitialDequeCapacity);
+    allocated_objects = new List<HeapObject*>(kInitialDequeCapacity);
+    new_space_targets = new List<HeapObject*>(kInitialDequeCapacity);
+  }
+  state_ = MARKING;
+  allocated_bytes = 0;
+
+  // The roots are scanned again in the atomic pause, so it does not matter
+  // that they change while marking is in progress.  The symbol table is
+  // not a strong root; it is handled by the mark-compact collector.
+  IncrementalMarkingVisitor visitor;
+  Heap::IterateStrongRoots(&visitor, VISIT_ONLY_STRONG);
+}
+
+
+void IncrementalMarking::Step(intptr_t allocated_bytes_in_new_space) {
+  if (!IsMarking()) return;
+  MarkAllocatedObjects();
+
+  intptr_t bytes_to_visit =
+      (allocated_bytes_in_new_space + allocated_bytes) *
+      FLAG_incremental_marking_speed;
+  allocated_bytes = 0;
+  while (bytes_to_visit > 0 && !marking_deque->is_empty()) {
+    bytes_to_visit -= VisitObject(marking_deque->RemoveLast());
+  }
+  state_ = marking_deque->is_empty() ? COMPLETE : MARKING;
+}
+
+
+void IncrementalMarking::Finalize() {
+  ASSERT(IsMarking());
+  new_space_targets->Rewind(0);
+  record_new_space_targets = true;
+
+  MarkAllocatedObjects();
+
+  // Every pointer into the new space and every pointer written since
+  // marking started lies in a dirty region of the old pointer space, the
+  // map space or the large object space.
+  VisitDirtyObjects(Heap::old_pointer_space());
+  VisitDirtyObjects(Heap::map_space());
+  VisitDirtyLargeObjects();
+  VisitMarkedCells();
+
+  while (!marking_deque->is_empty()) {
+    VisitObject(marking_deque->RemoveLast());
+  }
+
+  record_new_space_targets = false;
+  state_ = FINALIZING;
+}
+
+
+void IncrementalMarking::TransferMarks() {
+  ASSERT(state_ == FINALIZING);
+  // All marks are transferred before the collector marks anything, so that
+  // it never finds an object whose mark has not been transferred yet.
+  IterateMarkedObjects(&TransferMark);
+  IterateMarkedObjects(&MarkMapAndBackPointer);
+
+  for (int i = 0; i < new_space_targets->length(); i++) {
+    MarkCompactCollector::MarkObject(new_space_targets->at(i));
+  }
+}
+
+
+void IncrementalMarking::IterateMarkedObjects(MarkedObjectCallback callback) {
+  for (int chunk_id = 0;
+       chunk_id < MemoryAllocator::kMaxNofChunks;
+       chunk_id++) {
+    uint32_t* bitmap = chunk_marks[chunk_id];
+    if (bitmap == NULL) continue;
+    Address chunk_start = ChunkStart(chunk_id);
+    int length = BitmapLength(chunk_id);
+    for (int i = 0; i < length; i++) {
+      uint32_t cell = bitmap[i];
+      for (int bit = 0; cell != 0; bit++, cell >>= 1) {
+        if ((cell & 1) == 0) continue;
+        int index = i * kBitsPerInt + bit;
+        callback(HeapObject::FromAddress(
+            chunk_start + (index << kPointerSizeLog2)));
+      }
+    }
+  }
+
+  for (HashMap::Entry* entry = large_object_marks->Start();
+       entry != NULL;
+       entry = large_object_marks->Next(entry)) {
+    callback(HeapObject::FromAddress(static_cast<Address>(entry->key)));
+  }
+}
+
+
+void IncrementalMarking::TransferMark(HeapObject* object) {
+  ASSERT(!object->IsMarked());
+  MarkCompactCollector::SetMark(object);
+}
+
+
+void IncrementalMarking::MarkMapAndBackPointer(HeapObject* object) {
+  MapWord map_word = object->map_word();
+  map_word.ClearMark();
+  Map* map = map_word.ToMap();
+  // Objects can change their map without a write barrier, so the map of a
+  // marked object is not necessarily marked.
+  MarkCompactCollector::MarkObject(map);
+  // The collector has replaced the prototypes of maps with back pointers
+  // to their parent maps, which must be live when the map is live.
+  if (FLAG_collect_maps && map->instance_type() == MAP_TYPE) {
+    Map* object_map = reinterpret_cast<Map*>(object);
+    if (object_map->instance_type() >= FIRST_JS_OBJECT_TYPE &&
+        object_map->instance_type() <= JS_FUNCTION_TYPE) {
+      Object* back_pointer =
+          *HeapObject::RawField(object_map, Map::kPrototypeOffset);
+      if (back_pointer->IsHeapObject()) {
+        MarkCompactCollector::MarkObject(HeapObject::cast(back_pointer));
+      }
+    }
+  }
+}
+
+
+void IncrementalMarking::Stop() {
+  if (state_ == STOPPED) return;
+  for (int i = 0; i < MemoryAllocator::kMaxNofChunks; i++) {
+    DeleteArray(chunk_marks[i]);
+    chunk_marks[i] = NULL;
+  }
+  large_object_marks->Clear();
+  marking_deque->Clear();
+  allocated_objects->Clear();
+  new_space_targets->Clear();
+  allocated_bytes = 0;
+  state_ = STOPPED;
+}
+
+
+void IncrementalMarking::TearDown() {
+  if (chunk_marks == NULL) return;
+  Stop();
+  DeleteArray(chunk_marks);
+  chunk_marks = NULL;
+  delete large_object_marks;
+  large_object_marks = NULL;
+  delete marking_deque;
+  marking_deque = NULL;
+  delete allocated_objects;
+  allocated_objects = NULL;
+  delete new_space_targets;
+  new_space_targets = NULL;
+}
+
+
+void IncrementalMarking::RecordAllocationSlow(HeapObject* object, int size) {
+  allocated_objects->Add(object);
+  allocated_bytes += size;
+}
+
+
+void IncrementalMarking::RecordWriteOfSlow(Object* value) {
+  if (value->IsHeapObject()) MarkObject(HeapObject::cast(value));
+}
+
+
+bool IncrementalMarking::IsMarked(HeapObject* object) {
+  Address address = object->address();
+  Page* page = Page::FromAddress(address);
+  if (page->IsLargeObjectPage()) {
+    return large_object_marks->Lookup(address, AddressHash(address), false)
+        != NULL;
+  }
+  int chunk_id = MemoryAllocator::GetChunkId(page);
+  uint32_t* bitmap = chunk_marks[chunk_id];
+  if (bitmap == NULL) return false;
+  int index = static_cast<int>(
+      (address - ChunkStart(chunk_id)) >> kPointerSizeLog2);
+  return (bitmap[index / kBitsPerInt] & (1 << (index % kBitsPerInt))) != 0;
+}
+
+
+bool IncrementalMarking::SetMark(HeapObject* object) {
+  Address address = object->address();
+  Page* page = Page::FromAddress(address);
+  if (page->IsLargeObjectPage()) {
+    HashMap::Entry* entry =
+        large_object_marks->Lookup(address, AddressHash(address), true);
+    if (entry->value != NULL) return false;
+    entry->value = object;
+    return true;
+  }
+  int chunk_id = MemoryAllocator::GetChunkId(page);
+  uint32_t* bitmap = chunk_marks[chunk_id];
+  if (bitmap == NULL) {
+    int length = BitmapLength(chunk_id);
+    bitmap = NewArray<uint32_t>(length);
+    memset(bitmap, 0, length * sizeof(uint32_t));
+    chunk_marks[chunk_id] = bitmap;
+  }
+  int index = static_cast<int>(
+      (address - ChunkStart(chunk_id)) >> kPointerSizeLog2);
+  uint32_t mask = 1 << (index % kBitsPerInt);
+  uint32_t* cell = &bitmap[index / kBitsPerInt];
+  if ((*cell & mask) != 0) return false;
+  *cell |= mask;
+  return true;
+}
+
+
+void IncrementalMarking::MarkObject(HeapObject* object) {
+  if (Heap::InNewSpace(object)) {
+    if (record_new_space_targets) new_space_targets->Add(object);
+    return;
+  }
+  // The symbol table is weak and is marked by
+  // MarkCompactCollector::MarkSymbolTable.  A grown table is recorded as an
+  // allocated object.
+  if (object == Heap::raw_unchecked_symbol_table()) return;
+  if (SetMark(object)) marking_deque->Add(object);
+}
+
+
+int IncrementalMarking::VisitObject(HeapObject* object) {
+  Map* map = object->map();
+  MarkObject(map);
+  int size = object->SizeFromMap(map);
+  if (map->instance_type() == MAP_TYPE) {
+    Map* object_map = reinterpret_cast<Map*>(object);
+    if (FLAG_cleanup_caches_in_maps_at_gc) {
+      object_map->ClearCodeCache();
+    }
+    if (FLAG_collect_maps &&
+        object_map->instance_type() >= FIRST_JS_OBJECT_TYPE &&
+        object_map->instance_type() <= JS_FUNCTION_TYPE) {
+      MarkMapContents(object_map);
+      return size;
+    }
+  }
+  IncrementalMarkingVisitor visitor;
+  object->IterateBody(map->instance_type(), size, &visitor);
+  return size;
+}
+
+
+// Same as MarkCompactCollector::MarkMapContents.
+void IncrementalMarking::MarkMapContents(Map* map) {
+  MarkDescriptorArray(reinterpret_cast<DescriptorArray*>(
+      *HeapObject::RawField(map, Map::kInstanceDescriptorsOffset)));
+  IncrementalMarkingVisitor visitor;
+  visitor.VisitPointers(HeapObject::RawField(map,
+                                             Map::kPointerFieldsBeginOffset),
+                        HeapObject::RawField(map,
+                                             Map::kPointerFieldsEndOffset));
+}
+
+
+// Same as MarkCompactCollector::MarkDescriptorArray.  Transitions are not
+// marked through.  Arrays in the new space are left to the mark-compact
+// collector, which marks through them completely.
+void IncrementalMarking::MarkDescriptorArray(DescriptorArray* descriptors) {
+  if (descriptors->IsEmpty() || Heap::InNewSpace(descriptors)) {
+    MarkObject(descriptors);
+    return;
+  }
+  if (!SetMark(descriptors)) return;
+  FixedArray* contents = FixedArray::cast(
+      descriptors->get(DescriptorArray::kContentArrayIndex));
+  if (Heap::InNewSpace(contents)) {
+    marking_deque->Add(descriptors);
+    return;
+  }
+  SetMark(contents);
+  for (int i = 0; i < contents->length(); i += 2) {
+    PropertyDetails details(Smi::cast(contents->get(i + 1)));
+    if (details.type() < FIRST_PHANTOM_PROPERTY_TYPE) {
+      Object* value = contents->get(i);
+      if (value->IsHeapObject()) MarkObject(HeapObject::cast(value));
+    }
+  }
+  marking_deque->Add(descriptors);
+}
+
+
+void IncrementalMarking::MarkAllocatedObjects() {
+  for (int i = 0; i < allocated_objects->length(); i++) {
+    MarkObject(allocated_objects->at(i));
+  }
+  allocated_objects->Rewind(0);
+}
+
+
+void IncrementalMarking::VisitDirtyObjects(PagedSpace* space) {
+  PageIterator it(space, PageIterator::PAGES_IN_USE);
+  while (it.has_next()) {
+    Page* page = it.next();
+    uint32_t marks = page->GetRegionMarks();
+    if (marks == Page::kAllRegionsCleanMarks) continue;
+    Address limit = page->AllocationTop();
+    Address current = page->ObjectAreaStart();
+    while (current < limit) {
+      HeapObject* object = HeapObject::FromAddress(current);
+      int size = object->Size();
+      if ((marks & page->GetRegionMaskForSpan(current, size)) != 0 &&
+          IsMarked(object)) {
+        VisitObject(object);
+      }
+      current += size;
+    }
+  }
+}
+
+
+void IncrementalMarking::VisitDirtyLargeObjects() {
+  LargeObjectIterator it(Heap::lo_space());
+  for (HeapObject* object = it.next(); object != NULL; object = it.next()) {
+    Page* page = Page::FromAddress(object->address());
+    if (page->GetRegionMarks() != Page::kAllRegionsCleanMarks &&
+        IsMarked(object)) {
+      VisitObject(object);
+    }
+  }
+}
+
+
+void IncrementalMarking::VisitMarkedCells() {
+  HeapObjectIterator it(Heap::cell_space());
+  for (HeapObject* object = it.next(); object != NULL; object = it.next()) {
+    if (IsMarked(object)) VisitObject(object);
+  }
+}
+
+
+Address IncrementalMarking::ChunkStart(int chunk_id) {
+  return MemoryAllocator::chunks_[chunk_id].address();
+}
+
+
+int IncrementalMarking::BitmapLength(int chunk_id) {
+  size_t bits = MemoryAllocator::chunks_[chunk_id].size() >> kPointerSizeLog2;
+  return static_cast<int>(bits / kBitsPerInt) + 1;
+}
+
+} }  // namespace v8::internal
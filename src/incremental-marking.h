@@ -0,0 +1,160 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef V8_INCREMENTAL_MARKING_H_
+#define V8_INCREMENTAL_MARKING_H_
+
+namespace v8 {
+namespace internal {
+
+class PagedSpace;
+
+// -------------------------------------------------------------------------
+// Incremental marking
+//
+// With --incremental-marking the live objects of the old generation are
+// marked in small steps that are taken at the end of scavenges, so that the
+// following mark-compact collection only has to finish the job.
+//
+// Marking state is kept in side bitmaps (one bit per word of each memory
+// chunk) rather than in map words, so the mutator keeps running on an
+// unmodified heap.  Objects in the new space are never marked incrementally.
+// Mutations are tracked through the existing write barrier: while marking
+// is in progress the scavenger keeps region dirty marks set instead of
+// clearing them, so at the end every marked object that was written to, and
+// every marked object that points into the new space, lies in a dirty
+// region and is visited again.  Objects allocated in the old generation
+// while marking are treated as live and are visited at the next step.
+// Writes that bypass the write barrier (code patching and stores of objects
+// that are never in the new space) call RecordWriteOf().
+//
+// When a full collection starts, Finalize() revisits the dirty regions and
+// empties the marking deque.  MarkCompactCollector then transfers the side
+// bitmaps to the map word mark bits and continues with the roots, which are
+// always scanned again in the atomic pause.  Code is not flushed in that
+// collection.
+class IncrementalMarking : public AllStatic {
+ public:
+  enum State {
+    STOPPED,     // No marking in progress.
+    MARKING,     // Marking steps are taken at the end of scavenges.
+    COMPLETE,    // The marking deque is empty; a full GC should follow.
+    FINALIZING   // The full GC is transferring the marks.
+  };
+
+  // True while the mutator is running between marking steps.
+  static bool IsMarking() { return state_ == MARKING || state_ == COMPLETE; }
+
+  // True when all objects reachable from the roots at the start of marking
+  // are marked.
+  static bool IsComplete() { return state_ == COMPLETE; }
+
+  // True during a full GC that finishes an incremental marking cycle.
+  static bool IsFinalizing() { return state_ == FINALIZING; }
+
+  // Start a marking cycle by marking the strong roots.  Must be called
+  // when the heap is iterable, i.e. during a GC.
+  static void Start();
+
+  // Visit marked objects until roughly
+  // (allocated_bytes * --incremental-marking-speed) bytes have been
+  // visited.  Must be called during a GC.
+  static void Step(intptr_t allocated_bytes);
+
+  // Called at the start of a full GC while marking is in progress.
+  // Visits the marked objects in dirty regions and the objects left on
+  // the marking deque.
+  static void Finalize();
+
+  // Called by the mark-compact collector when its marking stack is set
+  // up.  Sets the map word mark bit of every incrementally marked object
+  // and marks the objects in the new space that are referenced from them.
+  static void TransferMarks();
+
+  // Discard the marking state.
+  static void Stop();
+
+  static void TearDown();
+
+  // Called when an object is allocated in a paged space or in the large
+  // object space.
+  static inline void RecordAllocation(HeapObject* object, int size) {
+    if (IsMarking()) RecordAllocationSlow(object, size);
+  }
+
+  // Called when a pointer to the value is written without going through
+  // the write barrier.
+  static inline void RecordWriteOf(Object* value) {
+    if (IsMarking()) RecordWriteOfSlow(value);
+  }
+
+ private:
+  static void RecordAllocationSlow(HeapObject* object, int size);
+  static void RecordWriteOfSlow(Object* value);
+
+  // Accessors for the side mark bits.  SetMark returns false if the object
+  // was already marked.
+  static bool IsMarked(HeapObject* object);
+  static bool SetMark(HeapObject* object);
+
+  // Mark an object and push it on the marking deque.  Objects in the new
+  // space are only recorded, during Finalize().
+  static void MarkObject(HeapObject* object);
+
+  // Mark the children of a marked object.  Returns the size of the object.
+  // Maps are treated like in MarkCompactCollector.
+  static int VisitObject(HeapObject* object);
+  static void MarkMapContents(Map* map);
+  static void MarkDescriptorArray(DescriptorArray* descriptors);
+
+  // Mark the objects allocated in the old generation since the last step.
+  static void MarkAllocatedObjects();
+
+  // Visit the marked objects that overlap a dirty region.  Cells are not
+  // covered by dirty marks, so all marked cells are visited.
+  static void VisitDirtyObjects(PagedSpace* space);
+  static void VisitDirtyLargeObjects();
+  static void VisitMarkedCells();
+
+  typedef void (*MarkedObjectCallback)(HeapObject* object);
+  static void IterateMarkedObjects(MarkedObjectCallback callback);
+  static void TransferMark(HeapObject* object);
+  static void MarkMapAndBackPointer(HeapObject* object);
+
+  // Address of the mark bitmap of a memory chunk and its length in words.
+  static Address ChunkStart(int chunk_id);
+  static int BitmapLength(int chunk_id);
+
+  static State state_;
+
+  friend class IncrementalMarkingVisitor;
+};
+
+} }  // namespace v8::internal
+
+#endif  // V8_INCREMENTAL_MARKING_H_
@@ -0,0 +1,474 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "v8.h"
+
+#include "compiler.h"
+#include "debug.h"
+#include "inlining.h"
+#include "parser.h"
+#include "rewriter.h"
+#include "scopes.h"
+
+namespace v8 {
+namespace internal {
+
+// Checks that the body of a function only contains constructs that can be
+// compiled into a caller, and counts its AST nodes.
+class InlinableBodyChecker : public AstVisitor {
+ public:
+  InlinableBodyChecker() : node_count_(0), reason_(NULL) { }
+
+  // Returns NULL if the body can be inlined, and the reason why not
+  // otherwise.
+  const char* Check(ZoneList<Statement*>* body);
+
+ private:
+  void CheckNode(AstNode* node) {
+    node_count_++;
+    if (reason_ == NULL) Visit(node);
+  }
+
+  void Fail(const char* reason) {
+    if (reason_ == NULL) reason_ = reason;
+  }
+
+  // Checks the target of an assignment or count operation.
+  void CheckTarget(Expression* target);
+
+  // AST node visit functions.
+#define DECLARE_VISIT(type) virtual void Visit##type(type* node);
+  AST_NODE_LIST(DECLARE_VISIT)
+#undef DECLARE_VISIT
+
+  int node_count_;
+  const char* reason_;
+
+  DISALLOW_COPY_AND_ASSIGN(InlinableBodyChecker);
+};
+
+
+const char* InlinableBodyChecker::Check(ZoneList<Statement*>* body) {
+  for (int i = 0; i < body->length(); i++) {
+    Statement* statement = body->at(i);
+    if (statement->AsReturnStatement() != NULL && i != body->length() - 1) {
+      Fail("statements after return");
+    }
+    CheckNode(statement);
+  }
+  if (HasStackOverflow()) Fail("stack overflow");
+  if (node_count_ > FLAG_max_inlined_nodes) Fail("too many AST nodes");
+  return reason_;
+}
+
+
+void InlinableBodyChecker::CheckTarget(Expression* target) {
+  VariableProxy* proxy = target->AsVariableProxy();
+  if (proxy == NULL) {
+    CheckNode(target);
+  } else if (proxy->var() == NULL || !proxy->var()->is_global()) {
+    Fail("assignment to a local variable");
+  } else {
+    node_count_++;
+  }
+}
+
+
+void InlinableBodyChecker::VisitDeclaration(Declaration* node) {
+  Fail("declaration");
+}
+
+
+void InlinableBodyChecker::VisitBlock(Block* node) {
+  Fail("block");
+}
+
+
+void InlinableBodyChecker::VisitExpressionStatement(
+    ExpressionStatement* node) {
+  CheckNode(node->expression());
+}
+
+
+void InlinableBodyChecker::VisitEmptyStatement(EmptyStatement* node) {
+}
+
+
+void InlinableBodyChecker::VisitIfStatement(IfStatement* node) {
+  Fail("if statement");
+}
+
+
+void InlinableBodyChecker::VisitContinueStatement(ContinueStatement* node) {
+  Fail("continue statement");
+}
+
+
+void InlinableBodyChecker::VisitBreakStatement(BreakStatement* node) {
+  Fail("break statement");
+}
+
+
+void InlinableBodyChecker::VisitReturnStatement(ReturnStatement* node) {
+  CheckNode(node->expression());
+}
+
+
+void InlinableBodyChecker::VisitWithEnterStatement(WithEnterStatement* node) {
+  Fail("with statement");
+}
+
+
+void InlinableBodyChecker::VisitWithExitStatement(WithExitStatement* node) {
+  Fail("with statement");
+}
+
+
+void InlinableBodyChecker::VisitSwitchStatement(SwitchStatement* node) {
+  Fail("switch statement");
+}
+
+
+void InlinableBodyChecker::VisitDoWhileStatement(DoWhileStatement* node) {
+  Fail("loop");
+}
+
+
+void InlinableBodyChecker::VisitWhileStatement(WhileStatement* node) {
+  Fail("loop");
+}
+
+
+void InlinableBodyChecker::VisitForStatement(ForStatement* node) {
+  Fail("loop");
+}
+
+
+void InlinableBodyChecker::VisitForInStatement(ForInStatement* node) {
+  Fail("loop");
+}
+
+
+void InlinableBodyChecker::VisitTryCatchStatement(TryCatchStatement* node) {
+  Fail("try statement");
+}
+
+
+void InlinableBodyChecker::VisitTryFinallyStatement(
+    TryFinallyStatement* node) {
+  Fail("try statement");
+}
+
+
+void InlinableBodyChecker::VisitDebuggerStatement(DebuggerStatement* node) {
+  Fail("debugger statement");
+}
+
+
+void InlinableBodyChecker::VisitFunctionLiteral(FunctionLiteral* node) {
+  Fail("function literal");
+}
+
+
+void InlinableBodyChecker::VisitSharedFunctionInfoLiteral(
+    SharedFunctionInfoLiteral* node) {
+  Fail("function literal");
+}
+
+
+void InlinableBodyChecker::VisitConditional(Conditional* node) {
+  CheckNode(node->condition());
+  CheckNode(node->then_expression());
+  CheckNode(node->else_expression());
+}
+
+
+void InlinableBodyChecker::VisitSlot(Slot* node) {
+  UNREACHABLE();
+}
+
+
+void InlinableBodyChecker::VisitVariableProxy(VariableProxy* node) {
+  Variable* var = node->AsVariable();
+  if (var == NULL) {
+    Fail("rewritten variable");
+  } else if (var->is_global()) {
+    // Global variables are loaded through the caller's context, which
+    // has the same global object.
+  } else if (var->slot() == NULL || var->slot()->type() != Slot::PARAMETER) {
+    Fail("reference to a local variable");
+  }
+}
+
+
+void InlinableBodyChecker::VisitLiteral(Literal* node) {
+}
+
+
+void InlinableBodyChecker::VisitRegExpLiteral(RegExpLiteral* node) {
+  Fail("materialized literal");
+}
+
+
+void InlinableBodyChecker::VisitObjectLiteral(ObjectLiteral* node) {
+  Fail("materialized literal");
+}
+
+
+void InlinableBodyChecker::VisitArrayLiteral(ArrayLiteral* node) {
+  Fail("materialized literal");
+}
+
+
+void InlinableBodyChecker::VisitCatchExtensionObject(
+    CatchExtensionObject* node) {
+  UNREACHABLE();
+}
+
+
+void InlinableBodyChecker::VisitAssignment(Assignment* node) {
+  CheckTarget(node->target());
+  CheckNode(node->value());
+}
+
+
+void InlinableBodyChecker::VisitThrow(Throw* node) {
+  CheckNode(node->exception());
+}
+
+
+void InlinableBodyChecker::VisitProperty(Property* node) {
+  CheckNode(node->obj());
+  CheckNode(node->key());
+}
+
+
+void InlinableBodyChecker::VisitCall(Call* node) {
+  // Calls from the inlined body would be missing the inlined function's
+  // frame in stack traces and in the 'caller' of the function called.
+  Fail("call");
+}
+
+
+void InlinableBodyChecker::VisitCallNew(CallNew* node) {
+  Fail("call");
+}
+
+
+void InlinableBodyChecker::VisitCallRuntime(CallRuntime* node) {
+  Fail("call");
+}
+
+
+void InlinableBodyChecker::VisitUnaryOperation(UnaryOperation* node) {
+  if (node->op() == Token::DELETE &&
+      node->expression()->AsProperty() == NULL) {
+    Fail("delete of a variable");
+  }
+  CheckNode(node->expression());
+}
+
+
+void InlinableBodyChecker::VisitIncrementOperation(IncrementOperation* node) {
+  UNREACHABLE();
+}
+
+
+void InlinableBodyChecker::VisitCountOperation(CountOperation* node) {
+  CheckTarget(node->expression());
+}
+
+
+void InlinableBodyChecker::VisitBinaryOperation(BinaryOperation* node) {
+  CheckNode(node->left());
+  CheckNode(node->right());
+}
+
+
+void InlinableBodyChecker::VisitCompareOperation(CompareOperation* node) {
+  CheckNode(node->left());
+  CheckNode(node->right());
+}
+
+
+void InlinableBodyChecker::VisitCompareToNull(CompareToNull* node) {
+  CheckNode(node->expression());
+}
+
+
+void InlinableBodyChecker::VisitThisFunction(ThisFunction* node) {
+  Fail("reference to the function itself");
+}
+
+
+static void TraceInlining(CompilationInfo* info,
+                          Handle<JSFunction> target,
+                          const char* reason) {
+  if (!FLAG_trace_inlining) return;
+  Handle<SharedFunctionInfo> shared(target->shared());
+  String* name = String::cast(shared->name());
+  if (name->length() == 0) name = String::cast(shared->inferred_name());
+  SmartPointer<char> target_name = name->ToCString();
+  SmartPointer<char> caller_name =
+      String::cast(info->shared_info()->name())->ToCString();
+  if (reason == NULL) {
+    PrintF("[inlining %s into %s]\n", *target_name, *caller_name);
+  } else {
+    PrintF("[not inlining %s into %s: %s]\n",
+           *target_name, *caller_name, reason);
+  }
+}
+
+
+bool Inliner::LookupGlobalFunction(CompilationInfo* info,
+                                   Handle<String> name,
+                                   Handle<JSFunction>* target,
+                                   Handle<JSGlobalPropertyCell>* cell) {
+  if (!info->has_global_object()) return false;
+  GlobalObject* global = info->global_object();
+  LookupResult lookup;
+  global->LocalLookupRealNamedProperty(*name, &lookup);
+  if (!lookup.IsProperty() || lookup.type() != NORMAL) return false;
+  JSGlobalPropertyCell* global_cell =
+      JSGlobalPropertyCell::cast(global->GetPropertyCell(&lookup));
+  if (!global_cell->value()->IsJSFunction()) return false;
+  *target = Handle<JSFunction>(JSFunction::cast(global_cell->value()));
+  *cell = Handle<JSGlobalPropertyCell>(global_cell);
+  return true;
+}
+
+
+Handle<JSFunction> Inliner::FindMonomorphicCallTarget(CompilationInfo* info,
+                                                      int position) {
+  if (!info->is_optimizing() || position == RelocInfo::kNoPosition) {
+    return Handle<JSFunction>::null();
+  }
+  Code* code = info->shared_info()->code();
+  if (code->kind() != Code::FUNCTION) return Handle<JSFunction>::null();
+
+  // The code records the position of a call right before calling its IC.
+  int mode_mask =
+      RelocInfo::kPositionMask | RelocInfo::ModeMask(RelocInfo::CODE_TARGET);
+  int last_position = RelocInfo::kNoPosition;
+  for (RelocIterator it(code, mode_mask); !it.done(); it.next()) {
+    RelocInfo* rinfo = it.rinfo();
+    if (RelocInfo::IsPosition(rinfo->rmode())) {
+      last_position = static_cast<int>(rinfo->data());
+      continue;
+    }
+    if (last_position != position) continue;
+    Code* target = Code::GetCodeFromTargetAddress(rinfo->target_address());
+    if (target->kind() != Code::CALL_IC) continue;
+    if (target->ic_state() != MONOMORPHIC ||
+        target->type() != CONSTANT_FUNCTION) {
+      break;
+    }
+    // The stub for a constant function call loads the function last.
+    JSFunction* function = NULL;
+    int object_mask = RelocInfo::ModeMask(RelocInfo::EMBEDDED_OBJECT);
+    for (RelocIterator stub_it(target, object_mask);
+         !stub_it.done();
+         stub_it.next()) {
+      Object* object = stub_it.rinfo()->target_object();
+      if (object->IsJSFunction()) function = JSFunction::cast(object);
+    }
+    if (function != NULL) return Handle<JSFunction>(function);
+    break;
+  }
+  return Handle<JSFunction>::null();
+}
+
+
+FunctionLiteral* Inliner::BuildInlinableFunction(CompilationInfo* info,
+                                                 Handle<JSFunction> target) {
+  Handle<SharedFunctionInfo> shared(target->shared());
+  const char* reason = NULL;
+  if (!info->has_global_object() ||
+      target->context()->global() != info->global_object()) {
+    reason = "different global object";
+  } else if (shared->script() != *info->script()) {
+    // Source positions in the inlined body refer to the callee's script.
+    reason = "different script";
+  } else if (!shared->allows_lazy_compilation()) {
+    reason = "not declared at top level";
+  } else if (*shared == *info->shared_info()) {
+    reason = "recursive";
+  } else if (shared->end_position() - shared->start_position() >
+             kMaxSourceLength) {
+    reason = "source too long";
+#ifdef ENABLE_DEBUGGER_SUPPORT
+  } else if (Debug::HasDebugInfo(shared)) {
+    reason = "function has break points";
+#endif
+  }
+  if (reason != NULL) {
+    TraceInlining(info, target, reason);
+    return NULL;
+  }
+
+  Handle<Script> script(Script::cast(shared->script()));
+  Handle<String> name(String::cast(shared->name()));
+  FunctionLiteral* literal = MakeLazyAST(script,
+                                         name,
+                                         shared->start_position(),
+                                         shared->end_position(),
+                                         shared->is_expression());
+  if (literal == NULL) {
+    Top::clear_pending_exception();
+    TraceInlining(info, target, "parser stack overflow");
+    return NULL;
+  }
+
+  // Allocate the variables like for lazy compilation.  The outer scope of
+  // the function is the global scope.
+  Scope* top = literal->scope();
+  while (top->outer_scope() != NULL) top = top->outer_scope();
+  top->AllocateVariables(Handle<Context>::null());
+  if (!Rewriter::Optimize(literal)) {
+    TraceInlining(info, target, "stack overflow");
+    return NULL;
+  }
+
+  // The inlined body runs on the caller's frame and in its context.
+  Scope* scope = literal->scope();
+  if (scope->arguments() != NULL) {
+    reason = "uses arguments";
+  } else if (scope->calls_eval()) {
+    reason = "calls eval";
+  } else if (scope->num_stack_slots() > 0 || scope->num_heap_slots() > 0 ||
+             !scope->declarations()->is_empty()) {
+    reason = "has local variables";
+  } else {
+    InlinableBodyChecker checker;
+    reason = checker.Check(literal->body());
+  }
+  TraceInlining(info, target, reason);
+  return reason == NULL ? literal : NULL;
+}
+
+} }  // namespace v8::internal
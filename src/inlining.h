@@ -0,0 +1,79 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef V8_INLINING_H_
+#define V8_INLINING_H_
+
+namespace v8 {
+namespace internal {
+
+class CompilationInfo;
+class FunctionLiteral;
+
+// Finds the functions that the optimizing code generator can inline at a
+// call site.  Only small functions whose body is a sequence of expression
+// statements, optionally ending in a return statement, are inlined.  The
+// body may only refer to the parameters of the function, the receiver and
+// global variables, and may not contain calls or literals that need the
+// function's literals array.  Such a function never needs a frame or a
+// context of its own, so its body can be compiled into the caller with the
+// parameters bound to the arguments on the caller's frame.
+//
+// The generated code must check that the function called is the one that
+// was inlined, and call it the normal way otherwise.
+class Inliner : public AllStatic {
+ public:
+  // Looks up the function held by the global variable 'name' for a call
+  // from the code compiled for 'info'.  On success, *target is the
+  // function and *cell is the global property cell holding it.
+  static bool LookupGlobalFunction(CompilationInfo* info,
+                                   Handle<String> name,
+                                   Handle<JSFunction>* target,
+                                   Handle<JSGlobalPropertyCell>* cell);
+
+  // Returns the function called by the call IC at the given source
+  // position in the unoptimized code of a function that is being
+  // recompiled, if that call IC is monomorphic and calls a constant
+  // function.  Returns a null handle otherwise.
+  static Handle<JSFunction> FindMonomorphicCallTarget(CompilationInfo* info,
+                                                      int position);
+
+  // Returns the literal of 'target', with its variables allocated, if
+  // calls to it can be inlined into the code compiled for 'info', and
+  // NULL otherwise.
+  static FunctionLiteral* BuildInlinableFunction(CompilationInfo* info,
+                                                 Handle<JSFunction> target);
+
+  // Functions with longer source are not parsed to find out whether they
+  // can be inlined.
+  static const int kMaxSourceLength = 1000;
+};
+
+} }  // namespace v8::internal
+
+#endif  // V8_INLINING_H_
@@ -0,0 +1,486 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "v8.h"
+
+#include "char-predicates-inl.h"
+#include "conversions.h"
+#include "execution.h"
+#include "json-parser.h"
+#include "top.h"
+
+namespace v8 {
+namespace internal {
+
+// The actual parser. When seq_ascii is true the source is a sequential
+// ASCII string and characters are read from it directly; otherwise the
+// source is an arbitrary flat string. In both cases the source is accessed
+// through its handle, so a GC moving it during parsing is harmless.
+template <bool seq_ascii>
+class JsonParserImpl BASE_EMBEDDED {
+ public:
+  explicit JsonParserImpl(Handle<String> source)
+      : source_(source),
+        source_length_(source->length()),
+        position_(-1),
+        c0_(kEndOfString),
+        buffer_(32) { }
+
+  // Parse a single JSON value spanning the entire source.
+  Handle<Object> ParseJson();
+
+ private:
+  static const int kEndOfString = -1;
+
+  inline uc32 CharAt(int position) {
+    if (seq_ascii) {
+      return SeqAsciiString::cast(*source_)->SeqAsciiStringGet(position);
+    }
+    return source_->Get(position);
+  }
+
+  inline void Advance() {
+    position_++;
+    c0_ = (position_ < source_length_) ? CharAt(position_) : kEndOfString;
+  }
+
+  // JSON WhiteSpace is tab, carriage-return, newline and space.
+  inline void SkipWhiteSpace() {
+    while (c0_ == ' ' || c0_ == '\n' || c0_ == '\r' || c0_ == '\t') {
+      Advance();
+    }
+  }
+
+  inline void AdvanceSkipWhiteSpace() {
+    Advance();
+    SkipWhiteSpace();
+  }
+
+  // Parse a single JSON value (grammar production JSONValue). On entry c0_
+  // is the first character of the value; on return c0_ is the first
+  // non-whitespace character after it.
+  Handle<Object> ParseJsonValue();
+
+  // Parse a JSON string literal. If is_symbol is true the result is a
+  // symbol, as used for property names.
+  Handle<Object> ParseJsonString(bool is_symbol);
+
+  // Slow case of ParseJsonString for strings containing escape sequences.
+  // The characters from begin up to the current position have already been
+  // checked and contain no escapes.
+  Handle<Object> ParseJsonEscapedString(int begin, bool is_symbol);
+
+  Handle<Object> ParseJsonNumber();
+  Handle<Object> ParseJsonObject();
+  Handle<Object> ParseJsonArray();
+
+  // Parse one of the literals true, false and null.
+  Handle<Object> ParseJsonLiteral(const char* text, Handle<Object> value);
+
+  // Create a JSObject with the given alternating key and value handles.
+  Handle<Object> BuildJsonObject(const List<Handle<Object> >& properties);
+
+  // Append a character to buffer_ in UTF-8 encoding.
+  inline void AddCharToBuffer(uc32 c);
+
+  // Throw a SyntaxError for the current character and return a null handle.
+  Handle<Object> ReportUnexpectedCharacter();
+
+  Handle<String> source_;
+  int source_length_;
+  int position_;
+  uc32 c0_;
+
+  // UTF-8 encoded characters of the string literal being built, used for
+  // property names and for strings that contain escape sequences.
+  List<char> buffer_;
+};
+
+
+template <bool seq_ascii>
+Handle<Object> JsonParserImpl<seq_ascii>::ParseJson() {
+  AdvanceSkipWhiteSpace();
+  Handle<Object> result = ParseJsonValue();
+  if (result.is_null()) return result;
+  if (c0_ != kEndOfString) return ReportUnexpectedCharacter();
+  return result;
+}
+
+
+template <bool seq_ascii>
+Handle<Object> JsonParserImpl<seq_ascii>::ParseJsonValue() {
+  StackLimitCheck check;
+  if (check.HasOverflowed()) {
+    Top::StackOverflow();
+    return Handle<Object>::null();
+  }
+  switch (c0_) {
+    case '"':
+      return ParseJsonString(false);
+    case '-':
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+      return ParseJsonNumber();
+    case '{':
+      return ParseJsonObject();
+    case '[':
+      return ParseJsonArray();
+    case 't':
+      return ParseJsonLiteral("true", Factory::true_value());
+    case 'f':
+      return ParseJsonLiteral("false", Factory::false_value());
+    case 'n':
+      return ParseJsonLiteral("null", Factory::null_value());
+    default:
+      return ReportUnexpectedCharacter();
+  }
+}
+
+
+template <bool seq_ascii>
+Handle<Object> JsonParserImpl<seq_ascii>::ParseJsonLiteral(
+    const char* text, Handle<Object> value) {
+  for (const char* p = text; *p != '\0'; p++) {
+    if (c0_ != *p) return ReportUnexpectedCharacter();
+    Advance();
+  }
+  SkipWhiteSpace();
+  return value;
+}
+
+
+template <bool seq_ascii>
+Handle<Object> JsonParserImpl<seq_ascii>::ParseJsonNumber() {
+  int begin = position_;
+  bool negative = false;
+  if (c0_ == '-') {
+    Advance();
+    negative = true;
+  }
+  int value = 0;
+  int digits = 0;
+  if (c0_ == '0') {
+    Advance();
+    digits++;
+    // Prefix zero is only allowed if it's the only digit before
+    // a decimal point or exponent.
+    if (IsDecimalDigit(c0_)) return ReportUnexpectedCharacter();
+  } else {
+    if (c0_ < '1' || c0_ > '9') return ReportUnexpectedCharacter();
+    do {
+      if (digits < 9) value = value * 10 + (c0_ - '0');
+      digits++;
+      Advance();
+    } while (IsDecimalDigit(c0_));
+  }
+  // Integers of at most nine digits are by far the most common numbers and
+  // are converted without going through StringToDouble. Minus zero is not
+  // an integer value.
+  if (digits <= 9 && c0_ != '.' && c0_ != 'e' && c0_ != 'E' &&
+      !(negative && value == 0)) {
+    SkipWhiteSpace();
+    return Factory::NewNumberFromInt(negative ? -value : value);
+  }
+  if (c0_ == '.') {
+    Advance();
+    if (!IsDecimalDigit(c0_)) return ReportUnexpectedCharacter();
+    do {
+      Advance();
+    } while (IsDecimalDigit(c0_));
+  }
+  if (c0_ == 'e' || c0_ == 'E') {
+    Advance();
+    if (c0_ == '-' || c0_ == '+') Advance();
+    if (!IsDecimalDigit(c0_)) return ReportUnexpectedCharacter();
+    do {
+      Advance();
+    } while (IsDecimalDigit(c0_));
+  }
+  int length = position_ - begin;
+  double number;
+  if (seq_ascii) {
+    // StringToDouble does not allocate, so the characters can be read
+    // in place.
+    Vector<const char> chars(
+        SeqAsciiString::cast(*source_)->GetChars() + begin, length);
+    number = StringToDouble(chars, NO_FLAGS, OS::nan_value());
+  } else {
+    // The number consists of ASCII characters only.
+    ScopedVector<char> chars(length);
+    for (int i = 0; i < length; i++) {
+      chars[i] = static_cast<char>(CharAt(begin + i));
+    }
+    number = StringToDouble(Vector<const char>(chars.start(), length),
+                            NO_FLAGS,
+                            OS::nan_value());
+  }
+  SkipWhiteSpace();
+  return Factory::NewNumber(number);
+}
+
+
+template <bool seq_ascii>
+void JsonParserImpl<seq_ascii>::AddCharToBuffer(uc32 c) {
+  if (static_cast<unsigned>(c) <= unibrow::Utf8::kMaxOneByteChar) {
+    buffer_.Add(static_cast<char>(c));
+  } else {
+    char encoded[unibrow::Utf8::kMaxEncodedSize];
+    int length = unibrow::Utf8::Encode(encoded, c);
+    for (int i = 0; i < length; i++) buffer_.Add(encoded[i]);
+  }
+}
+
+
+template <bool seq_ascii>
+Handle<Object> JsonParserImpl<seq_ascii>::ParseJsonString(bool is_symbol) {
+  ASSERT_EQ('"', c0_);
+  Advance();
+  int begin = position_;
+  // Fast case: scan for the closing quote. Strings without escape sequences
+  // are copied straight out of the source.
+  while (c0_ != '"') {
+    // Check for control character (0x00-0x1f) or unterminated string.
+    if (c0_ < 0x20) return ReportUnexpectedCharacter();
+    if (c0_ == '\\') return ParseJsonEscapedString(begin, is_symbol);
+    Advance();
+  }
+  int end = position_;
+  AdvanceSkipWhiteSpace();
+  if (!is_symbol) return Factory::NewSubString(source_, begin, end);
+  // Copy the characters out of the source first, since the symbol lookup
+  // may allocate and move the source.
+  buffer_.Rewind(0);
+  for (int i = begin; i < end; i++) AddCharToBuffer(CharAt(i));
+  return Factory::LookupSymbol(buffer_.ToConstVector());
+}
+
+
+template <bool seq_ascii>
+Handle<Object> JsonParserImpl<seq_ascii>::ParseJsonEscapedString(
+    int begin, bool is_symbol) {
+  buffer_.Rewind(0);
+  for (int i = begin; i < position_; i++) AddCharToBuffer(CharAt(i));
+  while (c0_ != '"') {
+    if (c0_ < 0x20) return ReportUnexpectedCharacter();
+    if (c0_ != '\\') {
+      AddCharToBuffer(c0_);
+      Advance();
+      continue;
+    }
+    Advance();
+    switch (c0_) {
+      case '"':
+      case '\\':
+      case '/':
+        AddCharToBuffer(c0_);
+        break;
+      case 'b':
+        AddCharToBuffer('\x08');
+        break;
+      case 'f':
+        AddCharToBuffer('\x0c');
+        break;
+      case 'n':
+        AddCharToBuffer('\x0a');
+        break;
+      case 'r':
+        AddCharToBuffer('\x0d');
+        break;
+      case 't':
+        AddCharToBuffer('\x09');
+        break;
+      case 'u': {
+        uc32 value = 0;
+        for (int i = 0; i < 4; i++) {
+          Advance();
+          int digit = HexValue(c0_);
+          if (digit < 0) return ReportUnexpectedCharacter();
+          value = value * 16 + digit;
+        }
+        AddCharToBuffer(value);
+        break;
+      }
+      default:
+        return ReportUnexpectedCharacter();
+    }
+    Advance();
+  }
+  AdvanceSkipWhiteSpace();
+  if (is_symbol) return Factory::LookupSymbol(buffer_.ToConstVector());
+  return Factory::NewStringFromUtf8(buffer_.ToConstVector());
+}
+
+
+template <bool seq_ascii>
+Handle<Object> JsonParserImpl<seq_ascii>::ParseJsonArray() {
+  ASSERT_EQ('[', c0_);
+  AdvanceSkipWhiteSpace();
+  List<Handle<Object> > elements(4);
+  if (c0_ != ']') {
+    while (true) {
+      Handle<Object> element = ParseJsonValue();
+      if (element.is_null()) return element;
+      elements.Add(element);
+      if (c0_ != ',') break;
+      AdvanceSkipWhiteSpace();
+    }
+    if (c0_ != ']') return ReportUnexpectedCharacter();
+  }
+  AdvanceSkipWhiteSpace();
+  int length = elements.length();
+  Handle<FixedArray> fast_elements = Factory::NewFixedArray(length);
+  for (int i = 0; i < length; i++) {
+    fast_elements->set(i, *elements[i]);
+  }
+  return Factory::NewJSArrayWithElements(fast_elements);
+}
+
+
+template <bool seq_ascii>
+Handle<Object> JsonParserImpl<seq_ascii>::ParseJsonObject() {
+  ASSERT_EQ('{', c0_);
+  AdvanceSkipWhiteSpace();
+  // Alternating property names and values, in source order.
+  List<Handle<Object> > properties(8);
+  if (c0_ != '}') {
+    while (true) {
+      if (c0_ != '"') return ReportUnexpectedCharacter();
+      Handle<Object> key = ParseJsonString(true);
+      if (key.is_null()) return key;
+      if (c0_ != ':') return ReportUnexpectedCharacter();
+      AdvanceSkipWhiteSpace();
+      Handle<Object> value = ParseJsonValue();
+      if (value.is_null()) return value;
+      properties.Add(key);
+      properties.Add(value);
+      if (c0_ != ',') break;
+      AdvanceSkipWhiteSpace();
+    }
+    if (c0_ != '}') return ReportUnexpectedCharacter();
+  }
+  AdvanceSkipWhiteSpace();
+  return BuildJsonObject(properties);
+}
+
+
+template <bool seq_ascii>
+Handle<Object> JsonParserImpl<seq_ascii>::BuildJsonObject(
+    const List<Handle<Object> >& properties) {
+  Handle<Context> global_context(Top::context()->global_context());
+  int length = properties.length();
+  int number_of_symbol_keys = 0;
+  for (int i = 0; i < length; i += 2) {
+    uint32_t index;
+    if (!String::cast(*properties[i])->AsArrayIndex(&index)) {
+      number_of_symbol_keys++;
+    }
+  }
+
+  // Take the map from the map cache when possible, so that property
+  // additions follow the transitions made by earlier objects with the same
+  // keys instead of creating new maps for every object.
+  bool is_result_from_cache =
+      number_of_symbol_keys <= JsonParser::kMaxCachedMapKeys;
+  Handle<Map> map;
+  if (is_result_from_cache) {
+    Handle<FixedArray> keys = Factory::NewFixedArray(number_of_symbol_keys);
+    int key_index = 0;
+    for (int i = 0; i < length; i += 2) {
+      uint32_t index;
+      if (!String::cast(*properties[i])->AsArrayIndex(&index)) {
+        keys->set(key_index++, *properties[i]);
+      }
+    }
+    map = Factory::ObjectLiteralMapFromCache(global_context, keys);
+  } else {
+    map = Factory::CopyMap(
+        Handle<Map>(global_context->object_function()->initial_map()),
+        number_of_symbol_keys);
+  }
+
+  Handle<JSObject> json_object = Factory::NewJSObjectFromMap(map);
+  OptimizedObjectForAddingMultipleProperties opt(json_object,
+                                                 number_of_symbol_keys,
+                                                 !is_result_from_cache);
+  for (int i = 0; i < length; i += 2) {
+    Handle<String> key = Handle<String>::cast(properties[i]);
+    Handle<Object> value = properties[i + 1];
+    Handle<Object> result;
+    uint32_t index;
+    if (key->AsArrayIndex(&index)) {
+      result = SetElement(json_object, index, value);
+    } else {
+      result = SetProperty(json_object, key, value, NONE);
+    }
+    if (result.is_null()) return result;
+  }
+  return json_object;
+}
+
+
+template <bool seq_ascii>
+Handle<Object> JsonParserImpl<seq_ascii>::ReportUnexpectedCharacter() {
+  const char* message;
+  Handle<JSArray> array;
+  if (c0_ == kEndOfString) {
+    message = "unexpected_eos";
+    array = Factory::NewJSArray(0);
+  } else if (c0_ == '"') {
+    message = "unexpected_token_string";
+    array = Factory::NewJSArray(0);
+  } else if (c0_ == '-' || IsDecimalDigit(c0_)) {
+    message = "unexpected_token_number";
+    array = Factory::NewJSArray(0);
+  } else {
+    message = "unexpected_token";
+    array = Factory::NewJSArray(1);
+    SetElement(array, 0, LookupSingleCharacterStringFromCode(c0_));
+  }
+  Handle<Object> result = Factory::NewSyntaxError(message, array);
+  Top::Throw(*result);
+  return Handle<Object>::null();
+}
+
+
+Handle<Object> JsonParser::Parse(Handle<String> source) {
+  source = FlattenGetString(source);
+  if (source->IsSeqAsciiString()) {
+    return JsonParserImpl<true>(source).ParseJson();
+  }
+  return JsonParserImpl<false>(source).ParseJson();
+}
+
+} }  // namespace v8::internal
@@ -0,0 +1,333 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "v8.h"
+
+#include "conversions.h"
+#include "execution.h"
+#include "json-stringifier.h"
+
+namespace v8 {
+namespace internal {
+
+class JsonStringifierImpl BASE_EMBEDDED {
+ public:
+  JsonStringifierImpl() : buffer_(kInitialBufferSize), stack_(8) { }
+
+  enum Result { SUCCESS, UNDEFINED, BAILOUT };
+
+  // Append the JSON text for value to the buffer.
+  Result Serialize(Handle<Object> value);
+
+  // Append a quoted JSON string literal to the buffer.
+  void SerializeString(Handle<String> string);
+
+  Handle<String> GetResult() {
+    return Factory::NewStringFromAscii(buffer_.ToConstVector());
+  }
+
+ private:
+  static const int kInitialBufferSize = 256;
+
+  Result SerializeJSObject(Handle<JSObject> object);
+  Result SerializeJSArray(Handle<JSArray> array);
+
+  // Serialize a property value of an object. Properties whose value has no
+  // JSON representation are left out, so the buffer is rewound to before
+  // the property name in that case.
+  Result SerializeProperty(Handle<Object> value, int rewind_position);
+
+  template <typename Char>
+  void SerializeChars(Vector<const Char> chars);
+
+  void SerializeSmi(Smi* smi);
+  void SerializeDouble(double number);
+
+  // Returns true if the object or its prototypes have a toJSON property.
+  bool HasToJSON(JSObject* object);
+
+  // Returns true if the object is on the stack of objects being serialized.
+  bool IsCircular(JSObject* object);
+
+  inline void Append(char c) { buffer_.Add(c); }
+  void Append(const char* chars) {
+    for (const char* p = chars; *p != '\0'; p++) buffer_.Add(*p);
+  }
+
+  // The output. All characters outside the ASCII range are escaped, so the
+  // result is always an ASCII string.
+  List<char> buffer_;
+
+  // Objects and arrays currently being serialized, for cycle detection.
+  List<Handle<JSObject> > stack_;
+};
+
+
+JsonStringifierImpl::Result JsonStringifierImpl::Serialize(
+    Handle<Object> value) {
+  if (value->IsSmi()) {
+    SerializeSmi(Smi::cast(*value));
+    return SUCCESS;
+  }
+  if (value->IsHeapNumber()) {
+    SerializeDouble(HeapNumber::cast(*value)->value());
+    return SUCCESS;
+  }
+  if (value->IsString()) {
+    SerializeString(Handle<String>::cast(value));
+    return SUCCESS;
+  }
+  if (value->IsOddball()) {
+    if (value->IsTrue()) {
+      Append("true");
+    } else if (value->IsFalse()) {
+      Append("false");
+    } else if (value->IsNull()) {
+      Append("null");
+    } else {
+      return UNDEFINED;
+    }
+    return SUCCESS;
+  }
+  if (!value->IsJSObject()) return BAILOUT;
+  Handle<JSObject> object = Handle<JSObject>::cast(value);
+  // Functions and regexps are of type 'function' and have no JSON
+  // representation, and neither have undetectable objects.
+  if (object->IsJSFunction() || object->IsJSRegExp()) return UNDEFINED;
+  if (object->map()->is_undetectable()) return UNDEFINED;
+  // Wrapper objects are unwrapped by calling their valueOf or toString
+  // methods, and anything with a toJSON method calls it.
+  if (object->IsJSValue() || HasToJSON(*object)) return BAILOUT;
+  // The generic serializer throws on cyclic structures and overflows the
+  // stack on very deep ones, so let it report those errors.
+  if (IsCircular(*object)) return BAILOUT;
+  StackLimitCheck check;
+  if (check.HasOverflowed()) return BAILOUT;
+
+  stack_.Add(object);
+  Result result = object->IsJSArray()
+      ? SerializeJSArray(Handle<JSArray>::cast(object))
+      : SerializeJSObject(object);
+  stack_.RemoveLast();
+  return result;
+}
+
+
+JsonStringifierImpl::Result JsonStringifierImpl::SerializeJSArray(
+    Handle<JSArray> array) {
+  if (!array->HasFastElements() || !array->length()->IsSmi()) return BAILOUT;
+  int length = Smi::cast(array->length())->value();
+  Append('[');
+  for (int i = 0; i < length; i++) {
+    if (i > 0) Append(',');
+    // Holes read through to the prototype chain, which only the generic
+    // serializer handles.
+    FixedArray* elements = FixedArray::cast(array->elements());
+    if (i >= elements->length()) return BAILOUT;
+    Object* element = elements->get(i);
+    if (element->IsTheHole()) return BAILOUT;
+    Result result = Serialize(Handle<Object>(element));
+    if (result == BAILOUT) return BAILOUT;
+    if (result == UNDEFINED) Append("null");
+  }
+  Append(']');
+  return SUCCESS;
+}
+
+
+JsonStringifierImpl::Result JsonStringifierImpl::SerializeJSObject(
+    Handle<JSObject> object) {
+  if (object->IsAccessCheckNeeded() ||
+      object->HasNamedInterceptor() ||
+      object->HasIndexedInterceptor() ||
+      !object->HasFastProperties() ||
+      !object->HasFastElements()) {
+    return BAILOUT;
+  }
+  Append('{');
+  bool first = true;
+
+  // Elements come first, in index order, as in a for-in loop.
+  int elements_length = FixedArray::cast(object->elements())->length();
+  for (int i = 0; i < elements_length; i++) {
+    Object* element = FixedArray::cast(object->elements())->get(i);
+    if (element->IsTheHole()) continue;
+    int rewind_position = buffer_.length();
+    if (!first) Append(',');
+    char index_buffer[16];
+    Vector<char> index_chars(index_buffer, ARRAY_SIZE(index_buffer));
+    Append('"');
+    Append(IntToCString(i, index_chars));
+    Append("\":");
+    Result result = SerializeProperty(Handle<Object>(element), rewind_position);
+    if (result == BAILOUT) return BAILOUT;
+    if (result == SUCCESS) first = false;
+  }
+
+  // Named properties follow in enumeration order.
+  Handle<FixedArray> keys = GetEnumPropertyKeys(object, true);
+  for (int i = 0; i < keys->length(); i++) {
+    Handle<String> key(String::cast(keys->get(i)));
+    LookupResult lookup;
+    object->LocalLookupRealNamedProperty(*key, &lookup);
+    // Only plain data properties can be read without running JavaScript
+    // code. Constant functions have no JSON representation.
+    if (!lookup.IsProperty()) return BAILOUT;
+    if (lookup.type() == CONSTANT_FUNCTION) continue;
+    if (lookup.type() != FIELD) return BAILOUT;
+    Handle<Object> value(object->FastPropertyAt(lookup.GetFieldIndex()));
+    int rewind_position = buffer_.length();
+    if (!first) Append(',');
+    SerializeString(key);
+    Append(':');
+    Result result = SerializeProperty(value, rewind_position);
+    if (result == BAILOUT) return BAILOUT;
+    if (result == SUCCESS) first = false;
+  }
+  Append('}');
+  return SUCCESS;
+}
+
+
+JsonStringifierImpl::Result JsonStringifierImpl::SerializeProperty(
+    Handle<Object> value, int rewind_position) {
+  Result result = Serialize(value);
+  if (result == UNDEFINED) buffer_.Rewind(rewind_position);
+  return result;
+}
+
+
+bool JsonStringifierImpl::HasToJSON(JSObject* object) {
+  LookupResult lookup;
+  object->Lookup(Heap::to_json_symbol(), &lookup);
+  return lookup.IsProperty();
+}
+
+
+bool JsonStringifierImpl::IsCircular(JSObject* object) {
+  for (int i = 0; i < stack_.length(); i++) {
+    if (*stack_[i] == object) return true;
+  }
+  return false;
+}
+
+
+void JsonStringifierImpl::SerializeSmi(Smi* smi) {
+  char chars[16];
+  Vector<char> buffer(chars, ARRAY_SIZE(chars));
+  Append(IntToCString(smi->value(), buffer));
+}
+
+
+void JsonStringifierImpl::SerializeDouble(double number) {
+  if (isinf(number) || isnan(number)) {
+    Append("null");
+    return;
+  }
+  char chars[100];
+  Vector<char> buffer(chars, ARRAY_SIZE(chars));
+  Append(DoubleToCString(number, buffer));
+}
+
+
+void JsonStringifierImpl::SerializeString(Handle<String> string) {
+  string = FlattenGetString(string);
+  Append('"');
+  if (string->IsAsciiRepresentation()) {
+    SerializeChars(string->ToAsciiVector());
+  } else {
+    SerializeChars(string->ToUC16Vector());
+  }
+  Append('"');
+}
+
+
+template <typename Char>
+void JsonStringifierImpl::SerializeChars(Vector<const Char> chars) {
+  static const char kHexDigits[] = "0123456789abcdef";
+  for (int i = 0; i < chars.length(); i++) {
+    uc16 c = chars[i];
+    if (c >= 0x20 && c < 0x80 && c != '"' && c != '\\') {
+      Append(static_cast<char>(c));
+      continue;
+    }
+    Append('\\');
+    switch (c) {
+      case '"':
+      case '\\':
+        Append(static_cast<char>(c));
+        break;
+      case '\b':
+        Append('b');
+        break;
+      case '\f':
+        Append('f');
+        break;
+      case '\n':
+        Append('n');
+        break;
+      case '\r':
+        Append('r');
+        break;
+      case '\t':
+        Append('t');
+        break;
+      default:
+        Append('u');
+        Append(kHexDigits[(c >> 12) & 0xf]);
+        Append(kHexDigits[(c >> 8) & 0xf]);
+        Append(kHexDigits[(c >> 4) & 0xf]);
+        Append(kHexDigits[c & 0xf]);
+        break;
+    }
+  }
+}
+
+
+Handle<Object> JsonStringifier::Stringify(Handle<Object> value) {
+  JsonStringifierImpl stringifier;
+  switch (stringifier.Serialize(value)) {
+    case JsonStringifierImpl::SUCCESS:
+      return stringifier.GetResult();
+    case JsonStringifierImpl::UNDEFINED:
+      return Factory::undefined_value();
+    case JsonStringifierImpl::BAILOUT:
+      return Handle<Object>::null();
+  }
+  UNREACHABLE();
+  return Handle<Object>::null();
+}
+
+
+Handle<String> JsonStringifier::Quote(Handle<String> string) {
+  JsonStringifierImpl stringifier;
+  stringifier.SerializeString(string);
+  return stringifier.GetResult();
+}
+
+} }  // namespace v8::internal
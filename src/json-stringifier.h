@@ -0,0 +1,57 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef V8_JSON_STRINGIFIER_H_
+#define V8_JSON_STRINGIFIER_H_
+
+namespace v8 {
+namespace internal {
+
+// Serializer for the common case of JSON.stringify without a replacer
+// function, property list or gap (ECMA-262 5th edition, section 15.12.3).
+// It walks fast-mode objects and arrays with fast elements directly and
+// appends the output to a single character buffer. Anything it cannot
+// handle without running JavaScript code, such as a toJSON method, an
+// accessor or an interceptor, makes it give up so that the caller can fall
+// back to the generic serializer in json.js.
+class JsonStringifier : public AllStatic {
+ public:
+  // Serialize value. Returns the resulting string, the undefined value if
+  // value has no JSON representation, or a null handle if the generic
+  // serializer must be used instead. No JavaScript code is run, so giving
+  // up has no observable side effects.
+  static Handle<Object> Stringify(Handle<Object> value);
+
+  // Quote string as a JSON string literal, escaping the same characters as
+  // the generic serializer.
+  static Handle<String> Quote(Handle<String> string);
+};
+
+} }  // namespace v8::internal
+
+#endif  // V8_JSON_STRINGIFIER_H_
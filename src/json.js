@@ -28,9 +28,7 @@
 var $JSON = global.JSON;
 
 function ParseJSONUnfiltered(text) {
-  var s = $String(text);
-  var f = %CompileString(s, true);
-  return f();
+  return %ParseJson($String(text));
 }
 
 function Revive(holder, name, reviver) {
@@ -67,36 +65,8 @@ function JSONParse(text, reviver) {
   }
 }
 
-var characterQuoteCache = {
-  '\"': '\\"',
-  '\\': '\\\\',
-  '/': '\\/',
-  '\b': '\\b',
-  '\f': '\\f',
-  '\n': '\\n',
-  '\r': '\\r',
-  '\t': '\\t',
-  '\x0B': '\\u000b'
-};
-
-function QuoteSingleJSONCharacter(c) {
-  if (c in characterQuoteCache) {
-    return characterQuoteCache[c];
-  }
-  var charCode = c.charCodeAt(0);
-  var result;
-  if (charCode < 16) result = '\\u000';
-  else if (charCode < 256) result = '\\u00';
-  else if (charCode < 4096) result = '\\u0';
-  else result = '\\u';
-  result += charCode.toString(16);
-  characterQuoteCache[c] = result;
-  return result;
-}
-
 function QuoteJSONString(str) {
-  var quotable = /[\\\"\x00-\x1f\x80-\uffff]/g;
-  return '"' + str.replace(quotable, QuoteSingleJSONCharacter) + '"';
+  return %QuoteJSONString(ToString(str));
 }
 
 function StackContains(stack, val) {
@@ -255,6 +225,13 @@ function JSONStringify(value, replacer, space) {
   } else {
     gap = "";
   }
+  if (gap == "" && !IS_FUNCTION(replacer) && !IS_ARRAY(replacer)) {
+    // The native serializer handles the common case without a replacer or
+    // gap. It returns false if it finds anything that needs JavaScript
+    // code to run, such as a toJSON method or an accessor.
+    var result = %StringifyJson(value);
+    if (result !== false) return result;
+  }
   return JSONSerialize('', {'': value}, replacer, stack, indent, gap);
 }
 
@@ -396,7 +396,19 @@ void BreakTarget::Branch(Condition cc, Hint hint) {
   ASSERT(cgen()->has_valid_frame());
 
   int count = cgen()->frame()->height() - expected_height_;
-  if (count > 0) {
+  if (count > 0 && !is_bound()) {
+    // Forward branch.  Remove the statement state from a copy of the
+    // current frame and branch with that copy, so the fall through
+    // path does not have to jump around the branch.
+    VirtualFrame* fall_through_frame = cgen()->frame();
+    VirtualFrame* branch_frame = new VirtualFrame(fall_through_frame);
+    RegisterFile non_frame_registers;
+    cgen()->SetFrame(branch_frame, &non_frame_registers);
+    cgen()->frame()->ForgetElements(count);
+    DoBranch(cc, hint);
+    cgen()->DeleteFrame();
+    cgen()->SetFrame(fall_through_frame, &non_frame_registers);
+  } else if (count > 0) {
     // We negate and branch here rather than using DoBranch's negate
     // and branch.  This gives us a hook to remove statement state
     // from the frame.
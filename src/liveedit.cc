@@ -781,6 +781,9 @@ class ReferenceCollectorVisitor : public ObjectVisitor {
   // Post-visiting method that iterates over all collected references and
   // modifies them.
   void Replace(Code* substitution) {
+    // Code is never in new space, so none of the writes below go through
+    // the write barrier.
+    IncrementalMarking::RecordWriteOf(substitution);
     for (int i = 0; i < rvalues_.length(); i++) {
       *(rvalues_[i]) = substitution;
     }
@@ -1160,6 +1163,7 @@ void LiveEdit::ReplaceRefToNestedFunction(
     if (it.rinfo()->rmode() == RelocInfo::EMBEDDED_OBJECT) {
       if (it.rinfo()->target_object() == *orig_shared) {
         it.rinfo()->set_target_object(*subst_shared);
+        IncrementalMarking::RecordWriteOf(*subst_shared);
       }
     }
   }
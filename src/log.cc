@@ -1265,6 +1265,8 @@ void Logger::LogCodeObject(Object* object) {
         return;  // We log this later using LogCompiledFunctions.
       case Code::BINARY_OP_IC:
         // fall through
+      case Code::COMPARE_IC:
+        // fall through
       case Code::STUB:
         description = CodeStub::MajorName(code_object->major_key(), true);
         if (description == NULL)
@@ -32,9 +32,11 @@
 #include "heap-profiler.h"
 #include "global-handles.h"
 #include "ic-inl.h"
+#include "incremental-marking.h"
 #include "mark-compact.h"
 #include "objects-visiting.h"
 #include "stub-cache.h"
+#include "work-stealing-deque.h"
 
 namespace v8 {
 namespace internal {
@@ -136,6 +138,8 @@ void MarkCompactCollector::Prepare(GCTracer* tracer) {
     space->PrepareForMarkCompact(compacting_collection_);
   }
 
+  Sweeper::Prepare(compacting_collection_);
+
 #ifdef DEBUG
   live_bytes_ = 0;
   live_young_objects_size_ = 0;
@@ -634,7 +638,8 @@ class SharedFunctionInfoMarkingVisitor : public ObjectVisitor {
 
 
 void MarkCompactCollector::PrepareForCodeFlushing() {
-  if (!FLAG_flush_code) {
+  if (!FLAG_flush_code || FLAG_parallel_marking ||
+      IncrementalMarking::IsFinalizing()) {
     StaticMarkingVisitor::EnableCodeFlushing(false);
     return;
   }
@@ -683,6 +688,12 @@ class RootMarkingVisitor : public ObjectVisitor {
     HeapObject* object = ShortCircuitConsString(p);
     if (object->IsMarked()) return;
 
+    if (FLAG_parallel_marking) {
+      // Leave the objects reachable from the root to the marking threads.
+      MarkCompactCollector::MarkUnmarkedObject(object);
+      return;
+    }
+
     Map* map = object->map();
     // Mark the object.
     MarkCompactCollector::SetMark(object);
@@ -730,6 +741,360 @@ class SymbolTableCleaner : public ObjectVisitor {
 };
 
 
+// -------------------------------------------------------------------------
+// Parallel marking
+//
+// With --parallel-marking the transitive closure of the objects on the
+// marking stack is computed by several threads.  Each thread owns a
+// WorkStealingDeque of marked objects whose children have not been visited
+// yet, and steals from the deques of the other threads when it runs out of
+// work.  Marking is complete when all threads are out of work at the same
+// time.
+//
+// Mark bits live in the map word, so they are set with a compare and swap
+// and the body of each object is visited by exactly one thread.  The
+// deques grow on demand, so the marking stack never overflows while the
+// marking threads run.  Code flushing is disabled in this mode because it
+// updates functions and shared function infos through the write barrier,
+// which is not thread safe.
+
+class MarkingThread;
+
+
+class ParallelMarker : public AllStatic {
+ public:
+  // Mark all objects reachable from the objects on the marking stack, using
+  // --marking-threads threads including the calling one.  Empties the
+  // marking stack.
+  static void EmptyMarkingStack(MarkingStack* stack);
+
+  // Visit the objects on the deque of the given thread, and objects stolen
+  // from other threads, until all threads have run out of work.
+  static void MarkFromDeque(int thread);
+
+#ifdef DEBUG
+  static void UpdateLiveObjectCount(HeapObject* object);
+#endif
+
+  // Stop the marking threads and free the deques.
+  static void TearDown();
+
+ private:
+  static bool StealWork(int thread);
+
+  // Called by a thread that ran out of work.  Returns true when all threads
+  // are out of work and false when there might be work to steal.
+  static bool WaitForWorkOrTermination();
+
+  static WorkStealingDeque* deques_[GCTracer::kMaxMarkingThreads];
+  static MarkingThread* threads_[GCTracer::kMaxMarkingThreads];
+
+  // Time spent marking (excluding time spent waiting for work) and number
+  // of objects marked by each thread in the current phase.
+  static double marking_time_[GCTracer::kMaxMarkingThreads];
+  static int marked_count_[GCTracer::kMaxMarkingThreads];
+
+  static int thread_count_;
+  static int idle_thread_count_;
+  static Mutex* mutex_;
+};
+
+
+// Visitor used by the marking threads.  Newly marked objects are pushed
+// on the deque of the thread; maps are treated like in MarkUnmarkedObject.
+class ParallelMarkingVisitor : public ObjectVisitor {
+ public:
+  explicit ParallelMarkingVisitor(WorkStealingDeque* deque)
+      : deque_(deque), marked_count_(0) { }
+
+  void VisitPointer(Object** p) {
+    MarkObjectByPointer(p);
+  }
+
+  void VisitPointers(Object** start, Object** end) {
+    for (Object** p = start; p < end; p++) MarkObjectByPointer(p);
+  }
+
+  void VisitCodeTarget(RelocInfo* rinfo) {
+    ASSERT(RelocInfo::IsCodeTarget(rinfo->rmode()));
+    Code* code = Code::GetCodeFromTargetAddress(rinfo->target_address());
+    if (FLAG_cleanup_ics_at_gc && code->is_inline_cache_stub()) {
+      IC::Clear(rinfo->pc());
+    } else {
+      MarkObject(code);
+    }
+  }
+
+  void VisitDebugTarget(RelocInfo* rinfo) {
+    ASSERT((RelocInfo::IsJSReturn(rinfo->rmode()) &&
+            rinfo->IsPatchedReturnSequence()) ||
+           (RelocInfo::IsDebugBreakSlot(rinfo->rmode()) &&
+            rinfo->IsPatchedDebugBreakSlotSequence()));
+    MarkObject(Code::GetCodeFromTargetAddress(rinfo->call_address()));
+  }
+
+  // Mark the map and the children of a marked object taken from a deque.
+  void VisitMarkedObject(HeapObject* object) {
+    ASSERT(Heap::Contains(object));
+    ASSERT(object->IsMarked());
+    ASSERT(!object->IsOverflowed());
+    MapWord map_word = object->map_word();
+    map_word.ClearMark();
+    Map* map = map_word.ToMap();
+    MarkObject(map);
+    object->IterateBody(map->instance_type(), object->SizeFromMap(map), this);
+  }
+
+  int marked_count() { return marked_count_; }
+
+ private:
+  void MarkObjectByPointer(Object** p) {
+    if (!(*p)->IsHeapObject()) return;
+    MarkObject(ShortCircuitConsString(p));
+  }
+
+  void MarkObject(HeapObject* object) {
+    if (!TrySetMark(object)) return;
+    if (IsMap(object)) {
+      Map* map = reinterpret_cast<Map*>(object);
+      if (FLAG_cleanup_caches_in_maps_at_gc) {
+        map->ClearCodeCache();
+      }
+      if (FLAG_collect_maps &&
+          map->instance_type() >= FIRST_JS_OBJECT_TYPE &&
+          map->instance_type() <= JS_FUNCTION_TYPE) {
+        MarkMapContents(map);
+        return;
+      }
+    }
+    deque_->Push(object);
+  }
+
+  // Same as MarkCompactCollector::MarkMapContents.
+  void MarkMapContents(Map* map) {
+    MarkDescriptorArray(reinterpret_cast<DescriptorArray*>(
+        *HeapObject::RawField(map, Map::kInstanceDescriptorsOffset)));
+    VisitPointers(HeapObject::RawField(map, Map::kPointerFieldsBeginOffset),
+                  HeapObject::RawField(map, Map::kPointerFieldsEndOffset));
+  }
+
+  // Same as MarkCompactCollector::MarkDescriptorArray.
+  void MarkDescriptorArray(DescriptorArray* descriptors) {
+    if (!TrySetMark(descriptors)) return;
+    FixedArray* contents = reinterpret_cast<FixedArray*>(
+        descriptors->get(DescriptorArray::kContentArrayIndex));
+    ASSERT(contents->IsHeapObject());
+    ASSERT(contents->length() >= 2);
+    // The contents array belongs to the descriptor array, so no other
+    // thread can have marked it.
+    bool marked = TrySetMark(contents);
+    USE(marked);
+    ASSERT(marked);
+    for (int i = 0; i < contents->length(); i += 2) {
+      PropertyDetails details(Smi::cast(contents->get(i + 1)));
+      if (details.type() < FIRST_PHANTOM_PROPERTY_TYPE) {
+        Object* value = contents->get(i);
+        if (value->IsHeapObject()) MarkObject(HeapObject::cast(value));
+      }
+    }
+    deque_->Push(descriptors);
+  }
+
+  // Set the mark bit of an object.  Returns false if the object was
+  // already marked, possibly by another thread.
+  bool TrySetMark(HeapObject* object) {
+    volatile AtomicWord* map_word_address =
+        reinterpret_cast<volatile AtomicWord*>(object->address());
+    AtomicWord value = *map_word_address;
+    while (true) {
+      if ((value & MapWord::kMarkingMask) == 0) return false;
+      AtomicWord previous = OS::CompareAndSwap(
+          map_word_address, value, value & ~MapWord::kMarkingMask);
+      if (previous == value) break;
+      value = previous;
+    }
+    marked_count_++;
+#ifdef DEBUG
+    ParallelMarker::UpdateLiveObjectCount(object);
+#endif
+    Sweeper::RecordLiveObjectAtomic(object);
+    return true;
+  }
+
+  static bool IsMap(HeapObject* object) {
+    MapWord map_word = object->map_word();
+    map_word.ClearMark();
+    return map_word.ToMap()->instance_type() == MAP_TYPE;
+  }
+
+  WorkStealingDeque* deque_;
+  int marked_count_;
+};
+
+
+class MarkingThread : public Thread {
+ public:
+  explicit MarkingThread(int thread)
+      : thread_(thread),
+        start_(OS::CreateSemaphore(0)),
+        done_(OS::CreateSemaphore(0)),
+        stopped_(false) { }
+
+  ~MarkingThread() {
+    delete start_;
+    delete done_;
+  }
+
+  void Run() {
+    while (true) {
+      start_->Wait();
+      if (stopped_) return;
+      ParallelMarker::MarkFromDeque(thread_);
+      done_->Signal();
+    }
+  }
+
+  // Let the thread take part in the current marking phase.
+  void StartMarking() { start_->Signal(); }
+
+  // Wait for the thread to finish the current marking phase.
+  void WaitForMarking() { done_->Wait(); }
+
+  void Stop() {
+    stopped_ = true;
+    start_->Signal();
+    Join();
+  }
+
+ private:
+  int thread_;
+  Semaphore* start_;
+  Semaphore* done_;
+  volatile bool stopped_;
+};
+
+
+WorkStealingDeque* ParallelMarker::deques_[GCTracer::kMaxMarkingThreads];
+MarkingThread* ParallelMarker::threads_[GCTracer::kMaxMarkingThreads];
+double ParallelMarker::marking_time_[GCTracer::kMaxMarkingThreads];
+int ParallelMarker::marked_count_[GCTracer::kMaxMarkingThreads];
+int ParallelMarker::thread_count_ = 0;
+int ParallelMarker::idle_thread_count_ = 0;
+Mutex* ParallelMarker::mutex_ = NULL;
+
+
+void ParallelMarker::EmptyMarkingStack(MarkingStack* stack) {
+  if (stack->is_empty()) return;
+
+  int thread_count = Max(1, Min(FLAG_marking_threads,
+                                GCTracer::kMaxMarkingThreads));
+  if (mutex_ == NULL) mutex_ = OS::CreateMutex();
+  for (int i = 0; i < thread_count; i++) {
+    if (deques_[i] == NULL) deques_[i] = new WorkStealingDeque();
+    if (i > 0 && threads_[i] == NULL) {
+      threads_[i] = new MarkingThread(i);
+      threads_[i]->Start();
+    }
+  }
+
+  // Deal the objects on the marking stack out to the deques.
+  for (int i = 0; !stack->is_empty(); i = (i + 1) % thread_count) {
+    deques_[i]->Push(stack->Pop());
+  }
+
+  thread_count_ = thread_count;
+  idle_thread_count_ = 0;
+  for (int i = 1; i < thread_count; i++) threads_[i]->StartMarking();
+  MarkFromDeque(0);
+  for (int i = 1; i < thread_count; i++) threads_[i]->WaitForMarking();
+
+  GCTracer* tracer = MarkCompactCollector::tracer();
+  for (int i = 0; i < thread_count; i++) {
+    ASSERT(deques_[i]->IsEmpty());
+    tracer->AddMarkingThreadStats(i, marking_time_[i], marked_count_[i]);
+  }
+}
+
+
+void ParallelMarker::MarkFromDeque(int thread) {
+  double start_time = OS::TimeCurrentMillis();
+  double idle_time = 0;
+  WorkStealingDeque* deque = deques_[thread];
+  ParallelMarkingVisitor visitor(deque);
+  while (true) {
+    HeapObject* object;
+    while (deque->Pop(&object)) visitor.VisitMarkedObject(object);
+    if (StealWork(thread)) continue;
+    double idle_start_time = OS::TimeCurrentMillis();
+    bool done = WaitForWorkOrTermination();
+    idle_time += OS::TimeCurrentMillis() - idle_start_time;
+    if (done) break;
+  }
+  marking_time_[thread] = OS::TimeCurrentMillis() - start_time - idle_time;
+  marked_count_[thread] = visitor.marked_count();
+}
+
+
+bool ParallelMarker::StealWork(int thread) {
+  WorkStealingDeque* deque = deques_[thread];
+  for (int i = 0; i < thread_count_; i++) {
+    if (deque->StealFrom(deques_[(thread + i) % thread_count_])) return true;
+  }
+  return false;
+}
+
+
+bool ParallelMarker::WaitForWorkOrTermination() {
+  {
+    ScopedLock lock(mutex_);
+    idle_thread_count_++;
+  }
+  while (true) {
+    bool work_available = false;
+    for (int i = 0; i < thread_count_; i++) {
+      if (deques_[i]->HasSharedWork()) {
+        work_available = true;
+        break;
+      }
+    }
+    {
+      ScopedLock lock(mutex_);
+      // Only a thread with objects left to visit can create more work, so
+      // once every thread is idle no new work can appear.
+      if (idle_thread_count_ == thread_count_) return true;
+      if (work_available) {
+        idle_thread_count_--;
+        return false;
+      }
+    }
+    Thread::YieldCPU();
+  }
+}
+
+
+#ifdef DEBUG
+void ParallelMarker::UpdateLiveObjectCount(HeapObject* object) {
+  ScopedLock lock(mutex_);
+  MarkCompactCollector::UpdateLiveObjectCount(object);
+}
+#endif
+
+
+void ParallelMarker::TearDown() {
+  for (int i = 0; i < GCTracer::kMaxMarkingThreads; i++) {
+    if (threads_[i] != NULL) {
+      threads_[i]->Stop();
+      delete threads_[i];
+      threads_[i] = NULL;
+    }
+    delete deques_[i];
+    deques_[i] = NULL;
+  }
+  delete mutex_;
+  mutex_ = NULL;
+}
+
+
 void MarkCompactCollector::MarkUnmarkedObject(HeapObject* object) {
   ASSERT(!object->IsMarked());
   ASSERT(Heap::Contains(object));
@@ -925,6 +1290,11 @@ void MarkCompactCollector::MarkObjectGroups() {
 // After: the marking stack is empty, and all objects reachable from the
 // marking stack have been marked, or are overflowed in the heap.
 void MarkCompactCollector::EmptyMarkingStack() {
+  if (FLAG_parallel_marking) {
+    ParallelMarker::EmptyMarkingStack(&marking_stack);
+    return;
+  }
+
   while (!marking_stack.is_empty()) {
     HeapObject* object = marking_stack.Pop();
     ASSERT(object->IsHeapObject());
@@ -1024,6 +1394,10 @@ void MarkCompactCollector::MarkLiveObjects() {
 
   PrepareForCodeFlushing();
 
+  if (IncrementalMarking::IsFinalizing()) {
+    IncrementalMarking::TransferMarks();
+  }
+
   RootMarkingVisitor root_visitor;
   MarkRoots(&root_visitor);
 
@@ -1042,10 +1416,7 @@ void MarkCompactCollector::MarkLiveObjects() {
   GlobalHandles::IdentifyWeakHandles(&IsUnmarkedHeapObject);
   // Then we mark the objects and process the transitive closure.
   GlobalHandles::IterateWeakRoots(&root_visitor);
-  while (marking_stack.overflowed()) {
-    RefillMarkingStack();
-    EmptyMarkingStack();
-  }
+  ProcessMarkingStack();
 
   // Repeat the object groups to mark unmarked groups reachable from the
   // weak roots.
@@ -1075,23 +1446,28 @@ static int CountMarkedCallback(HeapObject* obj) {
 
 #ifdef DEBUG
 void MarkCompactCollector::UpdateLiveObjectCount(HeapObject* obj) {
-  live_bytes_ += obj->Size();
+  // The object may already be marked when marking in parallel.
+  MapWord map_word = obj->map_word();
+  map_word.ClearMark();
+  Map* map = map_word.ToMap();
+  int size = obj->SizeFromMap(map);
+  live_bytes_ += size;
   if (Heap::new_space()->Contains(obj)) {
-    live_young_objects_size_ += obj->Size();
+    live_young_objects_size_ += size;
   } else if (Heap::map_space()->Contains(obj)) {
-    ASSERT(obj->IsMap());
-    live_map_objects_size_ += obj->Size();
+    ASSERT(map->instance_type() == MAP_TYPE);
+    live_map_objects_size_ += size;
   } else if (Heap::cell_space()->Contains(obj)) {
-    ASSERT(obj->IsJSGlobalPropertyCell());
-    live_cell_objects_size_ += obj->Size();
+    ASSERT(map->instance_type() == JS_GLOBAL_PROPERTY_CELL_TYPE);
+    live_cell_objects_size_ += size;
   } else if (Heap::old_pointer_space()->Contains(obj)) {
-    live_old_pointer_objects_size_ += obj->Size();
+    live_old_pointer_objects_size_ += size;
   } else if (Heap::old_data_space()->Contains(obj)) {
-    live_old_data_objects_size_ += obj->Size();
+    live_old_data_objects_size_ += size;
   } else if (Heap::code_space()->Contains(obj)) {
-    live_code_objects_size_ += obj->Size();
+    live_code_objects_size_ += size;
   } else if (Heap::lo_space()->Contains(obj)) {
-    live_lo_objects_size_ += obj->Size();
+    live_lo_objects_size_ += size;
   } else {
     UNREACHABLE();
   }
@@ -1909,6 +2285,9 @@ class MapCompact {
   void UpdateMapPointersInPagedSpace(PagedSpace* space) {
     ASSERT(space != Heap::map_space());
 
+    // Dead objects on pages whose sweeping was deferred cannot be iterated.
+    Sweeper::EnsureSwept(space);
+
     PageIterator it(space, PageIterator::PAGES_IN_USE);
     while (it.has_next()) {
       Page* p = it.next();
@@ -2078,10 +2457,17 @@ void MarkCompactCollector::SweepSpaces() {
   // bits and free the nonlive blocks (for old and map spaces).  We sweep
   // the map space last because freeing non-live maps overwrites them and
   // the other spaces rely on possibly non-live maps to get the sizes for
-  // non-live objects.
-  SweepSpace(Heap::old_pointer_space(), &DeallocateOldPointerBlock);
-  SweepSpace(Heap::old_data_space(), &DeallocateOldDataBlock);
-  SweepSpace(Heap::code_space(), &DeallocateCodeBlock);
+  // non-live objects.  The sweeper can defer finding the free blocks of the
+  // old spaces until after the collection; it only visits live objects.
+  if (Sweeper::IsDeferring()) {
+    Sweeper::DeferSweeping(Heap::old_pointer_space());
+    Sweeper::DeferSweeping(Heap::old_data_space());
+    Sweeper::DeferSweeping(Heap::code_space());
+  } else {
+    SweepSpace(Heap::old_pointer_space(), &DeallocateOldPointerBlock);
+    SweepSpace(Heap::old_data_space(), &DeallocateOldDataBlock);
+    SweepSpace(Heap::code_space(), &DeallocateCodeBlock);
+  }
   SweepSpace(Heap::cell_space(), &DeallocateCellBlock);
   { GCTracer::Scope gc_scope(tracer_, GCTracer::Scope::MC_SWEEP_NEWSPACE);
     SweepNewSpace(Heap::new_space());
@@ -2114,6 +2500,8 @@ void MarkCompactCollector::SweepSpaces() {
 
     map_compact.Finish();
   }
+
+  Sweeper::StartSweeping();
 }
 
 
@@ -2673,4 +3061,9 @@ void MarkCompactCollector::Initialize() {
 }
 
 
+void MarkCompactCollector::TearDown() {
+  ParallelMarker::TearDown();
+}
+
+
 } }  // namespace v8::internal
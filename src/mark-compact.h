@@ -28,6 +28,8 @@
 #ifndef V8_MARK_COMPACT_H_
 #define V8_MARK_COMPACT_H_
 
+#include "sweeper.h"
+
 namespace v8 {
 namespace internal {
 
@@ -89,6 +91,9 @@ class MarkCompactCollector: public AllStatic {
 
   static void Initialize();
 
+  // Stops the parallel marking threads, if any.
+  static void TearDown();
+
   // Prepares for GC by resetting relocation info in old and map spaces and
   // choosing spaces to compact.
   static void Prepare(GCTracer* tracer);
@@ -177,6 +182,8 @@ class MarkCompactCollector: public AllStatic {
   friend class StaticMarkingVisitor;
   friend class CodeMarkingVisitor;
   friend class SharedFunctionInfoMarkingVisitor;
+  friend class ParallelMarker;
+  friend class IncrementalMarking;
 
   static void PrepareForCodeFlushing();
 
@@ -195,6 +202,7 @@ class MarkCompactCollector: public AllStatic {
     UpdateLiveObjectCount(obj);
 #endif
     obj->SetMark();
+    Sweeper::RecordLiveObject(obj);
   }
 
   // Creates back pointers for all map transitions, stores them in
@@ -231,7 +239,8 @@ class MarkCompactCollector: public AllStatic {
   // Mark objects reachable (transitively) from objects in the marking
   // stack.  This function empties the marking stack, but may leave
   // overflowed objects in the heap, in which case the marking stack's
-  // overflow flag will be set.
+  // overflow flag will be set.  With --parallel-marking the work is split
+  // between several threads (see ParallelMarker).
   static void EmptyMarkingStack();
 
   // Refill the marking stack with overflowed objects from the heap.  This
@@ -567,6 +567,20 @@ static void Generate_JSConstructStubHelper(MacroAssembler* masm,
     __ lbu(a3, FieldMemOperand(a2, Map::kInstanceTypeOffset));
     __ Branch(&rt_call, eq, a3, Operand(JS_FUNCTION_TYPE));
 
+    // Leave the allocation to the runtime while the allocation site of the
+    // constructor collects feedback, or when it tenures the objects.
+    // a1: constructor function
+    // a2: initial map
+    // t7: undefined value
+    Label allocate;
+    __ lw(a3, FieldMemOperand(a1, JSFunction::kSharedFunctionInfoOffset));
+    __ lw(a3, FieldMemOperand(a3, SharedFunctionInfo::kAllocationSiteOffset));
+    __ Branch(&allocate, eq, a3, Operand(t7));
+    __ lw(a3, FieldMemOperand(a3, AllocationSite::kStateOffset));
+    __ Branch(&rt_call, lt, a3,
+              Operand(Smi::FromInt(AllocationSite::kPending)));
+    __ bind(&allocate);
+
     // Now allocate the JSObject on the heap.
     // constructor function
     // a2: initial map
@@ -975,6 +989,30 @@ void Builtins::Generate_LazyCompile(MacroAssembler* masm) {
 }
 
 
+void Builtins::Generate_LazyRecompile(MacroAssembler* masm) {
+  // Enter an internal frame.
+  __ EnterInternalFrame();
+
+  // Preserve the function.
+  __ Push(a1);
+
+  // Push the function on the stack as the argument to the runtime function.
+  __ Push(a1);
+  // Call the runtime function
+  __ CallRuntime(Runtime::kLazyRecompile, 1);
+  // Calculate the entry point.
+  __ addiu(t9, v0, Code::kHeaderSize - kHeapObjectTag);
+  // Restore saved function.
+  __ Pop(a1);
+
+  // Tear down temporary frame.
+  __ LeaveInternalFrame();
+
+  // Do a tail-call of the recompiled function.
+  __ Jump(t9);
+}
+
+
 
 void Builtins::Generate_FunctionCall(MacroAssembler* masm) {
   // CAREFUL! : Implemented without Builtins args slots.
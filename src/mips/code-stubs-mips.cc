@@ -178,6 +178,17 @@ void FastCloneShallowArrayStub::Generate(MacroAssembler* masm) {
   __ LoadRoot(t1, Heap::kUndefinedValueRootIndex);
   __ Branch(&slow_case, eq, a3, Operand(t1));
 
+  // Leave the cloning to the runtime while the allocation site of the literal
+  // collects feedback, or when it tenures the arrays.
+  // t0: address of the boilerplate slot in the literals array
+  Label allocate;
+  __ lw(a2, MemOperand(t0, kPointerSize));
+  __ Branch(&allocate, eq, a2, Operand(t1));
+  __ lw(a2, FieldMemOperand(a2, AllocationSite::kStateOffset));
+  __ Branch(&slow_case, lt, a2,
+            Operand(Smi::FromInt(AllocationSite::kPending)));
+  __ bind(&allocate);
+
   if (FLAG_debug_code) {
     const char* message;
     Heap::RootListIndex expected_map_index;
@@ -3459,6 +3470,62 @@ int CompareStub::MinorKey() {
 }
 
 
+// The MIPS code generators still call CompareStub directly.
+Token::Value ICCompareStub::ComputeOperation(Condition cc, bool strict) {
+  switch (cc) {
+    case eq: return strict ? Token::EQ_STRICT : Token::EQ;
+    case lt: return Token::LT;
+    case gt: return Token::GT;
+    case le: return Token::LTE;
+    case ge: return Token::GTE;
+    default:
+      UNREACHABLE();
+      return Token::ILLEGAL;
+  }
+}
+
+
+Condition ICCompareStub::GetCondition() {
+  switch (op_) {
+    case Token::EQ:
+    case Token::EQ_STRICT:
+      return eq;
+    case Token::LT: return lt;
+    case Token::GT: return gt;
+    case Token::LTE: return le;
+    case Token::GTE: return ge;
+    default:
+      UNREACHABLE();
+      return no_condition;
+  }
+}
+
+
+void ICCompareStub::GenerateHeapNumbers(MacroAssembler* masm) {
+  UNIMPLEMENTED_MIPS();
+}
+
+
+void ICCompareStub::GenerateSymbols(MacroAssembler* masm) {
+  UNIMPLEMENTED_MIPS();
+}
+
+
+void ICCompareStub::GenerateStrings(MacroAssembler* masm) {
+  UNIMPLEMENTED_MIPS();
+}
+
+
+void ICCompareStub::GenerateObjects(MacroAssembler* masm) {
+  UNIMPLEMENTED_MIPS();
+}
+
+
+void ICCompareStub::GenerateMiss(MacroAssembler* masm) {
+  UNIMPLEMENTED_MIPS();
+}
+
+
 // StringCharCodeAtGenerator
 
 void StringCharCodeAtGenerator::GenerateFast(MacroAssembler* masm) {
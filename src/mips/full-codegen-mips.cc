@@ -45,6 +45,16 @@ void FullCodeGenerator::Generate(CompilationInfo* info) {
 }
 
 
+void FullCodeGenerator::EmitTierUpCheck() {
+  UNIMPLEMENTED_MIPS();
+}
+
+
+void FullCodeGenerator::EmitBackEdgeCheck(IterationStatement* stmt) {
+  UNIMPLEMENTED_MIPS();
+}
+
+
 void FullCodeGenerator::EmitReturnSequence() {
   UNIMPLEMENTED_MIPS();
 }
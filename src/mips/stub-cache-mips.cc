@@ -842,6 +842,25 @@ static Object* GenerateCheckPropertyCell(MacroAssembler* masm,
 }
 
 
+// Checks the map of the receiver against each of the maps and jumps to
+// the corresponding handler on a match. Falls through on a mismatch.
+static void GenerateMapDispatch(MacroAssembler* masm,
+                                Register receiver,
+                                Register scratch,
+                                List<Map*>* maps,
+                                List<Code*>* handlers,
+                                Label* miss) {
+  ASSERT(maps->length() == handlers->length());
+  __ And(scratch, receiver, Operand(kSmiTagMask));
+  __ Branch(miss, eq, scratch, Operand(zero_reg));
+  __ lw(scratch, FieldMemOperand(receiver, HeapObject::kMapOffset));
+  for (int i = 0; i < maps->length(); i++) {
+    __ Jump(Handle<Code>(handlers->at(i)), RelocInfo::CODE_TARGET,
+            eq, scratch, Operand(Handle<Map>(maps->at(i))));
+  }
+}
+
+
 #undef __
 #define __ ACCESS_MASM(masm())
 
@@ -1769,6 +1788,33 @@ Object* CallStubCompiler::CompileCallGlobal(JSObject* object,
   return GetCode(NORMAL, name);
 }
 
+Object* CallStubCompiler::CompileCallPolymorphic(List<Map*>* maps,
+                                                 List<Code*>* handlers,
+                                                 String* name) {
+  // ----------- S t a t e -------------
+  //  -- a2    : name
+  //  -- ra    : return address
+  // -----------------------------------
+  Label miss;
+
+  GenerateNameCheck(name, &miss);
+
+  // Get the receiver from the stack.
+  const int argc = arguments().immediate();
+  __ lw(a1, MemOperand(sp, argc * kPointerSize));
+
+  GenerateMapDispatch(masm(), a1, a3, maps, handlers, &miss);
+
+  // Handle call cache miss.
+  __ bind(&miss);
+  Object* obj = GenerateMissBranch();
+  if (obj->IsFailure()) return obj;
+
+  // Return the generated code.
+  return GetPolymorphicCode(name);
+}
+
+
 
 Object* StoreStubCompiler::CompileStoreField(JSObject* object,
                                              int index,
@@ -1920,6 +1966,29 @@ Object* StoreStubCompiler::CompileStoreGlobal(GlobalObject* object,
   return GetCode(NORMAL, name);
 }
 
+Object* StoreStubCompiler::CompileStorePolymorphic(List<Map*>* maps,
+                                                   List<Code*>* handlers,
+                                                   String* name) {
+  // ----------- S t a t e -------------
+  //  -- a0    : value
+  //  -- a1    : receiver
+  //  -- a2    : name
+  //  -- ra    : return address
+  // -----------------------------------
+  Label miss;
+
+  GenerateMapDispatch(masm(), a1, a3, maps, handlers, &miss);
+
+  // Handle store cache miss.
+  __ bind(&miss);
+  Handle<Code> ic(Builtins::builtin(Builtins::StoreIC_Miss));
+  __ JumpToBuiltin(ic, RelocInfo::CODE_TARGET);
+
+  // Return the generated code.
+  return GetPolymorphicCode(name);
+}
+
+
 
 Object* LoadStubCompiler::CompileLoadNonexistent(String* name,
                                                  JSObject* object,
@@ -2101,6 +2170,26 @@ Object* LoadStubCompiler::CompileLoadGlobal(JSObject* object,
   return GetCode(NORMAL, name);
 }
 
+Object* LoadStubCompiler::CompileLoadPolymorphic(List<Map*>* maps,
+                                                 List<Code*>* handlers,
+                                                 String* name) {
+  // ----------- S t a t e -------------
+  //  -- a0    : receiver
+  //  -- a2    : name
+  //  -- ra    : return address
+  // -----------------------------------
+  Label miss;
+
+  GenerateMapDispatch(masm(), a0, a3, maps, handlers, &miss);
+
+  __ bind(&miss);
+  GenerateLoadMiss(masm(), Code::LOAD_IC);
+
+  // Return the generated code.
+  return GetPolymorphicCode(name);
+}
+
+
 
 Object* KeyedLoadStubCompiler::CompileLoadField(String* name,
                                                 JSObject* receiver,
@@ -2336,6 +2425,20 @@ Object* ConstructStubCompiler::CompileConstructStub(
       a3, Operand(JS_FUNCTION_TYPE));
 #endif
 
+  // Leave the allocation to the generic stub while the allocation site of the
+  // constructor collects feedback, or when it tenures the objects.
+  // a1: constructor function
+  // a2: initial map
+  // t7: undefined
+  Label allocate;
+  __ lw(a3, FieldMemOperand(a1, JSFunction::kSharedFunctionInfoOffset));
+  __ lw(a3, FieldMemOperand(a3, SharedFunctionInfo::kAllocationSiteOffset));
+  __ Branch(&allocate, eq, a3, Operand(t7));
+  __ lw(a3, FieldMemOperand(a3, AllocationSite::kStateOffset));
+  __ Branch(&generic_stub_call, lt, a3,
+            Operand(Smi::FromInt(AllocationSite::kPending)));
+  __ bind(&allocate);
+
   // Now allocate the JSObject in new space.
   // a0: argc
   // a1: constructor function
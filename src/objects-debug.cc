@@ -784,6 +784,10 @@ void SharedFunctionInfo::SharedFunctionInfoPrint() {
          has_only_simple_this_property_assignments());
   PrintF("\n - this_property_assignments = ");
   this_property_assignments()->ShortPrint();
+  PrintF("\n - allocation_site = ");
+  allocation_site()->ShortPrint();
+  PrintF("\n - is_optimized = %d", is_optimized());
+  PrintF("\n - tier_up_counter = %d", tier_up_counter());
   PrintF("\n");
 }
 
@@ -796,6 +800,9 @@ void SharedFunctionInfo::SharedFunctionInfoVerify() {
   VerifyObjectField(kFunctionDataOffset);
   VerifyObjectField(kScriptOffset);
   VerifyObjectField(kDebugInfoOffset);
+  VerifyObjectField(kAllocationSiteOffset);
+  CHECK(allocation_site()->IsUndefined() ||
+        allocation_site()->IsAllocationSite());
 }
 
 
@@ -1363,6 +1370,17 @@ void JSFunctionResultCache::JSFunctionResultCacheVerify() {
 }
 
 
+
+void AllocationSite::AllocationSiteVerify() {
+  int state = Smi::cast(get(kStateIndex))->value();
+  ASSERT(kCollecting <= state && state <= kDontTenure);
+  int created = Smi::cast(get(kMementoCreateCountIndex))->value();
+  int found = Smi::cast(get(kMementoFoundCountIndex))->value();
+  ASSERT(0 <= found && found <= created);
+  ASSERT(created <= kMementoSampleSize);
+}
+
+
 #endif  // DEBUG
 
 } }  // namespace v8::internal
@@ -38,8 +38,10 @@
 #include "memory.h"
 #include "contexts.h"
 #include "conversions-inl.h"
+#include "incremental-marking.h"
 #include "objects.h"
 #include "property.h"
+#include "store-buffer.h"
 
 namespace v8 {
 namespace internal {
@@ -575,6 +577,23 @@ bool Object::IsJSFunctionResultCache() {
 }
 
 
+bool Object::IsAllocationSite() {
+  if (!IsFixedArray()) return false;
+  FixedArray* self = FixedArray::cast(this);
+  if (self->length() != AllocationSite::kLength) return false;
+#ifdef DEBUG
+  reinterpret_cast<AllocationSite*>(this)->AllocationSiteVerify();
+#endif
+  return true;
+}
+
+
+bool Object::IsAllocationMemento() {
+  return IsHeapObject()
+      && HeapObject::cast(this)->map() == Heap::allocation_memento_map();
+}
+
+
 bool Object::IsCompilationCacheTable() {
   return IsHashTable();
 }
@@ -750,7 +769,9 @@ Object* Object::GetProperty(String* key, PropertyAttributes* attributes) {
     ASSERT(Heap::InNewSpace(object) || \
            !Heap::InNewSpace(READ_FIELD(object, offset)) || \
            Page::FromAddress(object->address())->           \
-               IsRegionDirty(object->address() + offset));  \
+               IsRegionDirty(object->address() + offset) || \
+           StoreBuffer::CellIsInStoreBuffer(                \
+               object->address() + offset));                \
   }
 
 #define READ_DOUBLE_FIELD(p, offset) \
@@ -1684,6 +1705,8 @@ CAST_ACCESSOR(FixedArray)
 CAST_ACCESSOR(DescriptorArray)
 CAST_ACCESSOR(SymbolTable)
 CAST_ACCESSOR(JSFunctionResultCache)
+CAST_ACCESSOR(AllocationSite)
+CAST_ACCESSOR(AllocationMemento)
 CAST_ACCESSOR(CompilationCacheTable)
 CAST_ACCESSOR(CodeCacheHashTable)
 CAST_ACCESSOR(MapCache)
@@ -1953,6 +1976,54 @@ void JSFunctionResultCache::Clear() {
 }
 
 
+AllocationSite::State AllocationSite::state() {
+  return static_cast<State>(Smi::cast(get(kStateIndex))->value());
+}
+
+
+void AllocationSite::set_state(State state) {
+  set(kStateIndex, Smi::FromInt(state));
+}
+
+
+PretenureFlag AllocationSite::GetPretenureMode() {
+  return state() == kTenure ? TENURED : NOT_TENURED;
+}
+
+
+int AllocationSite::memento_create_count() {
+  return Smi::cast(get(kMementoCreateCountIndex))->value();
+}
+
+
+int AllocationSite::memento_found_count() {
+  return Smi::cast(get(kMementoFoundCountIndex))->value();
+}
+
+
+void AllocationSite::IncrementMementoCreateCount() {
+  set(kMementoCreateCountIndex, Smi::FromInt(memento_create_count() + 1));
+}
+
+
+void AllocationSite::IncrementMementoFoundCount() {
+  set(kMementoFoundCountIndex, Smi::FromInt(memento_found_count() + 1));
+}
+
+
+AllocationSite* AllocationMemento::allocation_site() {
+  return reinterpret_cast<AllocationSite*>(
+      READ_FIELD(this, kAllocationSiteOffset));
+}
+
+
+void AllocationMemento::set_allocation_site(AllocationSite* site) {
+  // Mementos live in new space, so there is no write barrier.
+  ASSERT(Heap::InNewSpace(this));
+  WRITE_FIELD(this, kAllocationSiteOffset, site);
+}
+
+
 byte ByteArray::get(int index) {
   ASSERT(index >= 0 && index < this->length());
   return READ_BYTE_FIELD(this, kHeaderSize + index * kCharSize);
@@ -2331,14 +2402,18 @@ int Code::arguments_count() {
 
 
 CodeStub::Major Code::major_key() {
-  ASSERT(kind() == STUB || kind() == BINARY_OP_IC);
+  ASSERT(kind() == STUB ||
+         kind() == BINARY_OP_IC ||
+         kind() == COMPARE_IC);
   return static_cast<CodeStub::Major>(READ_BYTE_FIELD(this,
                                                       kStubMajorKeyOffset));
 }
 
 
 void Code::set_major_key(CodeStub::Major major) {
-  ASSERT(kind() == STUB || kind() == BINARY_OP_IC);
+  ASSERT(kind() == STUB ||
+         kind() == BINARY_OP_IC ||
+         kind() == COMPARE_IC);
   ASSERT(0 <= major && major < 256);
   WRITE_BYTE_FIELD(this, kStubMajorKeyOffset, major);
 }
@@ -2580,6 +2655,7 @@ ACCESSORS(SharedFunctionInfo, debug_info, Object, kDebugInfoOffset)
 ACCESSORS(SharedFunctionInfo, inferred_name, String, kInferredNameOffset)
 ACCESSORS(SharedFunctionInfo, this_property_assignments, Object,
           kThisPropertyAssignmentsOffset)
+ACCESSORS(SharedFunctionInfo, allocation_site, Object, kAllocationSiteOffset)
 
 BOOL_ACCESSORS(FunctionTemplateInfo, flag, hidden_prototype,
                kHiddenPrototypeBit)
@@ -2601,6 +2677,10 @@ BOOL_ACCESSORS(SharedFunctionInfo,
                compiler_hints,
                allows_lazy_compilation,
                kAllowLazyCompilation)
+BOOL_ACCESSORS(SharedFunctionInfo,
+               compiler_hints,
+               is_optimized,
+               kIsOptimized)
 
 
 #if V8_HOST_ARCH_32_BIT
@@ -2619,6 +2699,7 @@ SMI_ACCESSORS(SharedFunctionInfo, compiler_hints,
               kCompilerHintsOffset)
 SMI_ACCESSORS(SharedFunctionInfo, this_property_assignments_count,
               kThisPropertyAssignmentsCountOffset)
+SMI_ACCESSORS(SharedFunctionInfo, tier_up_counter, kTierUpCounterOffset)
 #else
 
 #define PSEUDO_SMI_ACCESSORS_LO(holder, name, offset)             \
@@ -2661,6 +2742,8 @@ PSEUDO_SMI_ACCESSORS_HI(SharedFunctionInfo, compiler_hints,
 
 PSEUDO_SMI_ACCESSORS_LO(SharedFunctionInfo, this_property_assignments_count,
               kThisPropertyAssignmentsCountOffset)
+PSEUDO_SMI_ACCESSORS_HI(SharedFunctionInfo, tier_up_counter,
+              kTierUpCounterOffset)
 #endif
 
 ACCESSORS(CodeCache, default_cache, FixedArray, kDefaultCacheOffset)
@@ -2785,6 +2868,7 @@ void JSFunction::set_code(Code* value) {
   ASSERT(!Heap::InNewSpace(value));
   Address entry = value->entry();
   WRITE_INTPTR_FIELD(this, kCodeEntryOffset, reinterpret_cast<intptr_t>(entry));
+  IncrementalMarking::RecordWriteOf(value);
 }
 
 
@@ -3365,6 +3449,8 @@ void Map::ClearCodeCache() {
   // No write barrier is needed since empty_fixed_array is not in new space.
   // Please note this function is used during marking:
   //  - MarkCompactCollector::MarkUnmarkedObject
+  //  - ParallelMarkingVisitor::MarkObject
+  //  - IncrementalMarking::VisitObject
   ASSERT(!Heap::InNewSpace(Heap::raw_unchecked_empty_fixed_array()));
   WRITE_FIELD(this, kCodeCacheOffset, Heap::raw_unchecked_empty_fixed_array());
 }
@@ -3519,6 +3519,29 @@ bool FixedArray::IsEqualTo(FixedArray* other) {
 #endif
 
 
+void AllocationSite::DigestPretenuringFeedback() {
+  ASSERT(state() == kPending);
+  int created = memento_create_count();
+  int found = memento_found_count();
+  bool tenure = found * 100 >= created * kTenureSurvivalPercentage;
+  set_state(tenure ? kTenure : kDontTenure);
+  if (FLAG_trace_pretenuring) {
+    PrintF("AllocationSite %p: %d of %d mementos found, %s\n",
+           reinterpret_cast<void*>(this),
+           found,
+           created,
+           tenure ? "tenuring" : "not tenuring");
+  }
+}
+
+
+void AllocationSite::ResetPretenuringFeedback() {
+  set_state(kCollecting);
+  set(kMementoCreateCountIndex, Smi::FromInt(0));
+  set(kMementoFoundCountIndex, Smi::FromInt(0));
+}
+
+
 Object* DescriptorArray::Allocate(int number_of_descriptors) {
   if (number_of_descriptors == 0) {
     return Heap::empty_descriptor_array();
@@ -5377,6 +5400,7 @@ const char* Code::Kind2String(Kind kind) {
     case CALL_IC: return "CALL_IC";
     case KEYED_CALL_IC: return "KEYED_CALL_IC";
     case BINARY_OP_IC: return "BINARY_OP_IC";
+    case COMPARE_IC: return "COMPARE_IC";
   }
   UNREACHABLE();
   return NULL;
@@ -5389,6 +5413,7 @@ const char* Code::ICState2String(InlineCacheState state) {
     case PREMONOMORPHIC: return "PREMONOMORPHIC";
     case MONOMORPHIC: return "MONOMORPHIC";
     case MONOMORPHIC_PROTOTYPE_FAILURE: return "MONOMORPHIC_PROTOTYPE_FAILURE";
+    case POLYMORPHIC: return "POLYMORPHIC";
     case MEGAMORPHIC: return "MEGAMORPHIC";
     case DEBUG_BREAK: return "DEBUG_BREAK";
     case DEBUG_PREPARE_STEP_IN: return "DEBUG_PREPARE_STEP_IN";
@@ -75,6 +75,7 @@
 //           - MapCache
 //         - Context
 //         - JSFunctionResultCache
+//         - AllocationSite
 //         - SerializedScopeInfo
 //       - String
 //         - SeqString
@@ -85,6 +86,7 @@
 //           - ExternalAsciiString
 //           - ExternalTwoByteString
 //       - HeapNumber
+//       - AllocationMemento
 //       - Code
 //       - Map
 //       - Oddball
@@ -638,6 +640,8 @@ class Object BASE_EMBEDDED {
   inline bool IsDictionary();
   inline bool IsSymbolTable();
   inline bool IsJSFunctionResultCache();
+  inline bool IsAllocationSite();
+  inline bool IsAllocationMemento();
   inline bool IsCompilationCacheTable();
   inline bool IsCodeCacheHashTable();
   inline bool IsMapCache();
@@ -2465,6 +2469,85 @@ class JSFunctionResultCache: public FixedArray {
 };
 
 
+// AllocationSite collects survival feedback for the objects created by one
+// object or array literal, or by one constructor, and decides whether those
+// objects are allocated directly in old space.  While the site collects
+// feedback the runtime places an AllocationMemento behind every object it
+// allocates in new space, and the scavenger counts the mementos of the
+// objects that survive.
+class AllocationSite: public FixedArray {
+ public:
+  // The code stubs only allocate inline for states from kPending on; in the
+  // other states they call the runtime.
+  enum State {
+    // The runtime allocates the objects in new space, behind mementos.
+    kCollecting = 0,
+    // The runtime allocates the objects in old space.
+    kTenure = 1,
+    // Enough mementos were placed; the next scavenge decides.
+    kPending = 2,
+    // The objects are allocated in new space.
+    kDontTenure = 3
+  };
+
+  static const int kStateIndex = 0;
+  static const int kMementoCreateCountIndex = kStateIndex + 1;
+  static const int kMementoFoundCountIndex = kMementoCreateCountIndex + 1;
+  static const int kLength = kMementoFoundCountIndex + 1;
+
+  static const int kStateOffset = kHeaderSize;
+
+  // Number of mementos a site places before it becomes pending.
+  static const int kMementoSampleSize = 100;
+  // Percentage of surviving mementos from which a site tenures its objects.
+  static const int kTenureSurvivalPercentage = 85;
+
+  inline State state();
+  inline void set_state(State state);
+
+  // TENURED iff the site decided to allocate its objects in old space.
+  inline PretenureFlag GetPretenureMode();
+
+  inline int memento_create_count();
+  inline int memento_found_count();
+  inline void IncrementMementoCreateCount();
+  inline void IncrementMementoFoundCount();
+
+  // Decides the state of a pending site from the collected counts.
+  void DigestPretenuringFeedback();
+
+  // Discards the collected counts and restarts collecting.
+  void ResetPretenuringFeedback();
+
+  // Casting
+  static inline AllocationSite* cast(Object* obj);
+
+#ifdef DEBUG
+  void AllocationSiteVerify();
+#endif
+};
+
+
+// AllocationMemento is a two word filler that the runtime places directly
+// behind an object it allocates in new space on behalf of an AllocationSite.
+// The garbage collector does not visit the site pointer, so a memento is only
+// meaningful until the next collection.
+class AllocationMemento: public HeapObject {
+ public:
+  inline AllocationSite* allocation_site();
+  inline void set_allocation_site(AllocationSite* site);
+
+  // Casting
+  static inline AllocationMemento* cast(Object* obj);
+
+  static const int kAllocationSiteOffset = HeapObject::kHeaderSize;
+  static const int kSize = kAllocationSiteOffset + kPointerSize;
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(AllocationMemento);
+};
+
+
 // ByteArray represents fixed sized byte arrays.  Used by the outside world,
 // such as PCRE, and also by the memory allocator and garbage collector to
 // fill in free blocks in the heap.
@@ -2800,13 +2883,14 @@ class Code: public HeapObject {
     STORE_IC,
     KEYED_STORE_IC,
     BINARY_OP_IC,
+    COMPARE_IC,
     // No more than 16 kinds. The value currently encoded in four bits in
     // Flags.
 
     // Pseudo-kinds.
     REGEXP = BUILTIN,
     FIRST_IC_KIND = LOAD_IC,
-    LAST_IC_KIND = BINARY_OP_IC
+    LAST_IC_KIND = COMPARE_IC
   };
 
   enum {
@@ -2853,7 +2937,7 @@ class Code: public HeapObject {
   inline bool is_call_stub() { return kind() == CALL_IC; }
   inline bool is_keyed_call_stub() { return kind() == KEYED_CALL_IC; }
 
-  // [major_key]: For kind STUB or BINARY_OP_IC, the major key.
+  // [major_key]: For kind STUB, BINARY_OP_IC or COMPARE_IC, the major key.
   inline CodeStub::Major major_key();
   inline void set_major_key(CodeStub::Major major);
 
@@ -3431,6 +3515,10 @@ class SharedFunctionInfo: public HeapObject {
   // [debug info]: Debug information.
   DECL_ACCESSORS(debug_info, Object)
 
+  // [allocation site]: The AllocationSite of the objects constructed by this
+  // function, or undefined if none was created yet.
+  DECL_ACCESSORS(allocation_site, Object)
+
   // [inferred name]: Name inferred from variable or property
   // assignment of this function. Used to facilitate debugging and
   // profiling of JavaScript code written in OO style, where almost
@@ -3492,6 +3580,16 @@ class SharedFunctionInfo: public HeapObject {
   inline int code_age();
   inline void set_code_age(int age);
 
+  // Indicates that the code for this function was produced by recompiling
+  // hot full-codegen code with the optimizing code generator.
+  inline bool is_optimized();
+  inline void set_is_optimized(bool flag);
+
+  // [tier_up_counter]: Number of invocations and loop iterations left
+  // before the full-codegen code of this function asks to be recompiled
+  // with the optimizing code generator (see --tiered-compilation).
+  inline int tier_up_counter();
+  inline void set_tier_up_counter(int value);
 
   // Check whether a inlined constructor can be generated with the given
   // prototype.
@@ -3546,10 +3644,12 @@ class SharedFunctionInfo: public HeapObject {
   static const int kInferredNameOffset = kDebugInfoOffset + kPointerSize;
   static const int kThisPropertyAssignmentsOffset =
       kInferredNameOffset + kPointerSize;
+  static const int kAllocationSiteOffset =
+      kThisPropertyAssignmentsOffset + kPointerSize;
 #if V8_HOST_ARCH_32_BIT
   // Smi fields.
   static const int kLengthOffset =
-      kThisPropertyAssignmentsOffset + kPointerSize;
+      kAllocationSiteOffset + kPointerSize;
   static const int kFormalParameterCountOffset = kLengthOffset + kPointerSize;
   static const int kExpectedNofPropertiesOffset =
       kFormalParameterCountOffset + kPointerSize;
@@ -3565,8 +3665,10 @@ class SharedFunctionInfo: public HeapObject {
       kFunctionTokenPositionOffset + kPointerSize;
   static const int kThisPropertyAssignmentsCountOffset =
       kCompilerHintsOffset + kPointerSize;
+  static const int kTierUpCounterOffset =
+      kThisPropertyAssignmentsCountOffset + kPointerSize;
   // Total size.
-  static const int kSize = kThisPropertyAssignmentsCountOffset + kPointerSize;
+  static const int kSize = kTierUpCounterOffset + kPointerSize;
 #else
   // The only reason to use smi fields instead of int fields
   // is to allow interation without maps decoding during
@@ -3578,7 +3680,7 @@ class SharedFunctionInfo: public HeapObject {
   // word is not set and thus this word cannot be treated as pointer
   // to HeapObject during old space traversal.
   static const int kLengthOffset =
-      kThisPropertyAssignmentsOffset + kPointerSize;
+      kAllocationSiteOffset + kPointerSize;
   static const int kFormalParameterCountOffset =
       kLengthOffset + kIntSize;
 
@@ -3599,15 +3701,17 @@ class SharedFunctionInfo: public HeapObject {
 
   static const int kThisPropertyAssignmentsCountOffset =
       kCompilerHintsOffset + kIntSize;
+  static const int kTierUpCounterOffset =
+      kThisPropertyAssignmentsCountOffset + kIntSize;
 
   // Total size.
-  static const int kSize = kThisPropertyAssignmentsCountOffset + kIntSize;
+  static const int kSize = kTierUpCounterOffset + kIntSize;
 
 #endif
   static const int kAlignedSize = POINTER_SIZE_ALIGN(kSize);
 
   typedef FixedBodyDescriptor<kNameOffset,
-                              kThisPropertyAssignmentsOffset + kPointerSize,
+                              kAllocationSiteOffset + kPointerSize,
                               kSize> BodyDescriptor;
 
  private:
@@ -3625,6 +3729,7 @@ class SharedFunctionInfo: public HeapObject {
   static const int kAllowLazyCompilation = 2;
   static const int kCodeAgeShift = 3;
   static const int kCodeAgeMask = 7;
+  static const int kIsOptimized = 6;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(SharedFunctionInfo);
 };
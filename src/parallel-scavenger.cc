@@ -0,0 +1,755 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "v8.h"
+
+#include "heap-profiler.h"
+#include "incremental-marking.h"
+#include "parallel-scavenger.h"
+#include "work-stealing-deque.h"
+
+namespace v8 {
+namespace internal {
+
+// Sizes of the linear allocation buffers.  Objects larger than a quarter of
+// a buffer are allocated directly in the space, so at most a quarter of a
+// buffer is wasted when it is replaced.
+static const int kNewSpaceBufferSize = 8 * KB;
+static const int kOldSpaceBufferSize = 2 * KB;
+
+// Root slots are claimed in chunks of this many slots.
+static const int kRootSlotChunkSize = 64;
+
+
+// Fills memory that was allocated but is not used with a filler object,
+// which keeps the space iterable.  The memory is cleared first, because it
+// may hold stale pointers into the from space and lie in a dirty region of
+// the old generation.
+static void CreateFillerObjectAt(Address start, int size_in_bytes) {
+  memset(start, 0, size_in_bytes);
+  Heap::CreateFillerObjectAt(start, size_in_bytes);
+}
+
+
+// A linear allocation buffer owned by one scavenging thread.
+class LocalAllocationBuffer {
+ public:
+  LocalAllocationBuffer() : top_(NULL), limit_(NULL) { }
+
+  inline HeapObject* Allocate(int size_in_bytes) {
+    if (limit_ - top_ < size_in_bytes) return NULL;
+    HeapObject* object = HeapObject::FromAddress(top_);
+    top_ += size_in_bytes;
+    return object;
+  }
+
+  // Give back the object allocated last, if it was allocated in this
+  // buffer.  Its memory is filled when the buffer is closed.
+  inline bool Undo(HeapObject* object, int size_in_bytes) {
+    if (object->address() + size_in_bytes != top_) return false;
+    top_ = object->address();
+    return true;
+  }
+
+  // Put a filler object in the unused part of the buffer and forget the
+  // buffer.
+  void Close() {
+    if (top_ != limit_) {
+      CreateFillerObjectAt(top_, static_cast<int>(limit_ - top_));
+    }
+    top_ = limit_ = NULL;
+  }
+
+  void Reset(Address start, int size_in_bytes) {
+    ASSERT(top_ == NULL);
+    top_ = start;
+    limit_ = start + size_in_bytes;
+  }
+
+ private:
+  Address top_;
+  Address limit_;
+};
+
+
+// A page of the old pointer space or the map space with dirty regions, and
+// the end of the part of the page that is scanned for pointers into the new
+// space.
+struct DirtyPage {
+  Page* page;
+  Address end;
+  DirtyRegionCallback visit_dirty_region;
+};
+
+
+// Region marks of a page that hold a promoted object pointing into the new
+// space.
+struct PromotedRegionMarks {
+  Page* page;
+  uint32_t marks;
+};
+
+
+class ScavengingTask;
+class ScavengingThread;
+
+static ScavengingTask* tasks[GCTracer::kMaxScavengingThreads];
+static ScavengingThread* threads[GCTracer::kMaxScavengingThreads];
+static int thread_count = 0;
+static int idle_thread_count = 0;
+
+enum ScavengingPhase { SCAVENGE_ROOTS, SCAVENGE_COPIED_OBJECTS };
+static ScavengingPhase phase = SCAVENGE_ROOTS;
+
+// Protects the claiming of root slots and dirty pages, and the count of
+// idle threads.
+static Mutex* mutex = NULL;
+
+// Protects allocation in the spaces.
+static Mutex* allocation_mutex = NULL;
+
+// Holds the task of the current thread, for the dirty region callback.
+static Thread::LocalStorageKey task_key;
+
+static List<Object**>* root_slots = NULL;
+static int next_root_slot = 0;
+static List<DirtyPage>* dirty_pages = NULL;
+static int next_dirty_page = 0;
+
+
+// Replaces the map word of a from space object with a forwarding address.
+// Returns false if another thread has already done so.
+static inline bool InstallForwardingAddress(HeapObject* object,
+                                            Map* map,
+                                            HeapObject* target) {
+  volatile AtomicWord* map_word_address =
+      reinterpret_cast<volatile AtomicWord*>(object->address());
+  AtomicWord map_word = reinterpret_cast<AtomicWord>(map);
+  AtomicWord forwarding_address =
+      reinterpret_cast<AtomicWord>(target->address());
+  return OS::CompareAndSwap(map_word_address, map_word, forwarding_address)
+      == map_word;
+}
+
+
+// Counts a memento found behind a surviving object on its allocation site.
+// Several threads may find mementos of the same site at once.
+static inline void IncrementMementoFoundCount(AllocationSite* site) {
+  volatile AtomicWord* count_address =
+      reinterpret_cast<volatile AtomicWord*>(site->address() +
+          FixedArray::OffsetOfElementAt(
+              AllocationSite::kMementoFoundCountIndex));
+  AtomicWord count;
+  AtomicWord new_count;
+  do {
+    count = *count_address;
+    Smi* value = reinterpret_cast<Smi*>(count);
+    new_count = reinterpret_cast<AtomicWord>(Smi::FromInt(value->value() + 1));
+  } while (OS::CompareAndSwap(count_address, count, new_count) != count);
+}
+
+
+static inline bool IsShortcutCandidate(InstanceType type) {
+  return ((type & kShortcutTypeMask) == kShortcutTypeTag);
+}
+
+
+// Visits the pointers of objects copied by a scavenging thread.  For
+// promoted objects the region marks of the slots that still point into the
+// new space are collected.
+class ParallelScavengingVisitor : public ObjectVisitor {
+ public:
+  explicit ParallelScavengingVisitor(ScavengingTask* task)
+      : task_(task), page_(NULL), marks_(0) { }
+
+  void VisitPointer(Object** p) { ScavengePointer(p); }
+
+  void VisitPointers(Object** start, Object** end) {
+    for (Object** p = start; p < end; p++) ScavengePointer(p);
+  }
+
+  // Start collecting region marks for an object on the given page, or stop
+  // collecting them if page is NULL.
+  void set_page(Page* page) {
+    page_ = page;
+    marks_ = Page::kAllRegionsCleanMarks;
+  }
+
+  uint32_t marks() { return marks_; }
+
+ private:
+  inline void ScavengePointer(Object** p);
+
+  ScavengingTask* task_;
+  Page* page_;
+  uint32_t marks_;
+};
+
+
+// The state of a scavenging thread.
+class ScavengingTask {
+ public:
+  explicit ScavengingTask(int thread)
+      : thread_(thread), time_(0), copied_bytes_(0), promoted_bytes_(0) { }
+
+  // Copy a from space object, unless another thread already has, and
+  // update the slot pointing to it.
+  void ScavengeObject(HeapObject** slot, HeapObject* object);
+
+  // First phase: copy the objects pointed to by the root slots and dirty
+  // regions claimed by this thread.
+  void ScavengeRoots();
+
+  // Second phase: visit the copied objects on the deque of this thread and
+  // objects stolen from other threads until all threads run out of work.
+  void ScavengeCopiedObjects();
+
+  // Fill the unused parts of the allocation buffers, set the region marks
+  // collected for promoted objects and report the statistics of this
+  // scavenge.
+  void Finish();
+
+  WorkStealingDeque* deque() { return &deque_; }
+
+  int promoted_bytes() { return promoted_bytes_; }
+
+ private:
+  void ScavengeDirtyPage(const DirtyPage& dirty_page);
+  void VisitCopiedObject(ParallelScavengingVisitor* visitor,
+                         HeapObject* object);
+
+  HeapObject* Allocate(AllocationSpace space, int size_in_bytes);
+  HeapObject* AllocateSlow(AllocationSpace space,
+                           LocalAllocationBuffer* buffer,
+                           int size_in_bytes);
+  void Undo(HeapObject* object, int size_in_bytes);
+
+  LocalAllocationBuffer* BufferFor(AllocationSpace space) {
+    switch (space) {
+      case NEW_SPACE: return &new_space_buffer_;
+      case OLD_POINTER_SPACE: return &old_pointer_space_buffer_;
+      case OLD_DATA_SPACE: return &old_data_space_buffer_;
+      default: return NULL;
+    }
+  }
+
+  int thread_;
+  WorkStealingDeque deque_;
+  LocalAllocationBuffer new_space_buffer_;
+  LocalAllocationBuffer old_pointer_space_buffer_;
+  LocalAllocationBuffer old_data_space_buffer_;
+  List<PromotedRegionMarks> region_marks_;
+
+  // Time spent scavenging (excluding time spent waiting for work), and
+  // bytes copied and promoted by this thread in the current scavenge.
+  double time_;
+  int copied_bytes_;
+  int promoted_bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScavengingTask);
+};
+
+
+void ParallelScavengingVisitor::ScavengePointer(Object** p) {
+  Object* object = *p;
+  if (!Heap::InFromSpace(object)) return;
+  task_->ScavengeObject(reinterpret_cast<HeapObject**>(p),
+                        reinterpret_cast<HeapObject*>(object));
+  if (page_ != NULL && Heap::InNewSpace(*p)) {
+    marks_ |= page_->GetRegionMaskForAddress(reinterpret_cast<Address>(p));
+  }
+}
+
+
+class ScavengingThread : public Thread {
+ public:
+  explicit ScavengingThread(int thread)
+      : thread_(thread),
+        start_(OS::CreateSemaphore(0)),
+        done_(OS::CreateSemaphore(0)),
+        stopped_(false) { }
+
+  ~ScavengingThread() {
+    delete start_;
+    delete done_;
+  }
+
+  static void RunPhase(int thread) {
+    ScavengingTask* task = tasks[thread];
+    Thread::SetThreadLocal(task_key, task);
+    if (phase == SCAVENGE_ROOTS) {
+      task->ScavengeRoots();
+    } else {
+      task->ScavengeCopiedObjects();
+    }
+  }
+
+  void Run() {
+    while (true) {
+      start_->Wait();
+      if (stopped_) return;
+      RunPhase(thread_);
+      done_->Signal();
+    }
+  }
+
+  // Let the thread take part in the current phase.
+  void StartPhase() { start_->Signal(); }
+
+  // Wait for the thread to finish the current phase.
+  void WaitForPhase() { done_->Wait(); }
+
+  void Stop() {
+    stopped_ = true;
+    start_->Signal();
+    Join();
+  }
+
+ private:
+  int thread_;
+  Semaphore* start_;
+  Semaphore* done_;
+  volatile bool stopped_;
+};
+
+
+// Callback for the dirty regions of the old generation.
+static void ScavengePointerInDirtyRegion(HeapObject** p) {
+  HeapObject* object = *p;
+  if (!Heap::InFromSpace(object)) return;
+  ScavengingTask* task =
+      reinterpret_cast<ScavengingTask*>(Thread::GetThreadLocal(task_key));
+  task->ScavengeObject(p, object);
+}
+
+
+static bool ClaimRootSlots(int* start, int* end) {
+  ScopedLock lock(mutex);
+  if (next_root_slot == root_slots->length()) return false;
+  *start = next_root_slot;
+  *end = Min(root_slots->length(), next_root_slot + kRootSlotChunkSize);
+  next_root_slot = *end;
+  return true;
+}
+
+
+static DirtyPage* ClaimDirtyPage() {
+  ScopedLock lock(mutex);
+  if (next_dirty_page == dirty_pages->length()) return NULL;
+  return &dirty_pages->at(next_dirty_page++);
+}
+
+
+static bool StealWork(int thread) {
+  WorkStealingDeque* deque = tasks[thread]->deque();
+  for (int i = 0; i < thread_count; i++) {
+    if (deque->StealFrom(tasks[(thread + i) % thread_count]->deque())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+// Called by a thread that ran out of work.  Returns true when all threads
+// are out of work and false when there might be work to steal.
+static bool WaitForWorkOrTermination() {
+  {
+    ScopedLock lock(mutex);
+    idle_thread_count++;
+  }
+  while (true) {
+    bool work_available = false;
+    for (int i = 0; i < thread_count; i++) {
+      if (tasks[i]->deque()->HasSharedWork()) {
+        work_available = true;
+        break;
+      }
+    }
+    {
+      ScopedLock lock(mutex);
+      // Only a thread with objects left to visit can create more work, so
+      // once every thread is idle no new work can appear.
+      if (idle_thread_count == thread_count) return true;
+      if (work_available) {
+        idle_thread_count--;
+        return false;
+      }
+    }
+    Thread::YieldCPU();
+  }
+}
+
+
+void ScavengingTask::ScavengeObject(HeapObject** slot, HeapObject* object) {
+  ASSERT(Heap::InFromSpace(object));
+  MapWord map_word = object->map_word();
+  if (map_word.IsForwardingAddress()) {
+    *slot = map_word.ToForwardingAddress();
+    return;
+  }
+
+  Map* map = map_word.ToMap();
+  InstanceType type = map->instance_type();
+
+  // Cons strings with an empty second part are replaced by their first
+  // part, like in the serial scavenger.  All threads racing for such a
+  // string install the same forwarding address.
+  if (IsShortcutCandidate(type) &&
+      reinterpret_cast<ConsString*>(object)->unchecked_second() ==
+          Heap::empty_string()) {
+    HeapObject* first = HeapObject::cast(
+        reinterpret_cast<ConsString*>(object)->unchecked_first());
+    if (Heap::InNewSpace(first)) ScavengeObject(&first, first);
+    *slot = first;
+    InstallForwardingAddress(object, map, first);
+    return;
+  }
+
+  int object_size = object->SizeFromMap(map);
+  AllocationSpace target_space = Heap::TargetSpaceId(type);
+  AllocationSpace promotion_space =
+      (object_size > Page::kMaxHeapObjectSize) ? LO_SPACE : target_space;
+
+  HeapObject* target = NULL;
+  bool should_be_promoted =
+      Heap::ShouldBePromoted(object->address(), object_size);
+  if (should_be_promoted) target = Allocate(promotion_space, object_size);
+  if (target == NULL) target = Allocate(NEW_SPACE, object_size);
+  // Buffers that are partly unused can exhaust the to space, in which case
+  // the object is promoted even if it is young.
+  if (target == NULL && !should_be_promoted) {
+    target = Allocate(promotion_space, object_size);
+  }
+  if (target == NULL) {
+    V8::FatalProcessOutOfMemory("ParallelScavenger");
+  }
+
+  Heap::CopyBlock(target->address(), object->address(), object_size);
+  if (!InstallForwardingAddress(object, map, target)) {
+    Undo(target, object_size);
+    *slot = object->map_word().ToForwardingAddress();
+    return;
+  }
+  *slot = target;
+
+  AllocationMemento* memento =
+      Heap::FindAllocationMemento(object, object_size);
+  if (memento != NULL) IncrementMementoFoundCount(memento->allocation_site());
+
+  copied_bytes_ += object_size;
+  if (!Heap::InNewSpace(target)) promoted_bytes_ += object_size;
+  if (target_space == OLD_POINTER_SPACE) deque_.Push(target);
+}
+
+
+void ScavengingTask::ScavengeRoots() {
+  double start_time = OS::TimeCurrentMillis();
+  ParallelScavengingVisitor visitor(this);
+  int start, end;
+  while (ClaimRootSlots(&start, &end)) {
+    for (int i = start; i < end; i++) visitor.VisitPointer(root_slots->at(i));
+  }
+  DirtyPage* dirty_page;
+  while ((dirty_page = ClaimDirtyPage()) != NULL) {
+    ScavengeDirtyPage(*dirty_page);
+  }
+  time_ += OS::TimeCurrentMillis() - start_time;
+}
+
+
+void ScavengingTask::ScavengeDirtyPage(const DirtyPage& dirty_page) {
+  // Same as the body of the page loop in Heap::IterateDirtyRegions.  The
+  // watermark was invalidated when the page was collected, and incremental
+  // marking is never in progress.
+  Page* page = dirty_page.page;
+  uint32_t marks = page->GetRegionMarks();
+  uint32_t newmarks = Heap::IterateDirtyRegions(marks,
+                                                page->ObjectAreaStart(),
+                                                dirty_page.end,
+                                                dirty_page.visit_dirty_region,
+                                                &ScavengePointerInDirtyRegion);
+  page->SetRegionMarks(newmarks);
+}
+
+
+void ScavengingTask::ScavengeCopiedObjects() {
+  double start_time = OS::TimeCurrentMillis();
+  double idle_time = 0;
+  ParallelScavengingVisitor visitor(this);
+  while (true) {
+    HeapObject* object;
+    while (deque_.Pop(&object)) VisitCopiedObject(&visitor, object);
+    if (StealWork(thread_)) continue;
+    double idle_start_time = OS::TimeCurrentMillis();
+    bool done = WaitForWorkOrTermination();
+    idle_time += OS::TimeCurrentMillis() - idle_start_time;
+    if (done) break;
+  }
+  time_ += OS::TimeCurrentMillis() - start_time - idle_time;
+}
+
+
+void ScavengingTask::VisitCopiedObject(ParallelScavengingVisitor* visitor,
+                                       HeapObject* object) {
+  Map* map = object->map();
+  Page* page = NULL;
+  if (!Heap::InNewSpace(object)) page = Page::FromAddress(object->address());
+  visitor->set_page(page);
+  object->IterateBody(map->instance_type(), object->SizeFromMap(map), visitor);
+  if (visitor->marks() != Page::kAllRegionsCleanMarks) {
+    PromotedRegionMarks region_marks = { page, visitor->marks() };
+    region_marks_.Add(region_marks);
+  }
+}
+
+
+void ScavengingTask::Finish() {
+  new_space_buffer_.Close();
+  old_pointer_space_buffer_.Close();
+  old_data_space_buffer_.Close();
+
+  for (int i = 0; i < region_marks_.length(); i++) {
+    Page* page = region_marks_[i].page;
+    page->SetRegionMarks(page->GetRegionMarks() | region_marks_[i].marks);
+  }
+  region_marks_.Rewind(0);
+
+  Heap::tracer()->AddScavengingThreadStats(thread_, time_, copied_bytes_);
+  time_ = 0;
+  copied_bytes_ = 0;
+  promoted_bytes_ = 0;
+}
+
+
+HeapObject* ScavengingTask::Allocate(AllocationSpace space,
+                                     int size_in_bytes) {
+  LocalAllocationBuffer* buffer = BufferFor(space);
+  if (buffer != NULL) {
+    HeapObject* object = buffer->Allocate(size_in_bytes);
+    if (object != NULL) return object;
+  }
+  return AllocateSlow(space, buffer, size_in_bytes);
+}
+
+
+static Object* AllocateRaw(AllocationSpace space, int size_in_bytes) {
+  switch (space) {
+    case NEW_SPACE:
+      return Heap::new_space()->AllocateRaw(size_in_bytes);
+    case OLD_POINTER_SPACE:
+      return Heap::old_pointer_space()->AllocateRaw(size_in_bytes);
+    case OLD_DATA_SPACE:
+      return Heap::old_data_space()->AllocateRaw(size_in_bytes);
+    case LO_SPACE:
+      return Heap::lo_space()->AllocateRawFixedArray(size_in_bytes);
+    default:
+      UNREACHABLE();
+      return NULL;
+  }
+}
+
+
+HeapObject* ScavengingTask::AllocateSlow(AllocationSpace space,
+                                         LocalAllocationBuffer* buffer,
+                                         int size_in_bytes) {
+  ScopedLock lock(allocation_mutex);
+  int buffer_size =
+      (space == NEW_SPACE) ? kNewSpaceBufferSize : kOldSpaceBufferSize;
+  if (buffer != NULL && size_in_bytes <= buffer_size / 4) {
+    Object* result = AllocateRaw(space, buffer_size);
+    if (!result->IsFailure()) {
+      buffer->Close();
+      buffer->Reset(HeapObject::cast(result)->address(), buffer_size);
+      return buffer->Allocate(size_in_bytes);
+    }
+  }
+  Object* result = AllocateRaw(space, size_in_bytes);
+  if (result->IsFailure()) return NULL;
+  return HeapObject::cast(result);
+}
+
+
+void ScavengingTask::Undo(HeapObject* object, int size_in_bytes) {
+  if (new_space_buffer_.Undo(object, size_in_bytes) ||
+      old_pointer_space_buffer_.Undo(object, size_in_bytes) ||
+      old_data_space_buffer_.Undo(object, size_in_bytes)) {
+    return;
+  }
+  CreateFillerObjectAt(object->address(), size_in_bytes);
+}
+
+
+// Collects the root slots that point into the from space.
+class RootSlotCollector : public ObjectVisitor {
+ public:
+  void VisitPointers(Object** start, Object** end) {
+    for (Object** p = start; p < end; p++) {
+      if (Heap::InFromSpace(*p)) root_slots->Add(p);
+    }
+  }
+};
+
+
+static void CollectDirtyPages(PagedSpace* space,
+                              DirtyRegionCallback visit_dirty_region) {
+  PageIterator it(space, PageIterator::PAGES_IN_USE);
+  while (it.has_next()) {
+    Page* page = it.next();
+    if (page->GetRegionMarks() != Page::kAllRegionsCleanMarks) {
+      // Do not visit pointers beyond the allocation watermark, see
+      // Heap::IterateDirtyRegions.
+      DirtyPage dirty_page;
+      dirty_page.page = page;
+      dirty_page.end = page->IsWatermarkValid()
+          ? page->AllocationWatermark()
+          : page->CachedAllocationWatermark();
+      dirty_page.visit_dirty_region = visit_dirty_region;
+      dirty_pages->Add(dirty_page);
+    }
+    // Invalidate the watermark before any thread allocates, since the page
+    // flags are not updated atomically.  The end of the scanned area is
+    // already recorded.
+    page->InvalidateWatermark(true);
+  }
+}
+
+
+static void RunPhase(ScavengingPhase next_phase) {
+  phase = next_phase;
+  idle_thread_count = 0;
+  for (int i = 1; i < thread_count; i++) threads[i]->StartPhase();
+  ScavengingThread::RunPhase(0);
+  for (int i = 1; i < thread_count; i++) threads[i]->WaitForPhase();
+}
+
+
+bool ParallelScavenger::IsEnabled() {
+  if (!FLAG_parallel_scavenge) return false;
+  // Incremental marking records every object allocated in the old
+  // generation, and the statistics and move events of copied objects are
+  // not thread safe.
+  if (IncrementalMarking::IsMarking()) return false;
+#ifdef DEBUG
+  if (FLAG_heap_stats) return false;
+#endif
+#ifdef ENABLE_LOGGING_AND_PROFILING
+  if (FLAG_log_gc || HeapProfiler::is_profiling()) return false;
+#endif
+  return true;
+}
+
+
+void ParallelScavenger::Scavenge() {
+  ASSERT(IsEnabled());
+  thread_count = Max(1, Min(FLAG_scavenge_threads,
+                            GCTracer::kMaxScavengingThreads));
+  if (mutex == NULL) {
+    mutex = OS::CreateMutex();
+    allocation_mutex = OS::CreateMutex();
+    task_key = Thread::CreateThreadLocalKey();
+    root_slots = new List<Object**>();
+    dirty_pages = new List<DirtyPage>();
+  }
+  for (int i = 0; i < thread_count; i++) {
+    if (tasks[i] == NULL) tasks[i] = new ScavengingTask(i);
+    if (i > 0 && threads[i] == NULL) {
+      threads[i] = new ScavengingThread(i);
+      threads[i]->Start();
+    }
+  }
+
+  // Collect the roots.  By definition there are no intergenerational
+  // pointers in the code and data spaces; the values of cells are roots.
+  RootSlotCollector collector;
+  Heap::IterateRoots(&collector, VISIT_ALL_IN_SCAVENGE);
+  HeapObjectIterator cell_iterator(Heap::cell_space());
+  for (HeapObject* cell = cell_iterator.next();
+       cell != NULL; cell = cell_iterator.next()) {
+    if (cell->IsJSGlobalPropertyCell()) {
+      Address value_address =
+          reinterpret_cast<Address>(cell) +
+          (JSGlobalPropertyCell::kValueOffset - kHeapObjectTag);
+      collector.VisitPointer(reinterpret_cast<Object**>(value_address));
+    }
+  }
+  CollectDirtyPages(Heap::old_pointer_space(),
+                    &Heap::IteratePointersInDirtyRegion);
+  CollectDirtyPages(Heap::map_space(), &Heap::IteratePointersInDirtyMapsRegion);
+  next_root_slot = 0;
+  next_dirty_page = 0;
+
+  // The large object space is not expected to grow during a scavenge, but
+  // its chunks are scanned before any other thread starts to be sure.
+  Thread::SetThreadLocal(task_key, tasks[0]);
+  Heap::lo_space()->IterateDirtyRegions(&ScavengePointerInDirtyRegion);
+
+  {
+    // The old spaces are only allocated in linearly, above the scanned
+    // parts of their pages, while dirty regions are scanned.
+    LinearAllocationScope scope;
+    RunPhase(SCAVENGE_ROOTS);
+  }
+  RunPhase(SCAVENGE_COPIED_OBJECTS);
+
+  int promoted_bytes = 0;
+  for (int i = 0; i < thread_count; i++) {
+    ASSERT(tasks[i]->deque()->IsEmpty());
+    promoted_bytes += tasks[i]->promoted_bytes();
+    tasks[i]->Finish();
+  }
+  Heap::tracer()->increment_promoted_objects_size(promoted_bytes);
+  root_slots->Rewind(0);
+  dirty_pages->Rewind(0);
+}
+
+
+void ParallelScavenger::TearDown() {
+  for (int i = 0; i < GCTracer::kMaxScavengingThreads; i++) {
+    if (threads[i] != NULL) {
+      threads[i]->Stop();
+      delete threads[i];
+      threads[i] = NULL;
+    }
+    delete tasks[i];
+    tasks[i] = NULL;
+  }
+  if (mutex != NULL) {
+    delete mutex;
+    mutex = NULL;
+    delete allocation_mutex;
+    allocation_mutex = NULL;
+    Thread::DeleteThreadLocalKey(task_key);
+    delete root_slots;
+    root_slots = NULL;
+    delete dirty_pages;
+    dirty_pages = NULL;
+  }
+}
+
+} }  // namespace v8::internal
@@ -0,0 +1,77 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef V8_PARALLEL_SCAVENGER_H_
+#define V8_PARALLEL_SCAVENGER_H_
+
+namespace v8 {
+namespace internal {
+
+// -------------------------------------------------------------------------
+// Parallel scavenger
+//
+// With --parallel-scavenge the live objects of the from space are copied
+// by --scavenge-threads threads, the main thread included.
+//
+// The main thread first collects the root slots that point into the new
+// space and the pages of the old pointer and map spaces that have dirty
+// regions.  In the first phase the threads claim chunks of root slots and
+// dirty pages and copy the objects they point to.  In the second phase the
+// threads visit the copied objects, using work-stealing deques (see
+// WorkStealingDeque), until no thread has work left.
+//
+// Each thread allocates from its own linear allocation buffers in the to
+// space, the old pointer space and the old data space; only refilling a
+// buffer takes a lock.  An object is copied into the buffer of the thread
+// that reaches it first and the forwarding address is installed in the
+// from space copy with a compare and swap.  A thread that loses the race
+// gives its copy back to its buffer and uses the winner's address.
+//
+// The first phase allocates in the old spaces linearly only, so promoted
+// objects are never placed in the dirty regions being scanned.  Region
+// marks for promoted objects that still point into the new space are
+// collected by each thread and set by the main thread at the end.
+//
+// Scavenges that happen while incremental marking is in progress, or while
+// copied objects are logged or profiled, use the serial scavenger.
+class ParallelScavenger : public AllStatic {
+ public:
+  // True if the next scavenge should be parallel.
+  static bool IsEnabled();
+
+  // Copy the live objects of the from space to the to space and the old
+  // spaces.  Called by Heap::Scavenge after the semispaces are flipped.
+  static void Scavenge();
+
+  // Stop the scavenging threads and free their buffers.
+  static void TearDown();
+};
+
+} }  // namespace v8::internal
+
+#endif  // V8_PARALLEL_SCAVENGER_H_
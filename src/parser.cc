@@ -732,6 +732,13 @@ class TemporaryScope BASE_EMBEDDED {
     materialized_literal_count_++;
     return next_index;
   }
+  // Object and array literals take a second slot, right behind their
+  // boilerplate, for the allocation site of the copies.
+  int NextBoilerplateLiteralIndex() {
+    int next_index = NextMaterializedLiteralIndex();
+    NextMaterializedLiteralIndex();
+    return next_index;
+  }
   int materialized_literal_count() { return materialized_literal_count_; }
 
   void SetThisPropertyAssignmentInfo(
@@ -3502,7 +3509,7 @@ Expression* Parser::ParseArrayLiteral(bool* ok) {
   Expect(Token::RBRACK, CHECK_OK);
 
   // Update the scope information before the pre-parsing bailout.
-  int literal_index = temp_scope_->NextMaterializedLiteralIndex();
+  int literal_index = temp_scope_->NextBoilerplateLiteralIndex();
 
   if (is_pre_parsing_) return NULL;
 
@@ -3795,7 +3802,7 @@ Expression* Parser::ParseObjectLiteral(bool* ok) {
   }
   Expect(Token::RBRACE, CHECK_OK);
   // Computation of literal_index must happen before pre parse bailout.
-  int literal_index = temp_scope_->NextMaterializedLiteralIndex();
+  int literal_index = temp_scope_->NextBoilerplateLiteralIndex();
   if (is_pre_parsing_) return NULL;
 
   Handle<FixedArray> constant_properties =
@@ -4356,7 +4363,7 @@ Expression* Parser::ParseJsonObject(bool* ok) {
   }
   Expect(Token::RBRACE, CHECK_OK);
 
-  int literal_index = temp_scope_->NextMaterializedLiteralIndex();
+  int literal_index = temp_scope_->NextBoilerplateLiteralIndex();
   if (is_pre_parsing_) return NULL;
 
   Handle<FixedArray> constant_properties =
@@ -4392,7 +4399,7 @@ Expression* Parser::ParseJsonArray(bool* ok) {
   Expect(Token::RBRACK, CHECK_OK);
 
   // Update the scope information before the pre-parsing bailout.
-  int literal_index = temp_scope_->NextMaterializedLiteralIndex();
+  int literal_index = temp_scope_->NextBoilerplateLiteralIndex();
 
   if (is_pre_parsing_) return NULL;
 
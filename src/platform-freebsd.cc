@@ -90,6 +90,13 @@ void OS::ReleaseStore(volatile AtomicWord* ptr, AtomicWord value) {
 }
 
 
+AtomicWord OS::CompareAndSwap(volatile AtomicWord* ptr,
+                              AtomicWord old_value,
+                              AtomicWord new_value) {
+  return __sync_val_compare_and_swap(ptr, old_value, new_value);
+}
+
+
 uint64_t OS::CpuFeaturesImpliedByPlatform() {
   return 0;  // FreeBSD runs on anything.
 }
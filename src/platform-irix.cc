@@ -98,6 +98,21 @@ void OS::ReleaseStore(volatile AtomicWord* ptr, AtomicWord value) {
 }
 
 
+AtomicWord OS::CompareAndSwap(volatile AtomicWord* ptr,
+                              AtomicWord old_value,
+                              AtomicWord new_value) {
+  do {
+    if (__compare_and_swap(const_cast<AtomicWord*>(ptr),
+                           old_value,
+                           new_value)) {
+      return old_value;
+    }
+    AtomicWord prev_value = *ptr;
+    if (prev_value != old_value) return prev_value;
+  } while (true);
+}
+
+
 // Returns the local time offset in milliseconds east of UTC without
 // taking daylight savings time into account.
 double OS::LocalTimeOffset() {
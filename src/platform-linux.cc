@@ -230,6 +230,15 @@ int OS::ActivationFrameAlignment() {
 typedef void (*LinuxKernelMemoryBarrierFunc)(void);
 LinuxKernelMemoryBarrierFunc pLinuxKernelMemoryBarrier __attribute__((weak)) =
     (LinuxKernelMemoryBarrierFunc) 0xffff0fa0;
+
+// 0xffff0fc0 is the hard coded address of the kernel provided compare and
+// swap helper. It returns zero if *ptr was changed from old_value to
+// new_value and includes the memory barriers needed on SMP systems.
+typedef int (*LinuxKernelCmpxchgFunc)(AtomicWord old_value,
+                                      AtomicWord new_value,
+                                      volatile AtomicWord* ptr);
+LinuxKernelCmpxchgFunc pLinuxKernelCmpxchg __attribute__((weak)) =
+    (LinuxKernelCmpxchgFunc) 0xffff0fc0;
 #endif
 
 void OS::ReleaseStore(volatile AtomicWord* ptr, AtomicWord value) {
@@ -244,6 +253,23 @@ void OS::ReleaseStore(volatile AtomicWord* ptr, AtomicWord value) {
 }
 
 
+AtomicWord OS::CompareAndSwap(volatile AtomicWord* ptr,
+                              AtomicWord old_value,
+                              AtomicWord new_value) {
+#if defined(V8_TARGET_ARCH_ARM) && defined(__arm__)
+  // Only use on ARM hardware. The kernel helper can fail spuriously, so
+  // retry until the value is seen to differ from old_value.
+  do {
+    AtomicWord prev_value = *ptr;
+    if (prev_value != old_value) return prev_value;
+  } while (pLinuxKernelCmpxchg(old_value, new_value, ptr) != 0);
+  return old_value;
+#else
+  return __sync_val_compare_and_swap(ptr, old_value, new_value);
+#endif
+}
+
+
 const char* OS::LocalTimezone(double time) {
   if (isnan(time)) return "";
   time_t tv = static_cast<time_t>(floor(time/msPerSecond));
@@ -289,17 +315,53 @@ size_t OS::AllocateAlignment() {
 }
 
 
+// Size of the transparent huge pages of the kernel.
+static const size_t kHugePageSize = 2 * MB;
+
+
+static bool UseHugePages(size_t size) {
+#ifdef MADV_HUGEPAGE
+  return FLAG_transparent_huge_pages && size >= kHugePageSize;
+#else
+  return false;
+#endif
+}
+
+
+// Asks the kernel to back the huge page aligned parts of a mapping with
+// huge pages.  Kernels without transparent huge pages reject the advice,
+// which is harmless.
+static void AdviseHugePages(void* address, size_t size) {
+#ifdef MADV_HUGEPAGE
+  madvise(address, size, MADV_HUGEPAGE);
+#endif
+}
+
+
 void* OS::Allocate(const size_t requested,
                    size_t* allocated,
                    bool is_executable) {
   // TODO(805): Port randomization of allocated executable memory to Linux.
   const size_t msize = RoundUp(requested, sysconf(_SC_PAGESIZE));
   int prot = PROT_READ | PROT_WRITE | (is_executable ? PROT_EXEC : 0);
-  void* mbase = mmap(NULL, msize, prot, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  // Chunks that can hold huge pages are aligned to the huge page size by
+  // mapping more memory than needed and unmapping the ends.
+  bool use_huge_pages = UseHugePages(msize);
+  size_t reserved = use_huge_pages ? msize + kHugePageSize : msize;
+  void* mbase = mmap(NULL, reserved, prot, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
   if (mbase == MAP_FAILED) {
     LOG(StringEvent("OS::Allocate", "mmap failed"));
     return NULL;
   }
+  if (use_huge_pages) {
+    char* start = reinterpret_cast<char*>(mbase);
+    char* aligned = RoundUp(start, static_cast<int>(kHugePageSize));
+    if (aligned > start) munmap(start, aligned - start);
+    char* end = start + reserved;
+    if (end > aligned + msize) munmap(aligned + msize, end - (aligned + msize));
+    mbase = aligned;
+    AdviseHugePages(mbase, msize);
+  }
   *allocated = msize;
   UpdateAllocatedSpaceLimits(mbase, msize);
   return mbase;
@@ -518,6 +580,7 @@ bool VirtualMemory::Commit(void* address, size_t size, bool is_executable) {
                          kMmapFd, kMmapFdOffset)) {
     return false;
   }
+  if (UseHugePages(size)) AdviseHugePages(address, size);
 
   UpdateAllocatedSpaceLimits(address, size);
   return true;
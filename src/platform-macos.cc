@@ -266,6 +266,22 @@ void OS::ReleaseStore(volatile AtomicWord* ptr, AtomicWord value) {
 }
 
 
+AtomicWord OS::CompareAndSwap(volatile AtomicWord* ptr,
+                              AtomicWord old_value,
+                              AtomicWord new_value) {
+  do {
+    if (OSAtomicCompareAndSwapPtrBarrier(reinterpret_cast<void*>(old_value),
+                                         reinterpret_cast<void*>(new_value),
+                                         reinterpret_cast<void* volatile*>(
+                                             ptr))) {
+      return old_value;
+    }
+    AtomicWord prev_value = *ptr;
+    if (prev_value != old_value) return prev_value;
+  } while (true);
+}
+
+
 const char* OS::LocalTimezone(double time) {
   if (isnan(time)) return "";
   time_t tv = static_cast<time_t>(floor(time/msPerSecond));
@@ -1377,6 +1377,16 @@ void OS::ReleaseStore(volatile AtomicWord* ptr, AtomicWord value) {
 }
 
 
+AtomicWord OS::CompareAndSwap(volatile AtomicWord* ptr,
+                              AtomicWord old_value,
+                              AtomicWord new_value) {
+  return reinterpret_cast<AtomicWord>(InterlockedCompareExchangePointer(
+      reinterpret_cast<PVOID volatile*>(ptr),
+      reinterpret_cast<PVOID>(new_value),
+      reinterpret_cast<PVOID>(old_value)));
+}
+
+
 bool VirtualMemory::IsReserved() {
   return address_ != NULL;
 }
@@ -307,6 +307,13 @@ class OS {
 
   static void ReleaseStore(volatile AtomicWord* ptr, AtomicWord value);
 
+  // Atomically replaces *ptr with new_value if it is equal to old_value.
+  // Returns the value *ptr had before the operation; the swap happened iff
+  // that value is old_value. Acts as a full memory barrier.
+  static AtomicWord CompareAndSwap(volatile AtomicWord* ptr,
+                                   AtomicWord old_value,
+                                   AtomicWord new_value);
+
  private:
   static const int msPerSecond = 1000;
 
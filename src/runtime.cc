@@ -39,6 +39,8 @@
 #include "debug.h"
 #include "execution.h"
 #include "jsregexp.h"
+#include "json-parser.h"
+#include "json-stringifier.h"
 #include "liveedit.h"
 #include "parser.h"
 #include "platform.h"
@@ -98,11 +100,16 @@ namespace internal {
 static StaticResource<StringInputBuffer> runtime_string_input_buffer;
 
 
-static Object* DeepCopyBoilerplate(JSObject* boilerplate) {
+// Copies a boilerplate and the boilerplates of nested literals.  The copies
+// are allocated in old space if pretenure is TENURED.  If a site is given, an
+// allocation memento for it is placed behind the outermost copy.
+static Object* DeepCopyBoilerplate(JSObject* boilerplate,
+                                   PretenureFlag pretenure,
+                                   AllocationSite* site) {
   StackLimitCheck check;
   if (check.HasOverflowed()) return Top::StackOverflow();
 
-  Object* result = Heap::CopyJSObject(boilerplate);
+  Object* result = Heap::CopyJSObject(boilerplate, pretenure, site);
   if (result->IsFailure()) return result;
   JSObject* copy = JSObject::cast(result);
 
@@ -113,7 +120,7 @@ static Object* DeepCopyBoilerplate(JSObject* boilerplate) {
       Object* value = properties->get(i);
       if (value->IsJSObject()) {
         JSObject* js_object = JSObject::cast(value);
-        result = DeepCopyBoilerplate(js_object);
+        result = DeepCopyBoilerplate(js_object, pretenure, NULL);
         if (result->IsFailure()) return result;
         properties->set(i, result);
       }
@@ -123,7 +130,7 @@ static Object* DeepCopyBoilerplate(JSObject* boilerplate) {
       Object* value = copy->InObjectPropertyAt(i);
       if (value->IsJSObject()) {
         JSObject* js_object = JSObject::cast(value);
-        result = DeepCopyBoilerplate(js_object);
+        result = DeepCopyBoilerplate(js_object, pretenure, NULL);
         if (result->IsFailure()) return result;
         copy->InObjectPropertyAtPut(i, result);
       }
@@ -146,7 +153,7 @@ static Object* DeepCopyBoilerplate(JSObject* boilerplate) {
       ASSERT(!value->IsFailure());
       if (value->IsJSObject()) {
         JSObject* js_object = JSObject::cast(value);
-        result = DeepCopyBoilerplate(js_object);
+        result = DeepCopyBoilerplate(js_object, pretenure, NULL);
         if (result->IsFailure()) return result;
         result = copy->SetProperty(key_string, result, NONE);
         if (result->IsFailure()) return result;
@@ -172,7 +179,7 @@ static Object* DeepCopyBoilerplate(JSObject* boilerplate) {
           Object* value = elements->get(i);
           if (value->IsJSObject()) {
             JSObject* js_object = JSObject::cast(value);
-            result = DeepCopyBoilerplate(js_object);
+            result = DeepCopyBoilerplate(js_object, pretenure, NULL);
             if (result->IsFailure()) return result;
             elements->set(i, result);
           }
@@ -189,7 +196,7 @@ static Object* DeepCopyBoilerplate(JSObject* boilerplate) {
           Object* value = element_dictionary->ValueAt(i);
           if (value->IsJSObject()) {
             JSObject* js_object = JSObject::cast(value);
-            result = DeepCopyBoilerplate(js_object);
+            result = DeepCopyBoilerplate(js_object, pretenure, NULL);
             if (result->IsFailure()) return result;
             element_dictionary->ValueAtPut(i, result);
           }
@@ -207,7 +214,7 @@ static Object* DeepCopyBoilerplate(JSObject* boilerplate) {
 
 static Object* Runtime_CloneLiteralBoilerplate(Arguments args) {
   CONVERT_CHECKED(JSObject, boilerplate, args[0]);
-  return DeepCopyBoilerplate(boilerplate);
+  return DeepCopyBoilerplate(boilerplate, NOT_TENURED, NULL);
 }
 
 
@@ -402,6 +409,44 @@ static Handle<Object> CreateLiteralBoilerplate(
 }
 
 
+// Object and array literals keep the allocation site of their copies in the
+// literals array, right behind the boilerplate.  The site is undefined if
+// allocation site pretenuring is disabled.
+static Handle<Object> GetLiteralAllocationSite(Handle<FixedArray> literals,
+                                               int literals_index) {
+  int site_index = literals_index + 1;
+  if (FLAG_allocation_site_pretenuring &&
+      literals->get(site_index)->IsUndefined()) {
+    Handle<AllocationSite> site = Factory::NewAllocationSite();
+    literals->set(site_index, *site);
+  }
+  return Handle<Object>(literals->get(site_index));
+}
+
+
+// Copies a literal boilerplate where the allocation site of the literal
+// asks for it.
+static Object* CopyLiteralBoilerplate(JSObject* boilerplate,
+                                      Object* site,
+                                      bool deep) {
+  PretenureFlag pretenure = NOT_TENURED;
+  AllocationSite* memento_site = NULL;
+  if (site->IsAllocationSite()) {
+    pretenure = AllocationSite::cast(site)->GetPretenureMode();
+    if (AllocationSite::cast(site)->state() == AllocationSite::kCollecting) {
+      memento_site = AllocationSite::cast(site);
+    }
+  }
+  Object* result = deep
+      ? DeepCopyBoilerplate(boilerplate, pretenure, memento_site)
+      : Heap::CopyJSObject(boilerplate, pretenure, memento_site);
+  if (pretenure == TENURED && !result->IsFailure()) {
+    Heap::RecordPretenuredAllocation(JSObject::cast(result)->Size());
+  }
+  return result;
+}
+
+
 static Object* Runtime_CreateArrayLiteralBoilerplate(Arguments args) {
   // Takes a FixedArray of elements containing the literal elements of
   // the array literal and produces JSArray with those elements.
@@ -416,6 +461,7 @@ static Object* Runtime_CreateArrayLiteralBoilerplate(Arguments args) {
 
   Handle<Object> object = CreateArrayLiteralBoilerplate(literals, elements);
   if (object.is_null()) return Failure::Exception();
+  GetLiteralAllocationSite(literals, literals_index);
 
   // Update the functions literal and return the boilerplate.
   literals->set(literals_index, *object);
@@ -442,7 +488,8 @@ static Object* Runtime_CreateObjectLiteral(Arguments args) {
     // Update the functions literal and return the boilerplate.
     literals->set(literals_index, *boilerplate);
   }
-  return DeepCopyBoilerplate(JSObject::cast(*boilerplate));
+  Handle<Object> site = GetLiteralAllocationSite(literals, literals_index);
+  return CopyLiteralBoilerplate(JSObject::cast(*boilerplate), *site, true);
 }
 
 
@@ -465,7 +512,8 @@ static Object* Runtime_CreateObjectLiteralShallow(Arguments args) {
     // Update the functions literal and return the boilerplate.
     literals->set(literals_index, *boilerplate);
   }
-  return Heap::CopyJSObject(JSObject::cast(*boilerplate));
+  Handle<Object> site = GetLiteralAllocationSite(literals, literals_index);
+  return CopyLiteralBoilerplate(JSObject::cast(*boilerplate), *site, false);
 }
 
 
@@ -484,7 +532,8 @@ static Object* Runtime_CreateArrayLiteral(Arguments args) {
     // Update the functions literal and return the boilerplate.
     literals->set(literals_index, *boilerplate);
   }
-  return DeepCopyBoilerplate(JSObject::cast(*boilerplate));
+  Handle<Object> site = GetLiteralAllocationSite(literals, literals_index);
+  return CopyLiteralBoilerplate(JSObject::cast(*boilerplate), *site, true);
 }
 
 
@@ -507,7 +556,8 @@ static Object* Runtime_CreateArrayLiteralShallow(Arguments args) {
       Heap::fixed_cow_array_map()) {
     Counters::cow_arrays_created_runtime.Increment();
   }
-  return Heap::CopyJSObject(JSObject::cast(*boilerplate));
+  Handle<Object> site = GetLiteralAllocationSite(literals, literals_index);
+  return CopyLiteralBoilerplate(JSObject::cast(*boilerplate), *site, false);
 }
 
 
@@ -1739,6 +1789,7 @@ static Object* Runtime_SetCode(Arguments args) {
     // It's okay to skip the write barrier here because the literals
     // are guaranteed to be in old space.
     target->set_literals(*literals, SKIP_WRITE_BARRIER);
+    IncrementalMarking::RecordWriteOf(*literals);
   }
 
   target->set_context(*context);
@@ -6819,8 +6870,27 @@ static Object* Runtime_NewObject(Arguments args) {
   Handle<SharedFunctionInfo> shared(function->shared());
   EnsureCompiled(shared, CLEAR_EXCEPTION);
 
+  // Objects are allocated as the allocation site of the constructor asks
+  // for.  The construct stubs call here for all allocations while the site
+  // collects feedback or tenures the objects.
+  if (FLAG_allocation_site_pretenuring &&
+      shared->allocation_site()->IsUndefined()) {
+    Handle<AllocationSite> site = Factory::NewAllocationSite();
+    shared->set_allocation_site(*site);
+  }
+  Handle<Object> site(shared->allocation_site());
+  PretenureFlag pretenure = NOT_TENURED;
+  if (site->IsAllocationSite()) {
+    pretenure = AllocationSite::cast(*site)->GetPretenureMode();
+  }
+
   bool first_allocation = !function->has_initial_map();
-  Handle<JSObject> result = Factory::NewJSObject(function);
+  Handle<JSObject> result = Factory::NewJSObject(function, pretenure);
+  if (site->IsAllocationSite() &&
+      AllocationSite::cast(*site)->state() == AllocationSite::kCollecting) {
+    Heap::CreateAllocationMemento(*result, AllocationSite::cast(*site));
+  }
+  if (pretenure == TENURED) Heap::RecordPretenuredAllocation(result->Size());
   if (first_allocation) {
     Handle<Code> stub = Handle<Code>(
         ComputeConstructStub(Handle<JSFunction>(function)));
@@ -6863,6 +6933,42 @@ static Object* Runtime_LazyCompile(Arguments args) {
 }
 
 
+static Object* Runtime_LazyRecompile(Arguments args) {
+  HandleScope scope;
+  ASSERT(args.length() == 1);
+
+  // Called on entry to full-codegen code that got hot. If the function
+  // cannot be recompiled right now it keeps running its current code and
+  // starts counting again.
+  Handle<JSFunction> function = args.at<JSFunction>(0);
+  if (!Compiler::RecompileOptimized(function) &&
+      function->shared()->tier_up_counter() <= 0) {
+    function->shared()->set_tier_up_counter(FLAG_tier_up_threshold);
+  }
+  ASSERT(!Top::has_pending_exception());
+  return function->code();
+}
+
+
+static Object* Runtime_CompileForOnStackReplacement(Arguments args) {
+  HandleScope scope;
+  ASSERT(args.length() == 2);
+
+  // Called at a back edge of a loop in full-codegen code that got hot.
+  // Returns the offset of the loop entry in the new code of the function,
+  // or zero if the loop has to continue in the full code for now.
+  Handle<JSFunction> function = args.at<JSFunction>(0);
+  CONVERT_SMI_CHECKED(loop_position, args[1]);
+  int offset = Compiler::CompileForOnStackReplacement(function, loop_position);
+  if (offset < 0) {
+    function->shared()->set_tier_up_counter(FLAG_tier_up_threshold);
+    offset = 0;
+  }
+  ASSERT(!Top::has_pending_exception());
+  return Smi::FromInt(offset);
+}
+
+
 static Object* Runtime_GetFunctionDelegate(Arguments args) {
   HandleScope scope;
   ASSERT(args.length() == 1);
@@ -7434,6 +7540,41 @@ static Object* Runtime_CompileString(Arguments args) {
 }
 
 
+static Object* Runtime_ParseJson(Arguments args) {
+  HandleScope scope;
+  ASSERT_EQ(1, args.length());
+  CONVERT_ARG_CHECKED(String, source, 0);
+
+  Handle<Object> result = JsonParser::Parse(source);
+  if (result.is_null()) {
+    // Syntax error or stack overflow in the parser.
+    ASSERT(Top::has_pending_exception());
+    return Failure::Exception();
+  }
+  return *result;
+}
+
+
+static Object* Runtime_StringifyJson(Arguments args) {
+  HandleScope scope;
+  ASSERT_EQ(1, args.length());
+
+  Handle<Object> result = JsonStringifier::Stringify(args.at<Object>(0));
+  // Return false to make the caller use the generic serializer.
+  if (result.is_null()) return Heap::false_value();
+  return *result;
+}
+
+
+static Object* Runtime_QuoteJSONString(Arguments args) {
+  HandleScope scope;
+  ASSERT_EQ(1, args.length());
+  CONVERT_ARG_CHECKED(String, string, 0);
+
+  return *JsonStringifier::Quote(string);
+}
+
+
 static ObjectPair CompileGlobalEval(Handle<String> source,
                                     Handle<Object> receiver) {
   // Deal with a normal eval call with a string argument. Compile it
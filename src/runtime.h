@@ -81,6 +81,8 @@ namespace internal {
   F(GetConstructorDelegate, 1, 1) \
   F(NewArgumentsFast, 3, 1) \
   F(LazyCompile, 1, 1) \
+  F(LazyRecompile, 1, 1) \
+  F(CompileForOnStackReplacement, 2, 1) \
   F(SetNewFunctionAttributes, 1, 1) \
   F(AllocateInNewSpace, 1, 1) \
   \
@@ -223,6 +225,9 @@ namespace internal {
   \
   /* Globals */ \
   F(CompileString, 2, 1) \
+  F(ParseJson, 1, 1) \
+  F(StringifyJson, 1, 1) \
+  F(QuoteJSONString, 1, 1) \
   F(GlobalPrint, 1, 1) \
   \
   /* Eval */ \
@@ -422,6 +422,14 @@ void ExternalReferenceTable::PopulateTable() {
       UNCLASSIFIED,
       29,
       "TranscendentalCache::caches()");
+  Add(ExternalReference::store_buffer_top().address(),
+      UNCLASSIFIED,
+      30,
+      "StoreBuffer::top_address()");
+  Add(ExternalReference::store_buffer_limit().address(),
+      UNCLASSIFIED,
+      31,
+      "StoreBuffer::limit_address()");
 }
 
 
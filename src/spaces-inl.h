@@ -28,6 +28,7 @@
 #ifndef V8_SPACES_INL_H_
 #define V8_SPACES_INL_H_
 
+#include "incremental-marking.h"
 #include "memory.h"
 #include "spaces.h"
 
@@ -427,10 +428,11 @@ Object* PagedSpace::AllocateRaw(int size_in_bytes) {
   ASSERT(HasBeenSetup());
   ASSERT_OBJECT_SIZE(size_in_bytes);
   HeapObject* object = AllocateLinearly(&allocation_info_, size_in_bytes);
-  if (object != NULL) return object;
-
-  object = SlowAllocateRaw(size_in_bytes);
-  if (object != NULL) return object;
+  if (object == NULL) object = SlowAllocateRaw(size_in_bytes);
+  if (object != NULL) {
+    IncrementalMarking::RecordAllocation(object, size_in_bytes);
+    return object;
+  }
 
   return Failure::RetryAfterGC(size_in_bytes, identity());
 }
@@ -30,6 +30,8 @@
 #include "macro-assembler.h"
 #include "mark-compact.h"
 #include "platform.h"
+#include "store-buffer.h"
+#include "sweeper.h"
 
 namespace v8 {
 namespace internal {
@@ -47,23 +49,27 @@ intptr_t Page::watermark_invalidated_mark_ = 1 << Page::WATERMARK_INVALIDATED;
 // HeapObjectIterator
 
 HeapObjectIterator::HeapObjectIterator(PagedSpace* space) {
+  Sweeper::EnsureSwept(space);
   Initialize(space->bottom(), space->top(), NULL);
 }
 
 
 HeapObjectIterator::HeapObjectIterator(PagedSpace* space,
                                        HeapObjectCallback size_func) {
+  Sweeper::EnsureSwept(space);
   Initialize(space->bottom(), space->top(), size_func);
 }
 
 
 HeapObjectIterator::HeapObjectIterator(PagedSpace* space, Address start) {
+  Sweeper::EnsureSwept(space);
   Initialize(start, space->top(), NULL);
 }
 
 
 HeapObjectIterator::HeapObjectIterator(PagedSpace* space, Address start,
                                        HeapObjectCallback size_func) {
+  Sweeper::EnsureSwept(space);
   Initialize(start, space->top(), size_func);
 }
 
@@ -278,6 +284,7 @@ List<MemoryAllocator::ChunkInfo> MemoryAllocator::chunks_(
 List<int> MemoryAllocator::free_chunk_ids_(kEstimatedNumberOfChunks);
 int MemoryAllocator::max_nof_chunks_ = 0;
 int MemoryAllocator::top_ = 0;
+int MemoryAllocator::pages_per_chunk_ = 0;
 
 
 void MemoryAllocator::Push(int free_chunk_id) {
@@ -298,16 +305,21 @@ void *executable_memory_histogram = NULL;
 bool MemoryAllocator::Setup(int capacity) {
   capacity_ = RoundUp(capacity, Page::kPageSize);
 
+  // A chunk has at least two pages, since one may be lost to alignment.
+  int chunk_size =
+      FLAG_heap_chunk_size > 0 ? FLAG_heap_chunk_size * KB : kDefaultChunkSize;
+  pages_per_chunk_ = Max(2, chunk_size / Page::kPageSize);
+
   // Over-estimate the size of chunks_ array.  It assumes the expansion of old
-  // space is always in the unit of a chunk (kChunkSize) except the last
-  // expansion.
+  // space is always in the unit of a chunk except the last expansion.
   //
   // Due to alignment, allocated space might be one page less than required
-  // number (kPagesPerChunk) of pages for old spaces.
+  // number (pages_per_chunk_) of pages for old spaces.
   //
   // Reserve two chunk ids for semispaces, one for map space, one for old
   // space, and one for code space.
-  max_nof_chunks_ = (capacity_ / (kChunkSize - Page::kPageSize)) + 5;
+  max_nof_chunks_ =
+      (capacity_ / ((pages_per_chunk_ - 1) * Page::kPageSize)) + 5;
   if (max_nof_chunks_ > kMaxNofChunks) return false;
 
   size_ = 0;
@@ -749,7 +761,7 @@ bool PagedSpace::Setup(Address start, size_t size) {
                                                Page::kPageSize * pages_in_chunk,
                                                this, &num_pages);
   } else {
-    int requested_pages = Min(MemoryAllocator::kPagesPerChunk,
+    int requested_pages = Min(MemoryAllocator::pages_per_chunk(),
                               max_capacity_ / Page::kObjectAreaSize);
     first_page_ =
         MemoryAllocator::AllocatePages(requested_pages, &num_pages, this);
@@ -830,6 +842,7 @@ Object* PagedSpace::FindObject(Address addr) {
 
   Page* p = Page::FromAddress(addr);
   ASSERT(IsUsed(p));
+  Sweeper::EnsureSwept(addr);
   Address cur = p->ObjectAreaStart();
   Address end = p->AllocationTop();
   while (cur < end) {
@@ -939,7 +952,7 @@ bool PagedSpace::Expand(Page* last_page) {
   int available_pages = (max_capacity_ - Capacity()) / Page::kObjectAreaSize;
   if (available_pages <= 0) return false;
 
-  int desired_pages = Min(available_pages, MemoryAllocator::kPagesPerChunk);
+  int desired_pages = Min(available_pages, MemoryAllocator::pages_per_chunk());
   Page* p = MemoryAllocator::AllocatePages(desired_pages, &desired_pages, this);
   if (!p->is_valid()) return false;
 
@@ -1480,6 +1493,7 @@ static void ReportCodeKindStatistics() {
       CASE(CALL_IC);
       CASE(KEYED_CALL_IC);
       CASE(BINARY_OP_IC);
+      CASE(COMPARE_IC);
     }
   }
 
@@ -2119,28 +2133,31 @@ HeapObject* OldSpace::SlowAllocateRaw(int size_in_bytes) {
   }
 
   // There is no next page in this space.  Try free list allocation unless that
-  // is currently forbidden.
+  // is currently forbidden.  If the sweeping of the space was deferred, sweep
+  // more pages until the free list has a large enough block.
   if (!Heap::linear_allocation()) {
-    int wasted_bytes;
-    Object* result = free_list_.Allocate(size_in_bytes, &wasted_bytes);
-    accounting_stats_.WasteBytes(wasted_bytes);
-    if (!result->IsFailure()) {
-      accounting_stats_.AllocateBytes(size_in_bytes);
-
-      HeapObject* obj = HeapObject::cast(result);
-      Page* p = Page::FromAddress(obj->address());
+    do {
+      int wasted_bytes;
+      Object* result = free_list_.Allocate(size_in_bytes, &wasted_bytes);
+      accounting_stats_.WasteBytes(wasted_bytes);
+      if (!result->IsFailure()) {
+        accounting_stats_.AllocateBytes(size_in_bytes);
+
+        HeapObject* obj = HeapObject::cast(result);
+        Page* p = Page::FromAddress(obj->address());
+
+        if (obj->address() >= p->AllocationWatermark()) {
+          // There should be no hole between the allocation watermark
+          // and allocated object address.
+          // Memory above the allocation watermark was not swept and
+          // might contain garbage pointers to new space.
+          ASSERT(obj->address() == p->AllocationWatermark());
+          p->SetAllocationWatermark(obj->address() + size_in_bytes);
+        }
 
-      if (obj->address() >= p->AllocationWatermark()) {
-        // There should be no hole between the allocation watermark
-        // and allocated object address.
-        // Memory above the allocation watermark was not swept and
-        // might contain garbage pointers to new space.
-        ASSERT(obj->address() == p->AllocationWatermark());
-        p->SetAllocationWatermark(obj->address() + size_in_bytes);
+        return obj;
       }
-
-      return obj;
-    }
+    } while (Sweeper::SweepForAllocation(this, size_in_bytes));
   }
 
   // Free list allocation failed and there is no next page.  Fail if we have
@@ -2680,7 +2697,9 @@ Object* LargeObjectSpace::AllocateRawInternal(int requested_size,
   page->SetIsLargeObjectPage(true);
   page->SetIsPageExecutable(executable);
   page->SetRegionMarks(Page::kAllRegionsCleanMarks);
-  return HeapObject::FromAddress(object_address);
+  HeapObject* object = HeapObject::FromAddress(object_address);
+  IncrementalMarking::RecordAllocation(object, object_size);
+  return object;
 }
 
 
@@ -2775,6 +2794,9 @@ void LargeObjectSpace::IterateDirtyRegions(ObjectSlotCallback copy_object) {
                                         copy_object);
         }
 
+        // Dirty marks are kept while incremental marking is in progress.
+        // See Heap::IterateDirtyRegions.
+        if (IncrementalMarking::IsMarking()) newmarks |= marks;
         page->SetRegionMarks(newmarks);
       }
     }
@@ -2884,7 +2906,8 @@ void LargeObjectSpace::Verify() {
             Address element_addr = array_addr + FixedArray::kHeaderSize +
                 j * kPointerSize;
 
-            ASSERT(Page::FromAddress(array_addr)->IsRegionDirty(element_addr));
+            ASSERT(Page::FromAddress(array_addr)->IsRegionDirty(element_addr) ||
+                   StoreBuffer::CellIsInStoreBuffer(element_addr));
           }
         }
       }
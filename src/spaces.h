@@ -253,7 +253,8 @@ class Page {
   static const int kMaxHeapObjectSize = kObjectAreaSize;
 
   static const int kDirtyFlagOffset = 2 * kPointerSize;
-  static const int kRegionSizeLog2 = 8;
+  // A page is divided into 32 regions with one dirty mark each.
+  static const int kRegionSizeLog2 = kPageSizeBits - 5;
   static const int kRegionSize = 1 << kRegionSizeLog2;
   static const intptr_t kRegionAlignmentMask = (kRegionSize - 1);
 
@@ -471,9 +472,9 @@ class CodeRange : public AllStatic {
 // leftover regions of the initial chunk are used for the initial chunks of
 // old space and map space if they are big enough to hold at least one page.
 // The allocator assumes that there is one old space and one map space, each
-// expands the space by allocating kPagesPerChunk pages except the last
+// expands the space by allocating pages_per_chunk() pages except the last
 // expansion (before running out of space).  The first chunk may contain fewer
-// than kPagesPerChunk pages as well.
+// than pages_per_chunk() pages as well.
 //
 // The memory allocator also allocates chunks for the large object space, but
 // they are managed by the space itself.  The new space does not expand.
@@ -623,16 +624,21 @@ class MemoryAllocator : public AllStatic {
   static void ReportStatistics();
 #endif
 
-  // Due to encoding limitation, we can only have 8K chunks.
-  static const int kMaxNofChunks = 1 << kPageSizeBits;
-  // If a chunk has at least 16 pages, the maximum heap size is about
-  // 8K * 8K * 16 = 1G bytes.
+  // Due to encoding limitation, we can only have as many chunks as a page
+  // has bytes.  Larger pages do not raise the limit beyond 8K chunks, which
+  // keeps the per-chunk tables of the collectors small.
+  static const int kMaxNofChunks =
+      1 << (kPageSizeBits < 13 ? kPageSizeBits : 13);
+  // With chunks of 128K, the maximum heap size is about 8K * 128K = 1G bytes.
+  // Larger heaps need larger chunks, see --heap_chunk_size.
 #ifdef V8_TARGET_ARCH_X64
-  static const int kPagesPerChunk = 32;
+  static const int kDefaultChunkSize = 256 * KB;
 #else
-  static const int kPagesPerChunk = 16;
+  static const int kDefaultChunkSize = 128 * KB;
 #endif
-  static const int kChunkSize = kPagesPerChunk * Page::kPageSize;
+
+  // The number of pages the old spaces allocate at a time.
+  static int pages_per_chunk() { return pages_per_chunk_; }
 
  private:
   // Maximum space size in bytes.
@@ -671,6 +677,9 @@ class MemoryAllocator : public AllStatic {
   static int max_nof_chunks_;
   static int top_;
 
+  // The chunk size in pages, set up from --heap_chunk_size.
+  static int pages_per_chunk_;
+
   // Push/pop a free chunk id onto/from the stack.
   static void Push(int free_chunk_id);
   static int Pop();
@@ -703,6 +712,9 @@ class MemoryAllocator : public AllStatic {
                                   size_t chunk_size,
                                   Page* prev,
                                   Page** last_page_in_use);
+
+  friend class IncrementalMarking;
+  friend class Sweeper;
 };
 
 
@@ -1814,6 +1826,17 @@ class OldSpace : public PagedSpace {
     }
   }
 
+  // Deferred sweeping (see Sweeper) accounts for the free bytes of a page
+  // in the collection and puts its free blocks on the free list later.
+  void DeallocateDeferredBytes(int size_in_bytes) {
+    accounting_stats_.DeallocateBytes(size_in_bytes);
+  }
+
+  void FreeDeferredBlock(Address start, int size_in_bytes) {
+    int wasted_bytes = free_list_.Free(start, size_in_bytes);
+    accounting_stats_.WasteBytes(wasted_bytes);
+  }
+
   // Prepare for full garbage collection.  Resets the relocation pointer and
   // clears the free list.
   virtual void PrepareForMarkCompact(bool will_compact);
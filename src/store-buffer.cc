@@ -0,0 +1,130 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <stdlib.h>
+
+#include "v8.h"
+
+#include "store-buffer.h"
+
+namespace v8 {
+namespace internal {
+
+Address* StoreBuffer::start_ = NULL;
+Address* StoreBuffer::top_ = NULL;
+Address* StoreBuffer::limit_ = NULL;
+
+
+void StoreBuffer::Setup() {
+  start_ = NewArray<Address>(kStoreBufferLength);
+  top_ = start_;
+  limit_ = start_ + kStoreBufferLength;
+}
+
+
+void StoreBuffer::TearDown() {
+  DeleteArray(start_);
+  start_ = top_ = limit_ = NULL;
+}
+
+
+static int CompareAddresses(const void* a, const void* b) {
+  Address left = *reinterpret_cast<const Address*>(a);
+  Address right = *reinterpret_cast<const Address*>(b);
+  if (left < right) return -1;
+  return (left > right) ? 1 : 0;
+}
+
+
+void StoreBuffer::SortUniq() {
+  if (top_ == start_) return;
+  qsort(start_, top_ - start_, sizeof(*start_), &CompareAddresses);
+  Address* write = start_;
+  for (Address* read = start_; read < top_; read++) {
+    if (write == start_ || *read != write[-1]) *write++ = *read;
+  }
+  top_ = write;
+}
+
+
+void StoreBuffer::Compact() {
+  SortUniq();
+  Address* write = start_;
+  for (Address* read = start_; read < top_; read++) {
+    if (Heap::InNewSpace(Memory::Object_at(*read))) *write++ = *read;
+  }
+  top_ = write;
+  if (length() > kStoreBufferLength / 2) FlushToRegionMarks();
+  Counters::store_buffer_compactions.Increment();
+}
+
+
+void StoreBuffer::FlushToRegionMarks() {
+  for (Address* current = start_; current < top_; current++) {
+    Page::FromAddress(*current)->MarkRegionDirty(*current);
+  }
+  if (top_ != start_) Counters::store_buffer_overflows.Increment();
+  top_ = start_;
+}
+
+
+void StoreBuffer::IteratePointersToNewSpace(ObjectSlotCallback callback) {
+  SortUniq();
+  // Slots are kept in place.  The callback does not record slots, so the
+  // write position never overtakes the read position.
+  Address* limit = top_;
+  top_ = start_;
+  for (Address* current = start_; current < limit; current++) {
+    Object** slot = reinterpret_cast<Object**>(*current);
+    if (Heap::InFromSpace(*slot)) {
+      ASSERT((*slot)->IsHeapObject());
+      callback(reinterpret_cast<HeapObject**>(slot));
+    }
+    if (Heap::InNewSpace(*slot)) *top_++ = *current;
+  }
+}
+
+
+#ifdef DEBUG
+bool StoreBuffer::CellIsInStoreBuffer(Address slot) {
+  SortUniq();
+  Address* low = start_;
+  Address* high = top_;
+  while (low < high) {
+    Address* middle = low + (high - low) / 2;
+    if (*middle < slot) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low < top_ && *low == slot;
+}
+#endif
+
+} }  // namespace v8::internal
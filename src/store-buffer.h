@@ -0,0 +1,108 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef V8_STORE_BUFFER_H_
+#define V8_STORE_BUFFER_H_
+
+namespace v8 {
+namespace internal {
+
+// -------------------------------------------------------------------------
+// Store buffer
+//
+// With --store-buffer the write barrier records the exact address of every
+// slot in the old generation that a new-space object is stored into,
+// instead of marking the region covering the slot dirty.  Scavenges then
+// only visit the recorded slots and do not rescan whole regions.  Slots
+// that still point into the new space after a scavenge are kept.
+//
+// Region dirty marks remain valid alongside the buffer: every pointer from
+// the old generation to the new space is either recorded in the buffer or
+// lies in a dirty region.  When the buffer fills up it is sorted and
+// duplicate or stale entries are dropped; if that does not free at least
+// half of it, all entries are turned into region marks.  Generated code
+// marks regions when it finds the buffer full.  Stores of other values,
+// stores into the tail of large objects and bulk copies keep using region
+// marks, which is what incremental marking relies on.  The buffer is
+// therefore turned into region marks before a scavenge that has to see
+// every write (while incremental marking is in progress, and for the
+// parallel scavenger) and before every full collection, which moves and
+// frees old objects.
+class StoreBuffer : public AllStatic {
+ public:
+  static void Setup();
+  static void TearDown();
+
+  // Record the slot at the given address.  The slot must lie on the same
+  // page as the header of its object, so that its region can be found
+  // from its address.
+  static inline void Mark(Address slot) {
+    if (top_ == limit_) Compact();
+    *top_++ = slot;
+  }
+
+  // Sort the buffer and drop duplicate entries and entries that no longer
+  // point into the new space.  Turns the buffer into region marks if less
+  // than half of it is free afterwards.
+  static void Compact();
+
+  // Mark the regions of all recorded slots dirty and empty the buffer.
+  static void FlushToRegionMarks();
+
+  // Called during a scavenge after the dirty regions have been visited.
+  // Calls the callback for the recorded slots that point into from space
+  // and keeps the slots that still point into the new space.
+  static void IteratePointersToNewSpace(ObjectSlotCallback callback);
+
+  static int length() { return static_cast<int>(top_ - start_); }
+
+#ifdef DEBUG
+  // Sorts the buffer.  Used by heap verification.
+  static bool CellIsInStoreBuffer(Address slot);
+#endif
+
+  // Used by the write barrier in generated code.
+  static Address* top_address() { return reinterpret_cast<Address*>(&top_); }
+  static Address* limit_address() {
+    return reinterpret_cast<Address*>(&limit_);
+  }
+
+  // Number of entries in the buffer.
+  static const int kStoreBufferLength = 16 * KB;
+
+ private:
+  static void SortUniq();
+
+  static Address* start_;
+  static Address* top_;
+  static Address* limit_;
+};
+
+} }  // namespace v8::internal
+
+#endif  // V8_STORE_BUFFER_H_
@@ -237,6 +237,17 @@ Object* StubCache::ComputeLoadGlobal(String* name,
 }
 
 
+Object* StubCache::ComputeLoadPolymorphic(String* name,
+                                          List<Map*>* maps,
+                                          List<Code*>* handlers) {
+  LoadStubCompiler compiler;
+  Object* code = compiler.CompileLoadPolymorphic(maps, handlers, name);
+  if (code->IsFailure()) return code;
+  PROFILE(CodeCreateEvent(Logger::LOAD_IC_TAG, Code::cast(code), name));
+  return code;
+}
+
+
 Object* StubCache::ComputeKeyedLoadField(String* name,
                                          JSObject* receiver,
                                          JSObject* holder,
@@ -451,6 +462,17 @@ Object* StubCache::ComputeStoreInterceptor(String* name,
 }
 
 
+Object* StubCache::ComputeStorePolymorphic(String* name,
+                                           List<Map*>* maps,
+                                           List<Code*>* handlers) {
+  StoreStubCompiler compiler;
+  Object* code = compiler.CompileStorePolymorphic(maps, handlers, name);
+  if (code->IsFailure()) return code;
+  PROFILE(CodeCreateEvent(Logger::STORE_IC_TAG, Code::cast(code), name));
+  return code;
+}
+
+
 Object* StubCache::ComputeKeyedStoreField(String* name, JSObject* receiver,
                                           int field_index, Map* transition) {
   PropertyType type = (transition == NULL) ? FIELD : MAP_TRANSITION;
@@ -650,6 +672,21 @@ Object* StubCache::ComputeCallGlobal(int argc,
 }
 
 
+Object* StubCache::ComputeCallPolymorphic(int argc,
+                                          InLoopFlag in_loop,
+                                          Code::Kind kind,
+                                          String* name,
+                                          List<Map*>* maps,
+                                          List<Code*>* handlers) {
+  CallStubCompiler compiler(argc, in_loop, kind, OWN_MAP);
+  Object* code = compiler.CompileCallPolymorphic(maps, handlers, name);
+  if (code->IsFailure()) return code;
+  PROFILE(CodeCreateEvent(CALL_LOGGER_TAG(kind, CALL_IC_TAG),
+                          Code::cast(code), name));
+  return code;
+}
+
+
 static Object* GetProbeValue(Code::Flags flags) {
   // Use raw_unchecked... so we don't get assert failures during GC.
   NumberDictionary* dictionary = Heap::raw_unchecked_non_monomorphic_cache();
@@ -1201,6 +1238,13 @@ Object* LoadStubCompiler::GetCode(PropertyType type, String* name) {
 }
 
 
+Object* LoadStubCompiler::GetPolymorphicCode(String* name) {
+  Code::Flags flags =
+      Code::ComputeFlags(Code::LOAD_IC, NOT_IN_LOOP, POLYMORPHIC);
+  return GetCodeWithFlags(flags, name);
+}
+
+
 Object* KeyedLoadStubCompiler::GetCode(PropertyType type, String* name) {
   Code::Flags flags = Code::ComputeMonomorphicFlags(Code::KEYED_LOAD_IC, type);
   return GetCodeWithFlags(flags, name);
@@ -1213,6 +1257,13 @@ Object* StoreStubCompiler::GetCode(PropertyType type, String* name) {
 }
 
 
+Object* StoreStubCompiler::GetPolymorphicCode(String* name) {
+  Code::Flags flags =
+      Code::ComputeFlags(Code::STORE_IC, NOT_IN_LOOP, POLYMORPHIC);
+  return GetCodeWithFlags(flags, name);
+}
+
+
 Object* KeyedStoreStubCompiler::GetCode(PropertyType type, String* name) {
   Code::Flags flags = Code::ComputeMonomorphicFlags(Code::KEYED_STORE_IC, type);
   return GetCodeWithFlags(flags, name);
@@ -1273,6 +1324,14 @@ Object* CallStubCompiler::GetCode(JSFunction* function) {
 }
 
 
+Object* CallStubCompiler::GetPolymorphicCode(String* name) {
+  int argc = arguments_.immediate();
+  Code::Flags flags =
+      Code::ComputeFlags(kind_, in_loop_, POLYMORPHIC, NORMAL, argc);
+  return GetCodeWithFlags(flags, name);
+}
+
+
 Object* ConstructStubCompiler::GetCode() {
   Code::Flags flags = Code::ComputeFlags(Code::STUB);
   Object* result = GetCodeWithFlags(flags, "ConstructStub");
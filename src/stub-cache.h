@@ -86,6 +86,13 @@ class StubCache : public AllStatic {
                                    JSGlobalPropertyCell* cell,
                                    bool is_dont_delete);
 
+  // Compiles a stub that dispatches on the receiver map to one of the
+  // given monomorphic handlers. Polymorphic stubs are specific to a
+  // call site and are not entered into any cache.
+  static Object* ComputeLoadPolymorphic(String* name,
+                                        List<Map*>* maps,
+                                        List<Code*>* handlers);
+
 
   // ---
 
@@ -133,6 +140,10 @@ class StubCache : public AllStatic {
 
   static Object* ComputeStoreInterceptor(String* name, JSObject* receiver);
 
+  static Object* ComputeStorePolymorphic(String* name,
+                                         List<Map*>* maps,
+                                         List<Code*>* handlers);
+
   // ---
 
   static Object* ComputeKeyedStoreField(String* name,
@@ -179,6 +190,13 @@ class StubCache : public AllStatic {
                                    JSGlobalPropertyCell* cell,
                                    JSFunction* function);
 
+  static Object* ComputeCallPolymorphic(int argc,
+                                        InLoopFlag in_loop,
+                                        Code::Kind,
+                                        String* name,
+                                        List<Map*>* maps,
+                                        List<Code*>* handlers);
+
   // ---
 
   static Object* ComputeCallInitialize(int argc,
@@ -531,8 +549,15 @@ class LoadStubCompiler: public StubCompiler {
                             String* name,
                             bool is_dont_delete);
 
+  // Checks the receiver map against each of the maps and tail calls
+  // the corresponding handler.
+  Object* CompileLoadPolymorphic(List<Map*>* maps,
+                                 List<Code*>* handlers,
+                                 String* name);
+
  private:
   Object* GetCode(PropertyType type, String* name);
+  Object* GetPolymorphicCode(String* name);
 };
 
 
@@ -579,10 +604,13 @@ class StoreStubCompiler: public StubCompiler {
   Object* CompileStoreGlobal(GlobalObject* object,
                              JSGlobalPropertyCell* holder,
                              String* name);
-
+  Object* CompileStorePolymorphic(List<Map*>* maps,
+                                  List<Code*>* handlers,
+                                  String* name);
 
  private:
   Object* GetCode(PropertyType type, String* name);
+  Object* GetPolymorphicCode(String* name);
 };
 
 
@@ -646,6 +674,9 @@ class CallStubCompiler: public StubCompiler {
                             JSGlobalPropertyCell* cell,
                             JSFunction* function,
                             String* name);
+  Object* CompileCallPolymorphic(List<Map*>* maps,
+                                 List<Code*>* handlers,
+                                 String* name);
 
   // Compiles a custom call constant IC using the generator with given id.
   Object* CompileCustomCall(int generator_id,
@@ -678,6 +709,8 @@ class CallStubCompiler: public StubCompiler {
   // CONSTANT_FUNCTION type and the name of the given function.
   Object* GetCode(JSFunction* function);
 
+  Object* GetPolymorphicCode(String* name);
+
   void GenerateNameCheck(String* name, Label* miss);
 
   // Generates a jump to CallIC miss stub. Returns Failure if the jump cannot
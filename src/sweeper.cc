@@ -0,0 +1,595 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "v8.h"
+
+#include "cpu-profiler.h"
+#include "hashmap.h"
+#include "mark-compact.h"
+#include "sweeper.h"
+
+namespace v8 {
+namespace internal {
+
+// A page of the old pointer, old data or code space whose sweeping was
+// deferred.  Live objects on the page are recorded in the bitmap of its
+// chunk; everything else below the limit is free.
+class DeferredPage {
+ public:
+  enum State {
+    UNSWEPT,   // Not claimed by any thread.
+    SWEEPING,  // A thread is finding the free blocks.
+    SWEPT,     // The free blocks have been found.
+    DONE       // The free blocks are on the free list.
+  };
+
+  DeferredPage(OldSpace* space,
+               Page* page,
+               Address limit,
+               uintptr_t* bitmap,
+               Address bitmap_start)
+      : space_(space),
+        page_(page),
+        limit_(limit),
+        bitmap_(bitmap),
+        bitmap_start_(bitmap_start),
+        state_(UNSWEPT),
+        largest_free_block_(0) { }
+
+  OldSpace* space() { return space_; }
+  Page* page() { return page_; }
+  Address limit() { return limit_; }
+  void set_limit(Address limit) { limit_ = limit; }
+  uintptr_t* bitmap() { return bitmap_; }
+  Address bitmap_start() { return bitmap_start_; }
+
+  // Free blocks as [start, end) pairs.
+  List<Address>* free_blocks() { return &free_blocks_; }
+
+  int largest_free_block() { return largest_free_block_; }
+  void set_largest_free_block(int size) { largest_free_block_ = size; }
+
+  // Claim the page for sweeping.  Returns false if another thread has
+  // claimed it.
+  bool Claim() {
+    return OS::CompareAndSwap(&state_, UNSWEPT, SWEEPING) == UNSWEPT;
+  }
+
+  // Publish the free blocks found by the thread that claimed the page.
+  void SetSwept() {
+    AtomicWord previous = OS::CompareAndSwap(&state_, SWEEPING, SWEPT);
+    USE(previous);
+    ASSERT(previous == SWEEPING);
+  }
+
+  // True if the free blocks have been found.  The compare-and-swap makes
+  // the free blocks visible to the calling thread.
+  bool IsSwept() {
+    AtomicWord state = OS::CompareAndSwap(&state_, SWEPT, SWEPT);
+    return state == SWEPT || state == DONE;
+  }
+
+  bool IsDone() { return state_ == DONE; }
+  void SetDone() { state_ = DONE; }
+
+  bool IsBeingSwept() { return state_ == SWEEPING; }
+
+ private:
+  OldSpace* space_;
+  Page* page_;
+  Address limit_;
+  uintptr_t* bitmap_;
+  Address bitmap_start_;
+  volatile AtomicWord state_;
+  List<Address> free_blocks_;
+  int largest_free_block_;
+
+  DISALLOW_COPY_AND_ASSIGN(DeferredPage);
+};
+
+
+class SweeperThread : public Thread {
+ public:
+  SweeperThread()
+      : start_(OS::CreateSemaphore(0)),
+        done_(OS::CreateSemaphore(0)),
+        stopped_(false),
+        time_(0) { }
+
+  ~SweeperThread() {
+    delete start_;
+    delete done_;
+  }
+
+  void Run() {
+    while (true) {
+      start_->Wait();
+      if (stopped_) return;
+      double start = OS::TimeCurrentMillis();
+      Sweeper::SweepInBackground();
+      time_ = OS::TimeCurrentMillis() - start;
+      done_->Signal();
+    }
+  }
+
+  void StartSweeping() { start_->Signal(); }
+
+  // Returns false if the thread is still sweeping and block is false.
+  bool WaitForSweeping(bool block) {
+    if (block) {
+      done_->Wait();
+      return true;
+    }
+    return done_->Wait(0);
+  }
+
+  // The time (in ms) the thread spent sweeping.  Only valid after
+  // WaitForSweeping returned true.
+  double time() { return time_; }
+
+  void Stop() {
+    stopped_ = true;
+    start_->Signal();
+    Join();
+  }
+
+ private:
+  Semaphore* start_;
+  Semaphore* done_;
+  volatile bool stopped_;
+  double time_;
+};
+
+
+bool Sweeper::deferring_ = false;
+bool Sweeper::concurrent_ = false;
+int Sweeper::pending_pages_ = 0;
+uintptr_t** Sweeper::chunk_bitmaps_ = NULL;
+List<DeferredPage*>* Sweeper::pages_ = NULL;
+int Sweeper::cursors_[LAST_SPACE + 1];
+int Sweeper::limits_[LAST_SPACE + 1];
+HashMap* Sweeper::page_map_ = NULL;
+SweeperThread* Sweeper::thread_ = NULL;
+bool Sweeper::thread_running_ = false;
+double Sweeper::lazy_sweeping_time_ = 0;
+double Sweeper::concurrent_sweeping_time_ = 0;
+
+
+static bool PageMatch(void* key1, void* key2) {
+  return key1 == key2;
+}
+
+
+static uint32_t PageHash(Page* page) {
+  return static_cast<uint32_t>(
+      reinterpret_cast<uintptr_t>(page) >> kPageSizeBits);
+}
+
+
+// Returns the address of the first live object at or after the given
+// index of the bitmap and below the limit, or NULL.  Updates the index.
+static Address NextLiveObject(uintptr_t* bitmap,
+                              Address bitmap_start,
+                              int* index,
+                              int limit_index) {
+  int i = *index;
+  while (i < limit_index) {
+    uintptr_t cell = bitmap[i / kBitsPerPointer] >> (i % kBitsPerPointer);
+    if (cell == 0) {
+      i = (i / kBitsPerPointer + 1) * kBitsPerPointer;
+      continue;
+    }
+    while ((cell & 1) == 0) {
+      cell >>= 1;
+      i++;
+    }
+    if (i >= limit_index) break;
+    *index = i + 1;
+    return bitmap_start + (i << kPointerSizeLog2);
+  }
+  *index = limit_index;
+  return NULL;
+}
+
+
+static int BitmapIndex(Address bitmap_start, Address address) {
+  return static_cast<int>((address - bitmap_start) >> kPointerSizeLog2);
+}
+
+
+void Sweeper::Prepare(bool is_compacting) {
+  EnsureCompleted();
+  deferring_ = false;
+  if (is_compacting) return;
+
+  if (strcmp(FLAG_sweeping, "lazy") == 0) {
+    concurrent_ = false;
+  } else if (strcmp(FLAG_sweeping, "concurrent") == 0) {
+    concurrent_ = true;
+  } else {
+    return;
+  }
+
+#ifdef ENABLE_LOGGING_AND_PROFILING
+  // Dead code objects and functions are reported while sweeping.
+  if (Logger::is_logging() || CpuProfiler::is_profiling()) return;
+#endif
+
+  if (chunk_bitmaps_ == NULL) {
+    chunk_bitmaps_ = NewArray<uintptr_t*>(MemoryAllocator::kMaxNofChunks);
+    for (int i = 0; i < MemoryAllocator::kMaxNofChunks; i++) {
+      chunk_bitmaps_[i] = NULL;
+    }
+    pages_ = new List<DeferredPage*>();
+    page_map_ = new HashMap(&PageMatch);
+  }
+
+  OldSpaces spaces;
+  for (OldSpace* space = spaces.next();
+       space != NULL;
+       space = spaces.next()) {
+    PageIterator it(space, PageIterator::PAGES_IN_USE);
+    while (it.has_next()) {
+      int chunk_id = MemoryAllocator::GetChunkId(it.next());
+      if (chunk_bitmaps_[chunk_id] != NULL) continue;
+      size_t chunk_size = MemoryAllocator::chunks_[chunk_id].size();
+      int length =
+          static_cast<int>((chunk_size >> kPointerSizeLog2) / kBitsPerPointer);
+      uintptr_t* bitmap = NewArray<uintptr_t>(length + 1);
+      memset(bitmap, 0, (length + 1) * sizeof(uintptr_t));
+      chunk_bitmaps_[chunk_id] = bitmap;
+    }
+  }
+  deferring_ = true;
+}
+
+
+void Sweeper::RecordLiveObjectSlow(HeapObject* object, bool atomic) {
+  if (Heap::InNewSpace(object)) return;
+  Page* page = Page::FromAddress(object->address());
+  if (page->IsLargeObjectPage()) return;
+  int chunk_id = MemoryAllocator::GetChunkId(page);
+  uintptr_t* bitmap = chunk_bitmaps_[chunk_id];
+  if (bitmap == NULL) return;
+
+  int index = BitmapIndex(MemoryAllocator::chunks_[chunk_id].address(),
+                          object->address());
+  uintptr_t mask = static_cast<uintptr_t>(1) << (index % kBitsPerPointer);
+  uintptr_t* cell = &bitmap[index / kBitsPerPointer];
+  if (!atomic) {
+    *cell |= mask;
+    return;
+  }
+  volatile AtomicWord* address = reinterpret_cast<volatile AtomicWord*>(cell);
+  AtomicWord value = *address;
+  while (true) {
+    AtomicWord previous = OS::CompareAndSwap(
+        address, value, value | static_cast<AtomicWord>(mask));
+    if (previous == value) break;
+    value = previous;
+  }
+}
+
+
+void Sweeper::DeferSweeping(OldSpace* space) {
+  ASSERT(deferring_);
+  int first = pages_->length();
+  int free_bytes = 0;
+
+  // As in the eager sweep, sequences of empty pages are moved to the end of
+  // the space and the allocation top moves back to the end of the last live
+  // object, so that the free space they leave is allocated linearly.
+  Page* prev = Page::FromAddress(NULL);
+  Page* first_empty_page = Page::FromAddress(NULL);
+  Page* prec_first_empty_page = Page::FromAddress(NULL);
+  Address last_live_end = space->bottom();
+
+  PageIterator it(space, PageIterator::PAGES_IN_USE);
+  while (it.has_next()) {
+    Page* page = it.next();
+    int chunk_id = MemoryAllocator::GetChunkId(page);
+    uintptr_t* bitmap = chunk_bitmaps_[chunk_id];
+    ASSERT(bitmap != NULL);
+    Address bitmap_start = MemoryAllocator::chunks_[chunk_id].address();
+    Address limit = page->AllocationTop();
+
+    // Clear the mark bits of the live objects.
+    int live_bytes = 0;
+    Address live_end = NULL;
+    int index = BitmapIndex(bitmap_start, page->ObjectAreaStart());
+    int limit_index = BitmapIndex(bitmap_start, limit);
+    Address current;
+    while ((current = NextLiveObject(bitmap,
+                                     bitmap_start,
+                                     &index,
+                                     limit_index)) != NULL) {
+      HeapObject* object = HeapObject::FromAddress(current);
+      ASSERT(object->IsMarked());
+      object->ClearMark();
+      MarkCompactCollector::tracer()->decrement_marked_count();
+      int size = object->Size();
+      live_bytes += size;
+      live_end = current + size;
+    }
+    free_bytes += static_cast<int>(limit - page->ObjectAreaStart()) -
+        live_bytes;
+
+    if (live_bytes == 0) {
+      if (!first_empty_page->is_valid()) {
+        first_empty_page = page;
+        prec_first_empty_page = prev;
+      }
+    } else {
+      if (first_empty_page->is_valid()) {
+        space->FreePages(prec_first_empty_page, prev);
+        prec_first_empty_page = first_empty_page = Page::FromAddress(NULL);
+      }
+      if (live_bytes < limit - page->ObjectAreaStart()) {
+        pages_->Add(
+            new DeferredPage(space, page, limit, bitmap, bitmap_start));
+      }
+      last_live_end = live_end;
+    }
+    prev = page;
+  }
+
+  // The free space after the last live object is not put on the free list.
+  if (pages_->length() > first &&
+      Page::FromAllocationTop(last_live_end) == pages_->last()->page()) {
+    pages_->last()->set_limit(last_live_end);
+  }
+  space->SetTop(last_live_end);
+
+  for (int i = first; i < pages_->length(); i++) {
+    Page* page = pages_->at(i)->page();
+    HashMap::Entry* entry = page_map_->Lookup(page, PageHash(page), true);
+    entry->value = pages_->at(i);
+    pending_pages_++;
+  }
+  cursors_[space->identity()] = first;
+  limits_[space->identity()] = pages_->length();
+
+  // The free bytes are accounted as available now; the blocks are put on
+  // the free list when they are found.
+  space->DeallocateDeferredBytes(free_bytes);
+}
+
+
+void Sweeper::StartSweeping() {
+  deferring_ = false;
+  if (pending_pages_ == 0 || !concurrent_) return;
+  if (thread_ == NULL) {
+    thread_ = new SweeperThread();
+    thread_->Start();
+  }
+  thread_running_ = true;
+  thread_->StartSweeping();
+}
+
+
+bool Sweeper::FindFreeBlocks(DeferredPage* deferred) {
+  if (!deferred->Claim()) return false;
+
+  uintptr_t* bitmap = deferred->bitmap();
+  Address bitmap_start = deferred->bitmap_start();
+  List<Address>* free_blocks = deferred->free_blocks();
+  int largest_free_block = 0;
+
+  Address free_start = deferred->page()->ObjectAreaStart();
+  int index = BitmapIndex(bitmap_start, free_start);
+  int limit_index = BitmapIndex(bitmap_start, deferred->limit());
+  Address current;
+  while ((current = NextLiveObject(bitmap,
+                                   bitmap_start,
+                                   &index,
+                                   limit_index)) != NULL) {
+    if (current > free_start) {
+      free_blocks->Add(free_start);
+      free_blocks->Add(current);
+      largest_free_block =
+          Max(largest_free_block, static_cast<int>(current - free_start));
+    }
+    free_start = current + HeapObject::FromAddress(current)->Size();
+  }
+  if (deferred->limit() > free_start) {
+    free_blocks->Add(free_start);
+    free_blocks->Add(deferred->limit());
+    largest_free_block = Max(largest_free_block,
+                             static_cast<int>(deferred->limit() - free_start));
+  }
+
+  deferred->set_largest_free_block(largest_free_block);
+  deferred->SetSwept();
+  return true;
+}
+
+
+void Sweeper::AddFreeBlocks(DeferredPage* deferred) {
+  ASSERT(deferred->IsSwept() && !deferred->IsDone());
+  OldSpace* space = deferred->space();
+  Page* page = deferred->page();
+  List<Address>* free_blocks = deferred->free_blocks();
+  for (int i = 0; i < free_blocks->length(); i += 2) {
+    Address start = free_blocks->at(i);
+    Address end = free_blocks->at(i + 1);
+    if (end == space->PageAllocationLimit(page) &&
+        page != space->AllocationTopPage()) {
+      // Memory above the allocation watermark is assumed to be free (see
+      // OldSpace::SlowAllocateRaw), so a free block at the end of the page
+      // moves the watermark down.
+      page->SetAllocationWatermark(start);
+    }
+    space->FreeDeferredBlock(start, static_cast<int>(end - start));
+  }
+  free_blocks->Free();
+  deferred->SetDone();
+  pending_pages_--;
+}
+
+
+void Sweeper::SweepPage(DeferredPage* deferred) {
+  if (deferred->IsDone()) return;
+  if (!FindFreeBlocks(deferred)) {
+    // The background thread is sweeping the page.
+    while (!deferred->IsSwept()) Thread::YieldCPU();
+  }
+  AddFreeBlocks(deferred);
+}
+
+
+bool Sweeper::SweepForAllocation(OldSpace* space, int size_in_bytes) {
+  // The pages of a space are contiguous in pages_.  Pages before the cursor
+  // have been swept.
+  int* cursor = &cursors_[space->identity()];
+  int limit = limits_[space->identity()];
+  if (*cursor == limit) return false;
+  double start = OS::TimeCurrentMillis();
+  bool added = false;
+  for (int i = *cursor; i < limit; i++) {
+    DeferredPage* deferred = pages_->at(i);
+    if (!deferred->IsDone()) {
+      // Leave the page the background thread is working on to it.
+      if (deferred->IsBeingSwept()) continue;
+      SweepPage(deferred);
+      added = true;
+    }
+    if (i == *cursor) (*cursor)++;
+    if (added && deferred->largest_free_block() >= size_in_bytes) break;
+  }
+  lazy_sweeping_time_ += OS::TimeCurrentMillis() - start;
+  return added;
+}
+
+
+void Sweeper::EnsureSweptSlow(Address address) {
+  Page* page = Page::FromAddress(address);
+  HashMap::Entry* entry = page_map_->Lookup(page, PageHash(page), false);
+  if (entry == NULL) return;
+  DeferredPage* deferred = reinterpret_cast<DeferredPage*>(entry->value);
+  if (deferred->IsDone()) return;
+  double start = OS::TimeCurrentMillis();
+  SweepPage(deferred);
+  lazy_sweeping_time_ += OS::TimeCurrentMillis() - start;
+}
+
+
+void Sweeper::EnsureSwept(PagedSpace* space) {
+  int* cursor = &cursors_[space->identity()];
+  int limit = limits_[space->identity()];
+  if (*cursor == limit) return;
+  double start = OS::TimeCurrentMillis();
+  for (int i = *cursor; i < limit; i++) {
+    SweepPage(pages_->at(i));
+  }
+  *cursor = limit;
+  lazy_sweeping_time_ += OS::TimeCurrentMillis() - start;
+}
+
+
+void Sweeper::EnsureCompleted() {
+  if (pages_ == NULL) return;
+  if (!pages_->is_empty()) {
+    double start = OS::TimeCurrentMillis();
+    for (int i = 0; i < pages_->length(); i++) {
+      SweepPage(pages_->at(i));
+    }
+    WaitForThread(true);
+    lazy_sweeping_time_ += OS::TimeCurrentMillis() - start;
+    ASSERT(pending_pages_ == 0);
+
+    for (int i = 0; i < pages_->length(); i++) {
+      delete pages_->at(i);
+    }
+    pages_->Clear();
+    page_map_->Clear();
+    for (int i = 0; i <= LAST_SPACE; i++) {
+      cursors_[i] = limits_[i] = 0;
+    }
+  }
+  FreeBitmaps();
+}
+
+
+void Sweeper::SweepInBackground() {
+  for (int i = 0; i < pages_->length(); i++) {
+    FindFreeBlocks(pages_->at(i));
+  }
+}
+
+
+void Sweeper::WaitForThread(bool block) {
+  if (!thread_running_) return;
+  if (!thread_->WaitForSweeping(block)) return;
+  concurrent_sweeping_time_ += thread_->time();
+  thread_running_ = false;
+}
+
+
+void Sweeper::FreeBitmaps() {
+  for (int i = 0; i < MemoryAllocator::kMaxNofChunks; i++) {
+    DeleteArray(chunk_bitmaps_[i]);
+    chunk_bitmaps_[i] = NULL;
+  }
+}
+
+
+double Sweeper::TakeLazySweepingTime() {
+  double time = lazy_sweeping_time_;
+  lazy_sweeping_time_ = 0;
+  return time;
+}
+
+
+double Sweeper::TakeConcurrentSweepingTime() {
+  // The time of the background thread is only known once it is done.
+  WaitForThread(false);
+  double time = concurrent_sweeping_time_;
+  concurrent_sweeping_time_ = 0;
+  return time;
+}
+
+
+void Sweeper::TearDown() {
+  if (pages_ != NULL) {
+    EnsureCompleted();
+    delete pages_;
+    pages_ = NULL;
+    delete page_map_;
+    page_map_ = NULL;
+    DeleteArray(chunk_bitmaps_);
+    chunk_bitmaps_ = NULL;
+  }
+  if (thread_ != NULL) {
+    thread_->Stop();
+    delete thread_;
+    thread_ = NULL;
+  }
+  deferring_ = false;
+}
+
+} }  // namespace v8::internal
@@ -0,0 +1,166 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef V8_SWEEPER_H_
+#define V8_SWEEPER_H_
+
+namespace v8 {
+namespace internal {
+
+class DeferredPage;
+class HashMap;
+class OldSpace;
+class PagedSpace;
+class SweeperThread;
+
+// -------------------------------------------------------------------------
+// Sweeper
+//
+// After a non-compacting full collection the old pointer, old data and code
+// spaces are swept: the mark bits of live objects are cleared and the space
+// between live objects is put on the free lists.  With --sweeping=eager
+// MarkCompactCollector::SweepSpaces does all of it before the mutator
+// resumes.
+//
+// With --sweeping=lazy or --sweeping=concurrent the collector also records
+// the address of each live object of these spaces in a side bitmap while
+// marking.  The pause then only clears the mark bits of the live objects,
+// which cannot be deferred because the mark bits live in the map words;
+// dead objects are not visited.  The free blocks of a page are found later
+// from its bitmap and the sizes of its live objects:
+//
+//  - lazy: by the main thread, a page at a time, when the free list of the
+//    space runs dry;
+//  - concurrent: by a background thread started at the end of the pause.
+//    The thread does not write to the heap.  The main thread puts the free
+//    blocks it found on the free lists when they are needed.
+//
+// Dead objects on a page that has not been swept may refer to freed maps,
+// so such pages cannot be iterated.  Heap iterators and the next full
+// collection finish sweeping first.  An object that is shrunk in place at
+// its end leaves a filler that is either found free or swept later, but an
+// object trimmed at its start no longer starts at its recorded address, so
+// its page is swept first (see EnsureSwept).
+class Sweeper : public AllStatic {
+ public:
+  // Called by the collector before marking.  Decides whether sweeping is
+  // deferred in this collection and sets up the live object bitmaps.
+  static void Prepare(bool is_compacting);
+
+  // True if the current collection defers sweeping.
+  static bool IsDeferring() { return deferring_; }
+
+  // Record a live object.  Only objects in pages that will be swept lazily
+  // are recorded.  The atomic version is used by parallel marking threads.
+  static inline void RecordLiveObject(HeapObject* object) {
+    if (deferring_) RecordLiveObjectSlow(object, false);
+  }
+  static inline void RecordLiveObjectAtomic(HeapObject* object) {
+    if (deferring_) RecordLiveObjectSlow(object, true);
+  }
+
+  // Called by the collector instead of sweeping the space.  Clears the mark
+  // bits of the live objects of the space and queues its pages.
+  static void DeferSweeping(OldSpace* space);
+
+  // Called at the end of the collection.  Starts the background thread
+  // with --sweeping=concurrent.
+  static void StartSweeping();
+
+  // Called when the free list of the space cannot satisfy an allocation.
+  // Adds free blocks of deferred pages to the free list until it has a
+  // block of at least the given size.  Returns false if no block was
+  // added.
+  static bool SweepForAllocation(OldSpace* space, int size_in_bytes);
+
+  // Sweep the page containing the address if it has not been swept yet.
+  // Must be called before an object in a paged space is moved within its
+  // page or the page is searched for an object.
+  static inline void EnsureSwept(Address address) {
+    if (pending_pages_ > 0) EnsureSweptSlow(address);
+  }
+
+  // Finish sweeping a space, or all spaces.
+  static void EnsureSwept(PagedSpace* space);
+  static void EnsureCompleted();
+
+  // True while there are pages that have not been swept.
+  static bool IsSweeping() { return pending_pages_ > 0; }
+
+  // The time (in ms) the main thread and the background thread spent
+  // sweeping deferred pages since the last call.  The time of the
+  // background thread is reported once it has finished.
+  static double TakeLazySweepingTime();
+  static double TakeConcurrentSweepingTime();
+
+  static void TearDown();
+
+ private:
+  static void RecordLiveObjectSlow(HeapObject* object, bool atomic);
+  static void EnsureSweptSlow(Address address);
+
+  // Find the free blocks of a deferred page, unless another thread has
+  // claimed it.  Only reads the heap.  Returns false if the page was
+  // claimed by another thread.
+  static bool FindFreeBlocks(DeferredPage* page);
+
+  // Put the free blocks of a page on the free list of its space.
+  static void AddFreeBlocks(DeferredPage* page);
+
+  // Sweep a page on the main thread, waiting for the background thread if
+  // it is sweeping the page.
+  static void SweepPage(DeferredPage* page);
+
+  // Called by the background thread.
+  static void SweepInBackground();
+
+  // Wait for the background thread to finish, or just check whether it has
+  // finished if block is false.
+  static void WaitForThread(bool block);
+
+  static void FreeBitmaps();
+
+  static bool deferring_;
+  static bool concurrent_;
+  static int pending_pages_;
+  static uintptr_t** chunk_bitmaps_;
+  static List<DeferredPage*>* pages_;
+  static int cursors_[LAST_SPACE + 1];
+  static int limits_[LAST_SPACE + 1];
+  static HashMap* page_map_;
+  static SweeperThread* thread_;
+  static bool thread_running_;
+  static double lazy_sweeping_time_;
+  static double concurrent_sweeping_time_;
+
+  friend class SweeperThread;
+};
+
+} }  // namespace v8::internal
+
+#endif  // V8_SWEEPER_H_
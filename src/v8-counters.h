@@ -72,6 +72,8 @@ namespace internal {
   SC(alive_after_last_gc, V8.AliveAfterLastGC)                        \
   SC(objs_since_last_young, V8.ObjsSinceLastYoung)                    \
   SC(objs_since_last_full, V8.ObjsSinceLastFull)                      \
+  SC(store_buffer_compactions, V8.StoreBufferCompactions)             \
+  SC(store_buffer_overflows, V8.StoreBufferOverflows)                 \
   SC(symbol_table_capacity, V8.SymbolTableCapacity)                   \
   SC(number_of_symbols, V8.NumberOfSymbols)                           \
   SC(script_wrappers, V8.ScriptWrappers)                              \
@@ -118,6 +120,8 @@ namespace internal {
      V8.GCCompactorCausedByOldspaceExhaustion)                        \
   SC(gc_compactor_caused_by_weak_handles,                             \
      V8.GCCompactorCausedByWeakHandles)                               \
+  SC(gc_compactor_caused_by_incremental_marking,                      \
+     V8.GCCompactorCausedByIncrementalMarking)                        \
   SC(gc_last_resort_from_js, V8.GCLastResortFromJS)                   \
   SC(gc_last_resort_from_handles, V8.GCLastResortFromHandles)         \
   SC(map_slow_to_fast_elements, V8.MapSlowToFastElements)             \
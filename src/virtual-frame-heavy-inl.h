@@ -134,6 +134,13 @@ void VirtualFrame::SetTypeForParamAt(int index, TypeInfo info) {
 }
 
 
+void VirtualFrame::ForgetTypeInfo() {
+  for (int i = 0; i < element_count(); i++) {
+    elements_[i].set_type_info(TypeInfo::Unknown());
+  }
+}
+
+
 void VirtualFrame::Nip(int num_dropped) {
   ASSERT(num_dropped >= 0);
   if (num_dropped == 0) return;
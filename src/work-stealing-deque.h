@@ -0,0 +1,112 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef V8_WORK_STEALING_DEQUE_H_
+#define V8_WORK_STEALING_DEQUE_H_
+
+namespace v8 {
+namespace internal {
+
+// A deque of heap objects owned by one of the threads of a parallel
+// collector phase.  Objects the owner discovers are pushed on the private
+// part of its deque, which is accessed without synchronization.  When
+// nothing is left for other threads to take, a chunk of the private part is
+// moved to the shared part, which is protected by a mutex.  A thread that
+// runs out of work first takes back its own shared entries and then steals
+// half of the shared entries of another thread.  The deque grows on demand.
+class WorkStealingDeque {
+ public:
+  WorkStealingDeque() : mutex_(OS::CreateMutex()), shared_length_(0) { }
+
+  ~WorkStealingDeque() { delete mutex_; }
+
+  // Push an object.  Only called by the owner of the deque.
+  inline void Push(HeapObject* object) {
+    private_.Add(object);
+    if (shared_length_ == 0 && private_.length() >= kMinShareLength) {
+      Share();
+    }
+  }
+
+  // Pop an object from the private part of the deque.  Only called by the
+  // owner of the deque.  Returns false if the private part is empty.
+  inline bool Pop(HeapObject** object) {
+    if (private_.is_empty()) return false;
+    *object = private_.RemoveLast();
+    return true;
+  }
+
+  // Move half of the shared entries of the victim deque to the private part
+  // of this deque.  The victim can be this deque.  Returns false if there
+  // was nothing to take.
+  bool StealFrom(WorkStealingDeque* victim) {
+    if (!victim->HasSharedWork()) return false;
+    ScopedLock lock(victim->mutex_);
+    int count = (victim->shared_.length() + 1) / 2;
+    if (count == 0) return false;
+    for (int i = 0; i < count; i++) {
+      private_.Add(victim->shared_.RemoveLast());
+    }
+    victim->shared_length_ = victim->shared_.length();
+    return true;
+  }
+
+  // True if other threads might be able to steal from this deque.  Read
+  // without synchronization, so it is only a hint.
+  bool HasSharedWork() { return shared_length_ != 0; }
+
+  bool IsEmpty() { return private_.is_empty() && !HasSharedWork(); }
+
+ private:
+  // Move the top of the private part to the shared part.
+  void Share() {
+    ScopedLock lock(mutex_);
+    int count = Min(private_.length() / 2, kMaxShareLength);
+    for (int i = 0; i < count; i++) {
+      shared_.Add(private_.RemoveLast());
+    }
+    shared_length_ = shared_.length();
+  }
+
+  // Entries are shared only when the private part holds at least
+  // kMinShareLength entries, and at most kMaxShareLength entries are
+  // shared at a time.
+  static const int kMinShareLength = 16;
+  static const int kMaxShareLength = 256;
+
+  List<HeapObject*> private_;
+  List<HeapObject*> shared_;
+  Mutex* mutex_;
+  volatile int shared_length_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingDeque);
+};
+
+} }  // namespace v8::internal
+
+#endif  // V8_WORK_STEALING_DEQUE_H_
@@ -951,6 +951,20 @@ static void Generate_JSConstructStubHelper(MacroAssembler* masm,
     __ CmpInstanceType(rax, JS_FUNCTION_TYPE);
     __ j(equal, &rt_call);
 
+    // Leave the allocation to the runtime while the allocation site of the
+    // constructor collects feedback, or when it tenures the objects.
+    // rdi: constructor
+    // rax: initial map
+    Label allocate;
+    __ movq(rcx, FieldOperand(rdi, JSFunction::kSharedFunctionInfoOffset));
+    __ movq(rcx, FieldOperand(rcx, SharedFunctionInfo::kAllocationSiteOffset));
+    __ CompareRoot(rcx, Heap::kUndefinedValueRootIndex);
+    __ j(equal, &allocate);
+    __ SmiCompare(FieldOperand(rcx, AllocationSite::kStateOffset),
+                  Smi::FromInt(AllocationSite::kPending));
+    __ j(less, &rt_call);
+    __ bind(&allocate);
+
     // Now allocate the JSObject on the heap.
     __ movzxbq(rdi, FieldOperand(rax, Map::kInstanceSizeOffset));
     __ shl(rdi, Immediate(kPointerSizeLog2));
@@ -1306,6 +1320,26 @@ void Builtins::Generate_LazyCompile(MacroAssembler* masm) {
   __ jmp(rcx);
 }
 
+
+void Builtins::Generate_LazyRecompile(MacroAssembler* masm) {
+  // Enter an internal frame.
+  __ EnterInternalFrame();
+
+  // Push a copy of the function onto the stack.
+  __ push(rdi);
+
+  __ push(rdi);  // Function is also the parameter to the runtime call.
+  __ CallRuntime(Runtime::kLazyRecompile, 1);
+  __ pop(rdi);
+
+  // Tear down temporary frame.
+  __ LeaveInternalFrame();
+
+  // Do a tail-call of the recompiled function.
+  __ lea(rcx, FieldOperand(rax, Code::kHeaderSize));
+  __ jmp(rcx);
+}
+
 } }  // namespace v8::internal
 
 #endif  // V8_TARGET_ARCH_X64
@@ -150,6 +150,19 @@ void FastCloneShallowArrayStub::Generate(MacroAssembler* masm) {
   __ CompareRoot(rcx, Heap::kUndefinedValueRootIndex);
   __ j(equal, &slow_case);
 
+  // Leave the cloning to the runtime while the allocation site of the literal
+  // collects feedback, or when it tenures the arrays.
+  Label allocate;
+  __ movq(rbx, Operand(rsp, 3 * kPointerSize));
+  __ movq(rbx, FieldOperand(rbx, index.reg, index.scale,
+                            FixedArray::kHeaderSize + kPointerSize));
+  __ CompareRoot(rbx, Heap::kUndefinedValueRootIndex);
+  __ j(equal, &allocate);
+  __ SmiCompare(FieldOperand(rbx, AllocationSite::kStateOffset),
+                Smi::FromInt(AllocationSite::kPending));
+  __ j(less, &slow_case);
+  __ bind(&allocate);
+
   if (FLAG_debug_code) {
     const char* message;
     Heap::RootListIndex expected_map_index;
@@ -3052,6 +3065,184 @@ const char* CompareStub::GetName() {
 }
 
 
+Token::Value ICCompareStub::ComputeOperation(Condition cc, bool strict) {
+  switch (cc) {
+    case equal: return strict ? Token::EQ_STRICT : Token::EQ;
+    case less: return Token::LT;
+    case greater: return Token::GT;
+    case less_equal: return Token::LTE;
+    case greater_equal: return Token::GTE;
+    default:
+      UNREACHABLE();
+      return Token::ILLEGAL;
+  }
+}
+
+
+Condition ICCompareStub::GetCondition() {
+  switch (op_) {
+    case Token::EQ:
+    case Token::EQ_STRICT:
+      return equal;
+    case Token::LT: return less;
+    case Token::GT: return greater;
+    case Token::LTE: return less_equal;
+    case Token::GTE: return greater_equal;
+    default:
+      UNREACHABLE();
+      return no_condition;
+  }
+}
+
+
+void ICCompareStub::GenerateHeapNumbers(MacroAssembler* masm) {
+  ASSERT(type_info_ == CompareIC::HEAP_NUMBERS);
+  Label unordered, miss;
+
+  // Load left and right operand, which must be smis or heap numbers.
+  FloatingPointHelper::LoadSSE2UnknownOperands(masm, &miss);
+  __ xorl(rax, rax);
+  __ xorl(rcx, rcx);
+  __ ucomisd(xmm0, xmm1);
+
+  // Don't base result on EFLAGS when a NaN is involved.
+  __ j(parity_even, &unordered);
+  // Return a result of -1, 0, or 1, based on EFLAGS.
+  __ setcc(above, rax);
+  __ setcc(below, rcx);
+  __ subq(rax, rcx);
+  __ ret(0);
+
+  // If one of the numbers was NaN, then the result is always false.
+  __ bind(&unordered);
+  Condition cc = GetCondition();
+  if (cc == less || cc == less_equal) {
+    __ Set(rax, 1);
+  } else {
+    __ Set(rax, -1);
+  }
+  __ ret(0);
+
+  __ bind(&miss);
+  GenerateMiss(masm);
+}
+
+
+void ICCompareStub::GenerateSymbols(MacroAssembler* masm) {
+  ASSERT(type_info_ == CompareIC::SYMBOLS);
+  ASSERT(GetCondition() == equal);
+  Label miss;
+
+  // Check that both operands are heap objects.
+  Condition either_smi = masm->CheckEitherSmi(rdx, rax);
+  __ j(either_smi, &miss);
+
+  // Check that both operands are symbols.
+  __ movq(rcx, FieldOperand(rdx, HeapObject::kMapOffset));
+  __ movq(rbx, FieldOperand(rax, HeapObject::kMapOffset));
+  __ movzxbq(rcx, FieldOperand(rcx, Map::kInstanceTypeOffset));
+  __ movzxbq(rbx, FieldOperand(rbx, Map::kInstanceTypeOffset));
+  STATIC_ASSERT(LAST_TYPE < kNotStringTag + kIsSymbolMask);
+  STATIC_ASSERT(kSymbolTag != 0);
+  __ and_(rcx, rbx);
+  __ testb(rcx, Immediate(kIsSymbolMask));
+  __ j(zero, &miss);
+
+  // Symbols are equal only if they are identical. Register rax already
+  // holds a non-zero value, which indicates not equal.
+  Label done;
+  __ cmpq(rdx, rax);
+  __ j(not_equal, &done);
+  __ Move(rax, Smi::FromInt(EQUAL));
+  __ bind(&done);
+  __ ret(0);
+
+  __ bind(&miss);
+  GenerateMiss(masm);
+}
+
+
+void ICCompareStub::GenerateStrings(MacroAssembler* masm) {
+  ASSERT(type_info_ == CompareIC::STRINGS);
+  Label miss;
+
+  // Identical strings are equal. This also holds for the relational
+  // operators, as no string is NaN.
+  Label not_identical;
+  __ cmpq(rdx, rax);
+  __ j(not_equal, &not_identical);
+  __ Move(rax, Smi::FromInt(EQUAL));
+  __ ret(0);
+
+  // Check that both operands are flat ascii strings and compare them.
+  __ bind(&not_identical);
+  __ JumpIfNotBothSequentialAsciiStrings(rdx, rax, rcx, rbx, &miss);
+  StringCompareStub::GenerateCompareFlatAsciiStrings(masm,
+                                                     rdx,
+                                                     rax,
+                                                     rcx,
+                                                     rbx,
+                                                     rdi,
+                                                     r8);
+
+  __ bind(&miss);
+  GenerateMiss(masm);
+}
+
+
+void ICCompareStub::GenerateObjects(MacroAssembler* masm) {
+  ASSERT(type_info_ == CompareIC::OBJECTS);
+  ASSERT(GetCondition() == equal);
+  Label miss;
+
+  // Check that both operands are JS objects.
+  Condition either_smi = masm->CheckEitherSmi(rdx, rax);
+  __ j(either_smi, &miss);
+  __ CmpObjectType(rax, FIRST_JS_OBJECT_TYPE, rcx);
+  __ j(below, &miss);
+  __ CmpObjectType(rdx, FIRST_JS_OBJECT_TYPE, rcx);
+  __ j(below, &miss);
+
+  // Objects are equal only if they are identical.
+  __ subq(rax, rdx);
+  __ ret(0);
+
+  __ bind(&miss);
+  GenerateMiss(masm);
+}
+
+
+void ICCompareStub::GenerateMiss(MacroAssembler* masm) {
+  // Save the operands below the return address, where they survive the
+  // call to the runtime system.
+  __ pop(rcx);
+  __ push(rdx);
+  __ push(rax);
+  __ push(rcx);
+
+  // Call the runtime system in a fresh internal frame. It patches the call
+  // site and returns the code object of the new stub.
+  ExternalReference miss = ExternalReference(IC_Utility(IC::kCompareIC_Miss));
+  __ EnterInternalFrame();
+  __ push(rdx);
+  __ push(rax);
+  __ Push(Smi::FromInt(op_));
+  __ Push(Smi::FromInt(type_info_));
+  __ CallExternalReference(miss, 4);
+  __ LeaveInternalFrame();
+
+  // Compute the entry point of the new stub.
+  __ lea(rdi, FieldOperand(rax, Code::kHeaderSize));
+
+  // Restore the operands and tail call the new stub.
+  __ pop(rcx);
+  __ pop(rax);
+  __ pop(rdx);
+  __ push(rcx);
+  __ jmp(rdi);
+}
+
+
 // -------------------------------------------------------------------------
 // StringCharCodeAtGenerator
 
@@ -151,6 +151,9 @@ CodeGenerator::CodeGenerator(MacroAssembler* masm)
       allocator_(NULL),
       state_(NULL),
       loop_nesting_(0),
+      in_safe_int32_mode_(false),
+      safe_int32_mode_enabled_(true),
+      unsafe_bailout_(NULL),
       function_return_is_shadowed_(false),
       in_spilled_code_(false) {
 }
@@ -506,61 +509,115 @@ void CodeGenerator::LoadAndSpill(Expression* expression) {
 }
 
 
+void CodeGenerator::LoadInSafeInt32Mode(Expression* expr,
+                                         BreakTarget* unsafe_bailout) {
+  set_unsafe_bailout(unsafe_bailout);
+  set_in_safe_int32_mode(true);
+  Load(expr);
+  Result value = frame_->Pop();
+  ASSERT(frame_->HasNoUntaggedInt32Elements());
+  ConvertInt32ResultToSmi(&value);
+  set_in_safe_int32_mode(false);
+  set_unsafe_bailout(NULL);
+  frame_->Push(&value);
+}
+
+
+void CodeGenerator::LoadWithSafeInt32ModeDisabled(Expression* expr) {
+  set_safe_int32_mode_enabled(false);
+  Load(expr);
+  set_safe_int32_mode_enabled(true);
+}
+
+
+void CodeGenerator::ConvertInt32ResultToSmi(Result* value) {
+  ASSERT(value->is_untagged_int32());
+  if (value->is_register()) {
+    __ Integer32ToSmi(value->reg(), value->reg());
+  } else {
+    ASSERT(value->is_constant());
+    ASSERT(value->handle()->IsSmi());
+  }
+  value->set_untagged_int32(false);
+  value->set_type_info(TypeInfo::Smi());
+}
+
+
 void CodeGenerator::Load(Expression* expr) {
 #ifdef DEBUG
   int original_height = frame_->height();
 #endif
   ASSERT(!in_spilled_code());
-  JumpTarget true_target;
-  JumpTarget false_target;
-  ControlDestination dest(&true_target, &false_target, true);
-  LoadCondition(expr, &dest, false);
 
-  if (dest.false_was_fall_through()) {
-    // The false target was just bound.
-    JumpTarget loaded;
-    frame_->Push(Factory::false_value());
-    // There may be dangling jumps to the true target.
-    if (true_target.is_linked()) {
-      loaded.Jump();
-      true_target.Bind();
-      frame_->Push(Factory::true_value());
-      loaded.Bind();
-    }
+  // If the expression should be a side-effect-free 32-bit int computation,
+  // compile that SafeInt32 path, and a bailout path.
+  if (!in_safe_int32_mode() &&
+      safe_int32_mode_enabled() &&
+      expr->side_effect_free() &&
+      expr->num_bit_ops() > 2) {
+    BreakTarget unsafe_bailout;
+    JumpTarget done;
+    unsafe_bailout.set_expected_height(frame_->height());
+    LoadInSafeInt32Mode(expr, &unsafe_bailout);
+    done.Jump();
 
-  } else if (dest.is_used()) {
-    // There is true, and possibly false, control flow (with true as
-    // the fall through).
-    JumpTarget loaded;
-    frame_->Push(Factory::true_value());
-    if (false_target.is_linked()) {
-      loaded.Jump();
-      false_target.Bind();
-      frame_->Push(Factory::false_value());
-      loaded.Bind();
+    if (unsafe_bailout.is_linked()) {
+      unsafe_bailout.Bind();
+      LoadWithSafeInt32ModeDisabled(expr);
     }
-
+    done.Bind();
   } else {
-    // We have a valid value on top of the frame, but we still may
-    // have dangling jumps to the true and false targets from nested
-    // subexpressions (eg, the left subexpressions of the
-    // short-circuited boolean operators).
-    ASSERT(has_valid_frame());
-    if (true_target.is_linked() || false_target.is_linked()) {
+    JumpTarget true_target;
+    JumpTarget false_target;
+    ControlDestination dest(&true_target, &false_target, true);
+    LoadCondition(expr, &dest, false);
+
+    if (dest.false_was_fall_through()) {
+      // The false target was just bound.
       JumpTarget loaded;
-      loaded.Jump();  // Don't lose the current TOS.
+      frame_->Push(Factory::false_value());
+      // There may be dangling jumps to the true target.
       if (true_target.is_linked()) {
+        loaded.Jump();
         true_target.Bind();
         frame_->Push(Factory::true_value());
-        if (false_target.is_linked()) {
-          loaded.Jump();
-        }
+        loaded.Bind();
       }
+
+    } else if (dest.is_used()) {
+      // There is true, and possibly false, control flow (with true as
+      // the fall through).
+      JumpTarget loaded;
+      frame_->Push(Factory::true_value());
       if (false_target.is_linked()) {
+        loaded.Jump();
         false_target.Bind();
         frame_->Push(Factory::false_value());
+        loaded.Bind();
+      }
+
+    } else {
+      // We have a valid value on top of the frame, but we still may
+      // have dangling jumps to the true and false targets from nested
+      // subexpressions (eg, the left subexpressions of the
+      // short-circuited boolean operators).
+      ASSERT(has_valid_frame());
+      if (true_target.is_linked() || false_target.is_linked()) {
+        JumpTarget loaded;
+        loaded.Jump();  // Don't lose the current TOS.
+        if (true_target.is_linked()) {
+          true_target.Bind();
+          frame_->Push(Factory::true_value());
+          if (false_target.is_linked()) {
+            loaded.Jump();
+          }
+        }
+        if (false_target.is_linked()) {
+          false_target.Bind();
+          frame_->Push(Factory::false_value());
+        }
+        loaded.Bind();
       }
-      loaded.Bind();
     }
   }
 
@@ -952,6 +1009,257 @@ static TypeInfo CalculateTypeInfo(TypeInfo operands_type,
 }
 
 
+// Arithmetic expression trees computed with unboxed doubles keep their
+// leaves in xmm8 to xmm15 and the intermediate values in xmm0 to xmm7.
+static const int kMaxDoubleTreeLeaves = 8;
+static const int kMaxDoubleTreeDepth = 8;
+// Limit on the leaves that are variables, which are checked in general
+// purpose registers.
+static const int kMaxDoubleTreeVariables = 6;
+
+
+static XMMRegister DoubleTreeLeafRegister(int index) {
+  ASSERT(index < kMaxDoubleTreeLeaves);
+  XMMRegister reg = { kMaxDoubleTreeDepth + index };
+  return reg;
+}
+
+
+static XMMRegister DoubleTreeRegister(int depth) {
+  ASSERT(depth < kMaxDoubleTreeDepth);
+  XMMRegister reg = { depth };
+  return reg;
+}
+
+
+static bool IsDoubleTreeOperation(Token::Value op) {
+  return op == Token::ADD ||
+         op == Token::SUB ||
+         op == Token::MUL ||
+         op == Token::DIV;
+}
+
+
+// Returns the index of a leaf of a double tree, or -1 if the expression is
+// not among the leaves. Repeated uses of a variable share a leaf.
+static int DoubleTreeLeafIndex(ZoneList<Expression*>* leaves,
+                               Expression* expr) {
+  Variable* var = expr->AsVariableProxy() != NULL
+      ? expr->AsVariableProxy()->AsVariable()
+      : NULL;
+  for (int i = 0; i < leaves->length(); i++) {
+    Expression* leaf = leaves->at(i);
+    if (leaf == expr) return i;
+    if (var != NULL &&
+        leaf->AsVariableProxy() != NULL &&
+        leaf->AsVariableProxy()->AsVariable() == var) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+
+// Collects the leaves of an arithmetic expression tree into leaves and
+// counts its operations. The leaves must be stack-allocated variables or
+// number literals, whose evaluation has no side effects and can be
+// repeated by the generic code. Returns false if the expression is not
+// such a tree or does not fit the registers.
+static bool CollectDoubleTreeLeaves(Expression* expr,
+                                    ZoneList<Expression*>* leaves,
+                                    int depth,
+                                    int* operations) {
+  BinaryOperation* binary = expr->AsBinaryOperation();
+  if (binary != NULL) {
+    if (!IsDoubleTreeOperation(binary->op())) return false;
+    if (depth >= kMaxDoubleTreeDepth) return false;
+    (*operations)++;
+    return CollectDoubleTreeLeaves(binary->left(), leaves, depth, operations) &&
+        CollectDoubleTreeLeaves(binary->right(), leaves, depth + 1, operations);
+  }
+
+  if (DoubleTreeLeafIndex(leaves, expr) >= 0) return true;
+  Literal* literal = expr->AsLiteral();
+  if (literal != NULL) {
+    if (!literal->handle()->IsNumber()) return false;
+  } else {
+    VariableProxy* proxy = expr->AsVariableProxy();
+    Variable* var = proxy != NULL ? proxy->AsVariable() : NULL;
+    Slot* slot = var != NULL ? var->slot() : NULL;
+    if (slot == NULL) return false;
+    if (slot->type() != Slot::LOCAL && slot->type() != Slot::PARAMETER) {
+      return false;
+    }
+    // Loading the arguments object may allocate it.
+    if (slot->is_arguments()) return false;
+  }
+  if (leaves->length() == kMaxDoubleTreeLeaves) return false;
+  leaves->Add(expr);
+  return true;
+}
+
+
+bool CodeGenerator::GenerateDoubleBinaryOperation(BinaryOperation* expr,
+                                                  JumpTarget* done) {
+  if (!FLAG_unbox_doubles || loop_nesting() == 0) return false;
+  // Likely smi operations are done inline on the generic code.
+  if (expr->type()->IsLikelySmi()) return false;
+
+  // Only trees with intermediate values gain from unboxing; a single
+  // operation boxes its result anyway.
+  ZoneList<Expression*> leaves(kMaxDoubleTreeLeaves);
+  int operations = 0;
+  if (!CollectDoubleTreeLeaves(expr, &leaves, 0, &operations) ||
+      operations < 2) {
+    return false;
+  }
+  int variables = 0;
+  for (int i = 0; i < leaves.length(); i++) {
+    if (leaves[i]->AsLiteral() == NULL) variables++;
+  }
+  if (variables == 0 || variables > kMaxDoubleTreeVariables) return false;
+
+  Comment cmnt(masm_, "[ DoubleBinaryOperation");
+
+  // Load the variables and use their type information to decide whether
+  // the tree is worth computing in doubles. A heap number literal or
+  // variable makes the result a heap number anyway.
+  for (int i = 0; i < leaves.length(); i++) {
+    if (leaves[i]->AsLiteral() == NULL) Load(leaves[i]);
+  }
+  Result values[kMaxDoubleTreeLeaves];
+  bool has_double = false;
+  bool all_smis = true;
+  for (int i = leaves.length() - 1; i >= 0; i--) {
+    Literal* literal = leaves[i]->AsLiteral();
+    if (literal != NULL) {
+      if (!literal->handle()->IsSmi()) has_double = true;
+    } else {
+      values[i] = frame_->Pop();
+      if (values[i].type_info().IsDouble()) has_double = true;
+      if (!values[i].type_info().IsSmi()) all_smis = false;
+    }
+  }
+  if (all_smis && !has_double) {
+    for (int i = 0; i < leaves.length(); i++) values[i].Unuse();
+    return false;
+  }
+  for (int i = 0; i < leaves.length(); i++) {
+    if (values[i].is_valid()) values[i].ToRegister();
+  }
+
+  JumpTarget generic;
+  if (!has_double) {
+    // If all the leaves are smis the generic code does smi arithmetic
+    // without allocating.
+    Result bits = allocator()->Allocate();
+    ASSERT(bits.is_valid());
+    bool first = true;
+    for (int i = 0; i < leaves.length(); i++) {
+      if (!values[i].is_valid()) continue;
+      if (first) {
+        __ movq(bits.reg(), values[i].reg());
+        first = false;
+      } else {
+        __ or_(bits.reg(), values[i].reg());
+      }
+    }
+    Condition is_smi = masm_->CheckSmi(bits.reg());
+    bits.Unuse();
+    generic.Branch(is_smi);
+  }
+
+  // Load the leaves into their registers, bailing out to the generic code
+  // if a variable is not a number.
+  for (int i = 0; i < leaves.length(); i++) {
+    XMMRegister reg = DoubleTreeLeafRegister(i);
+    Literal* literal = leaves[i]->AsLiteral();
+    if (literal != NULL) {
+      double value = literal->handle()->Number();
+      __ movq(kScratchRegister, BitCast<int64_t>(value), RelocInfo::NONE);
+      __ movq(reg, kScratchRegister);
+      continue;
+    }
+    Register value = values[i].reg();
+    TypeInfo type_info = values[i].type_info();
+    if (type_info.IsSmi()) {
+      __ SmiToInteger32(kScratchRegister, value);
+      __ cvtlsi2sd(reg, kScratchRegister);
+    } else if (type_info.IsDouble()) {
+      __ movsd(reg, FieldOperand(value, HeapNumber::kValueOffset));
+    } else {
+      Label smi, loaded;
+      __ JumpIfSmi(value, &smi);
+      if (!type_info.IsNumber()) {
+        __ CompareRoot(FieldOperand(value, HeapObject::kMapOffset),
+                       Heap::kHeapNumberMapRootIndex);
+        generic.Branch(not_equal);
+      }
+      __ movsd(reg, FieldOperand(value, HeapNumber::kValueOffset));
+      __ jmp(&loaded);
+      __ bind(&smi);
+      __ SmiToInteger32(kScratchRegister, value);
+      __ cvtlsi2sd(reg, kScratchRegister);
+      __ bind(&loaded);
+    }
+  }
+  for (int i = 0; i < leaves.length(); i++) values[i].Unuse();
+
+  EmitDoubleTree(expr, &leaves, 0);
+
+  // Box the value of the tree. On allocation failure the generic code
+  // computes it again.
+  Result answer = allocator()->Allocate();
+  ASSERT(answer.is_valid());
+  Result scratch = allocator()->Allocate();
+  ASSERT(scratch.is_valid());
+  VirtualFrame* clone = new VirtualFrame(frame_);
+  Label allocation_failed;
+  __ AllocateHeapNumber(answer.reg(), scratch.reg(), &allocation_failed);
+  __ movsd(FieldOperand(answer.reg(), HeapNumber::kValueOffset),
+           DoubleTreeRegister(0));
+  scratch.Unuse();
+  answer.set_type_info(TypeInfo::Double());
+  frame_->Push(&answer);
+  done->Jump();
+
+  RegisterFile empty_regs;
+  SetFrame(clone, &empty_regs);
+  __ bind(&allocation_failed);
+  generic.Bind();
+  return true;
+}
+
+
+void CodeGenerator::EmitDoubleTree(Expression* expr,
+                                   ZoneList<Expression*>* leaves,
+                                   int depth) {
+  XMMRegister dst = DoubleTreeRegister(depth);
+  BinaryOperation* binary = expr->AsBinaryOperation();
+  if (binary == NULL) {
+    __ movsd(dst, DoubleTreeLeafRegister(DoubleTreeLeafIndex(leaves, expr)));
+    return;
+  }
+
+  EmitDoubleTree(binary->left(), leaves, depth);
+  XMMRegister src;
+  int index = DoubleTreeLeafIndex(leaves, binary->right());
+  if (index >= 0) {
+    src = DoubleTreeLeafRegister(index);
+  } else {
+    EmitDoubleTree(binary->right(), leaves, depth + 1);
+    src = DoubleTreeRegister(depth + 1);
+  }
+  switch (binary->op()) {
+    case Token::ADD: __ addsd(dst, src); break;
+    case Token::SUB: __ subsd(dst, src); break;
+    case Token::MUL: __ mulsd(dst, src); break;
+    case Token::DIV: __ divsd(dst, src); break;
+    default: UNREACHABLE();
+  }
+}
+
+
 void CodeGenerator::GenericBinaryOperation(BinaryOperation* expr,
                                            OverwriteMode overwrite_mode) {
   Comment cmnt(masm_, "[ BinaryOperation");
@@ -2172,9 +2480,9 @@ void CodeGenerator::Comparison(AstNode* node,
         GenerateInlineNumberComparison(&left_side, &right_side, cc, dest);
       }
 
-      // End of in-line compare, call out to the compare stub. Don't include
-      // number comparison in the stub if it was inlined.
-      CompareStub stub(cc, strict, nan_info, !inline_number_compare);
+      // End of in-line compare, call out to the compare IC.
+      ICCompareStub stub(ICCompareStub::ComputeOperation(cc, strict),
+                         CompareIC::DEFAULT);
       Result answer = frame_->CallStub(&stub, &left_side, &right_side);
       __ testq(answer.reg(), answer.reg());  // Sets both zero and sign flag.
       answer.Unuse();
@@ -2205,9 +2513,9 @@ void CodeGenerator::Comparison(AstNode* node,
           GenerateInlineNumberComparison(&left_side, &right_side, cc, dest);
         }
 
-        // End of in-line compare, call out to the compare stub. Don't include
-        // number comparison in the stub if it was inlined.
-        CompareStub stub(cc, strict, nan_info, !inline_number_compare);
+        // End of in-line compare, call out to the compare IC.
+        ICCompareStub stub(ICCompareStub::ComputeOperation(cc, strict),
+                           CompareIC::DEFAULT);
         Result answer = frame_->CallStub(&stub, &left_side, &right_side);
         __ testq(answer.reg(), answer.reg());  // Sets both zero and sign flags.
         answer.Unuse();
@@ -3165,15 +3473,18 @@ void CodeGenerator::VisitDoWhileStatement(DoWhileStatement* node) {
     case ALWAYS_TRUE:
       // Use the continue target.
       node->continue_target()->set_direction(JumpTarget::BIDIRECTIONAL);
+      GenerateOsrEntry(node);
       node->continue_target()->Bind();
       break;
     case ALWAYS_FALSE:
       // No need to label it.
       node->continue_target()->set_direction(JumpTarget::FORWARD_ONLY);
+      GenerateOsrEntry(node, node->continue_target());
       break;
     case DONT_KNOW:
       // Continue is the test, so use the backward body target.
       node->continue_target()->set_direction(JumpTarget::FORWARD_ONLY);
+      GenerateOsrEntry(node, node->continue_target());
       body.Bind();
       break;
   }
@@ -3236,6 +3547,9 @@ void CodeGenerator::VisitWhileStatement(WhileStatement* node) {
   ConditionAnalysis info = AnalyzeCondition(node->cond());
   if (info == ALWAYS_FALSE) return;
 
+  // Full code running the loop continues with the test.
+  GenerateOsrEntry(node);
+
   // Do not duplicate conditions that may have function literal
   // subexpressions.  This can cause us to compile the function literal
   // twice.
@@ -3360,6 +3674,42 @@ void CodeGenerator::SetTypeForStackSlot(Slot* slot, TypeInfo info) {
 }
 
 
+bool CodeGenerator::IsOsrLoop(IterationStatement* node) {
+  return info_->osr_loop_position() != RelocInfo::kNoPosition &&
+      info_->osr_loop_position() == node->statement_pos();
+}
+
+
+void CodeGenerator::GenerateOsrEntry(IterationStatement* node,
+                                     JumpTarget* target) {
+  // Full code only replaces frames holding nothing but the locals.
+  if (!IsOsrLoop(node) || !has_valid_frame() || frame_->height() != 0) {
+    return;
+  }
+  Comment cmnt(masm_, "[ OSR entry");
+  // The full code keeps all values in memory, and they can be of any type.
+  frame_->SpillAll();
+  frame_->ForgetTypeInfo();
+  if (target == NULL) {
+    info_->set_osr_entry_offset(masm_->pc_offset());
+    frame_->RestoreContextRegister();
+    return;
+  }
+
+  // Emit the entry out of line.
+  VirtualFrame* fall_through_frame = frame_;
+  RegisterFile non_frame_registers;
+  SetFrame(new VirtualFrame(fall_through_frame), &non_frame_registers);
+  Label fall_through;
+  __ jmp(&fall_through);
+  info_->set_osr_entry_offset(masm_->pc_offset());
+  frame_->RestoreContextRegister();
+  target->Jump();
+  SetFrame(fall_through_frame, &non_frame_registers);
+  __ bind(&fall_through);
+}
+
+
 void CodeGenerator::GenerateFastSmiLoop(ForStatement* node) {
   // A fast smi loop is a for loop with an initializer
   // that is a simple assignment of a smi to a stack variable,
@@ -3489,7 +3839,8 @@ void CodeGenerator::VisitForStatement(ForStatement* node) {
   Comment cmnt(masm_, "[ ForStatement");
   CodeForStatementPosition(node);
 
-  if (node->is_fast_smi_loop()) {
+  // The loop variable of full code running the loop might not be a smi.
+  if (node->is_fast_smi_loop() && !IsOsrLoop(node)) {
     GenerateFastSmiLoop(node);
     return;
   }
@@ -3504,6 +3855,9 @@ void CodeGenerator::VisitForStatement(ForStatement* node) {
   ConditionAnalysis info = AnalyzeCondition(node->cond());
   if (info == ALWAYS_FALSE) return;
 
+  // Full code running the loop continues with the test.
+  GenerateOsrEntry(node);
+
   // Do not duplicate conditions that may have function literal
   // subexpressions.  This can cause us to compile the function literal
   // twice.
@@ -4251,6 +4605,7 @@ void CodeGenerator::InstantiateFunction(
 
 void CodeGenerator::VisitFunctionLiteral(FunctionLiteral* node) {
   Comment cmnt(masm_, "[ FunctionLiteral");
+  ASSERT(!in_safe_int32_mode());
 
   // Build the function info and instantiate it.
   Handle<SharedFunctionInfo> function_info =
@@ -4264,12 +4619,14 @@ void CodeGenerator::VisitFunctionLiteral(FunctionLiteral* node) {
 void CodeGenerator::VisitSharedFunctionInfoLiteral(
     SharedFunctionInfoLiteral* node) {
   Comment cmnt(masm_, "[ SharedFunctionInfoLiteral");
+  ASSERT(!in_safe_int32_mode());
   InstantiateFunction(node->shared_function_info());
 }
 
 
 void CodeGenerator::VisitConditional(Conditional* node) {
   Comment cmnt(masm_, "[ Conditional");
+  ASSERT(!in_safe_int32_mode());
   JumpTarget then;
   JumpTarget else_;
   JumpTarget exit;
@@ -4415,6 +4772,7 @@ Result CodeGenerator::LoadFromGlobalSlotCheckExtensions(
     Slot* slot,
     TypeofState typeof_state,
     JumpTarget* slow) {
+  ASSERT(!in_safe_int32_mode());
   // Check that no extension objects have been created by calls to
   // eval from the current scope to the global scope.
   Register context = rsi;
@@ -4645,7 +5003,17 @@ void CodeGenerator::StoreToSlot(Slot* slot, InitState init_state) {
 
 void CodeGenerator::VisitSlot(Slot* node) {
   Comment cmnt(masm_, "[ Slot");
-  LoadFromSlotCheckForArguments(node, NOT_INSIDE_TYPEOF);
+  if (in_safe_int32_mode()) {
+    if ((node->type() == Slot::LOCAL && !node->is_arguments())) {
+      frame()->UntaggedPushLocalAt(node->index());
+    } else if (node->type() == Slot::PARAMETER) {
+      frame()->UntaggedPushParameterAt(node->index());
+    } else {
+      UNREACHABLE();
+    }
+  } else {
+    LoadFromSlotCheckForArguments(node, NOT_INSIDE_TYPEOF);
+  }
 }
 
 
@@ -4657,6 +5025,7 @@ void CodeGenerator::VisitVariableProxy(VariableProxy* node) {
     Visit(expr);
   } else {
     ASSERT(var->is_global());
+    ASSERT(!in_safe_int32_mode());
     Reference ref(this, node);
     ref.GetValue();
   }
@@ -4665,7 +5034,23 @@ void CodeGenerator::VisitVariableProxy(VariableProxy* node) {
 
 void CodeGenerator::VisitLiteral(Literal* node) {
   Comment cmnt(masm_, "[ Literal");
-  frame_->Push(node->handle());
+  if (in_safe_int32_mode()) {
+    // Every int32 value is a smi, so an untagged constant is kept as the
+    // smi of its int32 value.
+    ASSERT(node->handle()->IsNumber());
+    double double_value = node->handle()->Number();
+    int32_t value = DoubleToInt32(double_value);
+    if (!node->to_int32() &&
+        (double_value != value || (value == 0 && signbit(double_value)))) {
+      // The literal is not an int32 value and is not converted to one by
+      // the operation using it.
+      unsafe_bailout_->Branch(equal);
+      unsafe_bailout_->Branch(not_equal);
+    }
+    frame_->PushUntaggedElement(Handle<Object>(Smi::FromInt(value)));
+  } else {
+    frame_->Push(node->handle());
+  }
 }
 
 
@@ -4758,6 +5143,7 @@ void DeferredAllocateInNewSpace::Generate() {
 
 void CodeGenerator::VisitRegExpLiteral(RegExpLiteral* node) {
   Comment cmnt(masm_, "[ RegExp Literal");
+  ASSERT(!in_safe_int32_mode());
 
   // Retrieve the literals array and check the allocated entry.  Begin
   // with a writable copy of the function of this activation in a
@@ -4817,6 +5203,7 @@ void CodeGenerator::VisitRegExpLiteral(RegExpLiteral* node) {
 
 void CodeGenerator::VisitObjectLiteral(ObjectLiteral* node) {
   Comment cmnt(masm_, "[ ObjectLiteral");
+  ASSERT(!in_safe_int32_mode());
 
   // Load a writable copy of the function of this activation in a
   // register.
@@ -4906,6 +5293,7 @@ void CodeGenerator::VisitObjectLiteral(ObjectLiteral* node) {
 
 void CodeGenerator::VisitArrayLiteral(ArrayLiteral* node) {
   Comment cmnt(masm_, "[ ArrayLiteral");
+  ASSERT(!in_safe_int32_mode());
 
   // Load a writable copy of the function of this activation in a
   // register.
@@ -4979,6 +5367,7 @@ void CodeGenerator::VisitArrayLiteral(ArrayLiteral* node) {
 
 
 void CodeGenerator::VisitCatchExtensionObject(CatchExtensionObject* node) {
+  ASSERT(!in_safe_int32_mode());
   ASSERT(!in_spilled_code());
   // Call runtime routine to allocate the catch extension object and
   // assign the exception value to the catch variable.
@@ -5005,6 +5394,11 @@ void CodeGenerator::EmitSlotAssignment(Assignment* node) {
   if (node->is_compound()) {
     // For a compound assignment the right-hand side is a binary operation
     // between the current property value and the actual right-hand side.
+    // Construct the implicit binary operation.
+    BinaryOperation expr(node);
+    JumpTarget done;
+    bool unboxed = GenerateDoubleBinaryOperation(&expr, &done);
+
     LoadFromSlotCheckForArguments(slot, NOT_INSIDE_TYPEOF);
     Load(node->value());
 
@@ -5012,10 +5406,10 @@ void CodeGenerator::EmitSlotAssignment(Assignment* node) {
     bool overwrite_value =
         (node->value()->AsBinaryOperation() != NULL &&
          node->value()->AsBinaryOperation()->ResultOverwriteAllowed());
-    // Construct the implicit binary operation.
-    BinaryOperation expr(node);
     GenericBinaryOperation(&expr,
                            overwrite_value ? OVERWRITE_RIGHT : NO_OVERWRITE);
+
+    if (unboxed) done.Bind();
   } else {
     // For non-compound assignment just load the right-hand side.
     Load(node->value());
@@ -5249,6 +5643,7 @@ void CodeGenerator::EmitKeyedPropertyAssignment(Assignment* node) {
 
 
 void CodeGenerator::VisitAssignment(Assignment* node) {
+  ASSERT(!in_safe_int32_mode());
 #ifdef DEBUG
   int original_height = frame()->height();
 #endif
@@ -5285,6 +5680,7 @@ void CodeGenerator::VisitAssignment(Assignment* node) {
 
 void CodeGenerator::VisitThrow(Throw* node) {
   Comment cmnt(masm_, "[ Throw");
+  ASSERT(!in_safe_int32_mode());
   Load(node->exception());
   Result result = frame_->CallRuntime(Runtime::kThrow, 1);
   frame_->Push(&result);
@@ -5293,6 +5689,7 @@ void CodeGenerator::VisitThrow(Throw* node) {
 
 void CodeGenerator::VisitProperty(Property* node) {
   Comment cmnt(masm_, "[ Property");
+  ASSERT(!in_safe_int32_mode());
   Reference property(this, node);
   property.GetValue();
 }
@@ -5300,6 +5697,7 @@ void CodeGenerator::VisitProperty(Property* node) {
 
 void CodeGenerator::VisitCall(Call* node) {
   Comment cmnt(masm_, "[ Call");
+  ASSERT(!in_safe_int32_mode());
 
   ZoneList<Expression*>* args = node->arguments();
 
@@ -5601,6 +5999,7 @@ void CodeGenerator::VisitCall(Call* node) {
 
 void CodeGenerator::VisitCallNew(CallNew* node) {
   Comment cmnt(masm_, "[ CallNew");
+  ASSERT(!in_safe_int32_mode());
 
   // According to ECMA-262, section 11.2.2, page 44, the function
   // expression in new calls must be evaluated before the
@@ -7230,6 +7629,7 @@ void CodeGenerator::GenerateIsRegExpEquivalent(ZoneList<Expression*>* args) {
 
 
 void CodeGenerator::VisitCallRuntime(CallRuntime* node) {
+  ASSERT(!in_safe_int32_mode());
   if (CheckForInlineRuntimeCall(node)) {
     return;
   }
@@ -7356,6 +7756,43 @@ void CodeGenerator::VisitUnaryOperation(UnaryOperation* node) {
       frame_->SetElementAt(0, Factory::undefined_value());
     }
 
+  } else if (in_safe_int32_mode()) {
+    Visit(node->expression());
+    Result value = frame_->Pop();
+    ASSERT(value.is_untagged_int32());
+    // Registers containing an int32 value are not multiply used.
+    ASSERT(!value.is_register() || !frame_->is_used(value.reg()));
+    value.ToRegister();
+    // The value is pushed before the operation because BreakTarget::Branch
+    // cannot handle live results.
+    Register value_reg = value.reg();
+    frame_->Push(&value);
+    switch (op) {
+      case Token::SUB: {
+        __ negl(value_reg);
+        if (node->no_negative_zero()) {
+          // -MIN_INT is MIN_INT with the overflow flag set.
+          unsafe_bailout_->Branch(overflow);
+        } else {
+          // MIN_INT and 0 both have bad negations.  They both have 31 zeros.
+          __ testl(value_reg, Immediate(0x7FFFFFFF));
+          unsafe_bailout_->Branch(zero);
+        }
+        break;
+      }
+      case Token::BIT_NOT: {
+        __ notl(value_reg);
+        break;
+      }
+      case Token::ADD: {
+        // Unary plus has no effect on int32 values.
+        break;
+      }
+      default:
+        UNREACHABLE();
+        break;
+    }
+
   } else {
     bool can_overwrite =
       (node->expression()->AsBinaryOperation() != NULL &&
@@ -7532,6 +7969,7 @@ void DeferredPostfixCountOperation::Generate() {
 
 void CodeGenerator::VisitCountOperation(CountOperation* node) {
   Comment cmnt(masm_, "[ CountOperation");
+  ASSERT(!in_safe_int32_mode());
 
   bool is_postfix = node->is_postfix();
   bool is_increment = node->op() == Token::INC;
@@ -7630,6 +8068,219 @@ void CodeGenerator::VisitCountOperation(CountOperation* node) {
 }
 
 
+void CodeGenerator::Int32BinaryOperation(BinaryOperation* node) {
+  Token::Value op = node->op();
+  Comment cmnt(masm_, "[ Int32BinaryOperation");
+  ASSERT(in_safe_int32_mode());
+  ASSERT(safe_int32_mode_enabled());
+  ASSERT(FLAG_safe_int32_compiler);
+
+  if (op == Token::COMMA) {
+    // Discard left value.
+    frame_->Nip(1);
+    return;
+  }
+
+  Result right = frame_->Pop();
+  Result left = frame_->Pop();
+
+  ASSERT(right.is_untagged_int32());
+  ASSERT(left.is_untagged_int32());
+  // Registers containing an int32 value are not multiply used.
+  ASSERT(!left.is_register() || !frame_->is_used(left.reg()));
+  ASSERT(!right.is_register() || !frame_->is_used(right.reg()));
+
+  switch (op) {
+    case Token::COMMA:
+    case Token::OR:
+    case Token::AND:
+      UNREACHABLE();
+      break;
+    case Token::BIT_OR:
+    case Token::BIT_XOR:
+    case Token::BIT_AND:
+      if (left.is_constant() || right.is_constant()) {
+        int32_t value;  // Put constant in value, non-constant in left.
+        // Untagged constants are smis holding their int32 value.
+        if (left.is_constant()) {
+          value = Smi::cast(*left.handle())->value();
+          left = right;
+        } else {
+          value = Smi::cast(*right.handle())->value();
+        }
+
+        left.ToRegister();
+        if (op == Token::BIT_OR) {
+          if (value != 0) __ orl(left.reg(), Immediate(value));
+        } else if (op == Token::BIT_XOR) {
+          if (value != 0) __ xorl(left.reg(), Immediate(value));
+        } else {
+          ASSERT(op == Token::BIT_AND);
+          if (value != -1) __ andl(left.reg(), Immediate(value));
+        }
+      } else {
+        ASSERT(left.is_register());
+        ASSERT(right.is_register());
+        if (op == Token::BIT_OR) {
+          __ orl(left.reg(), right.reg());
+        } else if (op == Token::BIT_XOR) {
+          __ xorl(left.reg(), right.reg());
+        } else {
+          ASSERT(op == Token::BIT_AND);
+          __ andl(left.reg(), right.reg());
+        }
+      }
+      frame_->Push(&left);
+      right.Unuse();
+      break;
+    case Token::SAR:
+    case Token::SHL:
+    case Token::SHR: {
+      bool test_shr_overflow = false;
+      left.ToRegister();
+      if (right.is_constant()) {
+        int shift_amount = Smi::cast(*right.handle())->value() & 0x1F;
+        if (op == Token::SAR) {
+          __ sarl(left.reg(), Immediate(shift_amount));
+        } else if (op == Token::SHL) {
+          __ shll(left.reg(), Immediate(shift_amount));
+        } else {
+          ASSERT(op == Token::SHR);
+          __ shrl(left.reg(), Immediate(shift_amount));
+          if (shift_amount == 0) test_shr_overflow = true;
+        }
+      } else {
+        // Move right to rcx.
+        if (left.is_register() && left.reg().is(rcx)) {
+          right.ToRegister();
+          __ xchg(left.reg(), right.reg());
+          left = right;  // Left is unused here, copy of right unused by Push.
+        } else {
+          right.ToRegister(rcx);
+          left.ToRegister();
+        }
+        if (op == Token::SAR) {
+          __ sarl_cl(left.reg());
+        } else if (op == Token::SHL) {
+          __ shll_cl(left.reg());
+        } else {
+          ASSERT(op == Token::SHR);
+          __ shrl_cl(left.reg());
+          test_shr_overflow = true;
+        }
+      }
+      {
+        Register left_reg = left.reg();
+        frame_->Push(&left);
+        right.Unuse();
+        if (test_shr_overflow && !node->to_int32()) {
+          // Uint32 results with top bit set are not Int32 values.
+          // If they will be forced to Int32, skip the test.
+          // Test is needed because shr with shift amount 0 does not set flags.
+          __ testl(left_reg, left_reg);
+          unsafe_bailout_->Branch(sign);
+        }
+      }
+      break;
+    }
+    case Token::ADD:
+    case Token::SUB:
+    case Token::MUL:
+      if ((left.is_constant() && op != Token::SUB) || right.is_constant()) {
+        int32_t value;  // Put constant in value, non-constant in left.
+        if (right.is_constant()) {
+          value = Smi::cast(*right.handle())->value();
+        } else {
+          value = Smi::cast(*left.handle())->value();
+          left = right;
+        }
+
+        left.ToRegister();
+        if (op == Token::ADD) {
+          __ addl(left.reg(), Immediate(value));
+        } else if (op == Token::SUB) {
+          __ subl(left.reg(), Immediate(value));
+        } else {
+          ASSERT(op == Token::MUL);
+          __ imull(left.reg(), left.reg(), Immediate(value));
+        }
+      } else {
+        left.ToRegister();
+        ASSERT(left.is_register());
+        ASSERT(right.is_register());
+        if (op == Token::ADD) {
+          __ addl(left.reg(), right.reg());
+        } else if (op == Token::SUB) {
+          __ subl(left.reg(), right.reg());
+        } else {
+          ASSERT(op == Token::MUL);
+          // We have statically verified that a negative zero can be ignored.
+          __ imull(left.reg(), right.reg());
+        }
+      }
+      right.Unuse();
+      frame_->Push(&left);
+      if (!node->to_int32() || op == Token::MUL) {
+        // If ToInt32 is called on the result of ADD or SUB, we don't care
+        // about overflows.  An overflowing product may not be exactly
+        // representable as a double, so its low 32 bits can differ from
+        // those of the double product.
+        unsafe_bailout_->Branch(overflow);
+      }
+      break;
+    case Token::DIV:
+    case Token::MOD: {
+      if (right.is_register() && (right.reg().is(rax) || right.reg().is(rdx))) {
+        if (left.is_register() && left.reg().is(rdi)) {
+          right.ToRegister(rbx);
+        } else {
+          right.ToRegister(rdi);
+        }
+      }
+      left.ToRegister(rax);
+      Result rdx_reg = allocator_->Allocate(rdx);
+      right.ToRegister();
+      // The results are unused here because BreakTarget::Branch cannot handle
+      // live results.
+      Register right_reg = right.reg();
+      left.Unuse();
+      right.Unuse();
+      rdx_reg.Unuse();
+      __ cmpl(right_reg, Immediate(0));
+      // Ensure divisor is positive: no chance of non-int32 or -0 result.
+      unsafe_bailout_->Branch(less_equal);
+      __ cdq();  // Sign-extend eax into edx:eax.
+      __ idivl(right_reg);
+      if (op == Token::MOD) {
+        // Negative zero can arise as a negative dividend with a zero result.
+        if (!node->no_negative_zero()) {
+          Label not_negative_zero;
+          __ testl(rdx, rdx);
+          __ j(not_zero, &not_negative_zero);
+          __ testl(rax, rax);
+          unsafe_bailout_->Branch(negative);
+          __ bind(&not_negative_zero);
+        }
+        Result rdx_result(rdx, TypeInfo::Integer32());
+        rdx_result.set_untagged_int32(true);
+        frame_->Push(&rdx_result);
+      } else {
+        ASSERT(op == Token::DIV);
+        __ testl(rdx, rdx);
+        unsafe_bailout_->Branch(not_equal);
+        Result rax_result(rax, TypeInfo::Integer32());
+        rax_result.set_untagged_int32(true);
+        frame_->Push(&rax_result);
+      }
+      break;
+    }
+    default:
+      UNREACHABLE();
+      break;
+  }
+}
+
+
 void CodeGenerator::GenerateLogicalBooleanOperation(BinaryOperation* node) {
   // According to ECMA-262 section 11.11, page 58, the binary logical
   // operators must yield the result of one of the two expressions
@@ -7641,6 +8292,7 @@ void CodeGenerator::GenerateLogicalBooleanOperation(BinaryOperation* node) {
   // is necessary because we assume that if we get control flow on the
   // last path out of an expression we got it on all paths.
   if (node->op() == Token::AND) {
+    ASSERT(!in_safe_int32_mode());
     JumpTarget is_true;
     ControlDestination dest(&is_true, destination()->false_target(), true);
     LoadCondition(node->left(), &dest, false);
@@ -7705,6 +8357,7 @@ void CodeGenerator::GenerateLogicalBooleanOperation(BinaryOperation* node) {
 
   } else {
     ASSERT(node->op() == Token::OR);
+    ASSERT(!in_safe_int32_mode());
     JumpTarget is_false;
     ControlDestination dest(destination()->true_target(), &is_false, false);
     LoadCondition(node->left(), &dest, false);
@@ -7773,6 +8426,10 @@ void CodeGenerator::VisitBinaryOperation(BinaryOperation* node) {
 
   if (node->op() == Token::AND || node->op() == Token::OR) {
     GenerateLogicalBooleanOperation(node);
+  } else if (in_safe_int32_mode()) {
+    Visit(node->left());
+    Visit(node->right());
+    Int32BinaryOperation(node);
   } else {
     // NOTE: The code below assumes that the slow cases (calls to runtime)
     // never return a constant/immutable object.
@@ -7785,6 +8442,9 @@ void CodeGenerator::VisitBinaryOperation(BinaryOperation* node) {
       overwrite_mode = OVERWRITE_RIGHT;
     }
 
+    JumpTarget done;
+    bool unboxed = GenerateDoubleBinaryOperation(node, &done);
+
     if (node->left()->IsTrivial()) {
       Load(node->right());
       Result right = frame_->Pop();
@@ -7795,17 +8455,21 @@ void CodeGenerator::VisitBinaryOperation(BinaryOperation* node) {
       Load(node->right());
     }
     GenericBinaryOperation(node, overwrite_mode);
+
+    if (unboxed) done.Bind();
   }
 }
 
 
 void CodeGenerator::VisitThisFunction(ThisFunction* node) {
+  ASSERT(!in_safe_int32_mode());
   frame_->PushFunction();
 }
 
 
 void CodeGenerator::VisitCompareOperation(CompareOperation* node) {
   Comment cmnt(masm_, "[ CompareOperation");
+  ASSERT(!in_safe_int32_mode());
 
   // Get the expressions from the node.
   Expression* left = node->left();
@@ -7969,6 +8633,7 @@ void CodeGenerator::VisitCompareOperation(CompareOperation* node) {
 
 void CodeGenerator::VisitCompareToNull(CompareToNull* node) {
   Comment cmnt(masm_, "[ CompareToNull");
+  ASSERT(!in_safe_int32_mode());
 
   Load(node->expression());
   Result operand = frame_->Pop();
@@ -365,6 +365,24 @@ class CodeGenerator: public AstVisitor {
   // State
   ControlDestination* destination() const { return state_->destination(); }
 
+  // Control of side-effect-free int32 expression compilation.
+  bool in_safe_int32_mode() { return in_safe_int32_mode_; }
+  void set_in_safe_int32_mode(bool value) { in_safe_int32_mode_ = value; }
+  bool safe_int32_mode_enabled() {
+    return FLAG_safe_int32_compiler && safe_int32_mode_enabled_;
+  }
+  void set_safe_int32_mode_enabled(bool value) {
+    safe_int32_mode_enabled_ = value;
+  }
+  void set_unsafe_bailout(BreakTarget* unsafe_bailout) {
+    unsafe_bailout_ = unsafe_bailout;
+  }
+
+  // Take the Result that is an untagged int32, and convert it to a tagged
+  // Smi.  Every int32 value is a smi on x64.  Remove the untagged_int32 flag
+  // from the result.
+  void ConvertInt32ResultToSmi(Result* value);
+
   // Track loop nesting level.
   int loop_nesting() const { return loop_nesting_; }
   void IncrementLoopNesting() { loop_nesting_++; }
@@ -433,6 +451,11 @@ class CodeGenerator: public AstVisitor {
   // temporarily while the code generator is being transformed.
   void LoadAndSpill(Expression* expression);
 
+  // Evaluate an expression and place its value on top of the frame,
+  // using, or not using, the side-effect-free expression compiler.
+  void LoadInSafeInt32Mode(Expression* expr, BreakTarget* unsafe_bailout);
+  void LoadWithSafeInt32ModeDisabled(Expression* expr);
+
   // Read a value from a slot and leave it on top of the expression stack.
   void LoadFromSlot(Slot* slot, TypeofState typeof_state);
   void LoadFromSlotCheckForArguments(Slot* slot, TypeofState state);
@@ -492,6 +515,22 @@ class CodeGenerator: public AstVisitor {
   void GenericBinaryOperation(BinaryOperation* expr,
                               OverwriteMode overwrite_mode);
 
+  // Emits code for a binary operation on untagged int32 operands in the
+  // side-effect-free int32 mode.
+  void Int32BinaryOperation(BinaryOperation* node);
+
+  // Emits code computing an arithmetic expression tree in a loop with
+  // unboxed doubles, if the leaves of the tree are stack-allocated variables
+  // or number literals. Only the value of the whole tree is boxed. The code
+  // jumps to done with the boxed value on the frame. If the leaves are not
+  // numbers the current frame is left at the start of the generic code,
+  // which must follow and fall through to done. Returns false without
+  // emitting code if the expression is not such a tree.
+  bool GenerateDoubleBinaryOperation(BinaryOperation* expr, JumpTarget* done);
+  void EmitDoubleTree(Expression* expr,
+                      ZoneList<Expression*>* leaves,
+                      int depth);
+
   // Emits code sequence that jumps to a JumpTarget if the inputs
   // are both smis.  Cannot be in MacroAssembler because it takes
   // advantage of TypeInfo to skip unneeded checks.
@@ -702,6 +741,12 @@ class CodeGenerator: public AstVisitor {
 
   void SetTypeForStackSlot(Slot* slot, TypeInfo info);
 
+  // On-stack replacement of full code running a loop (see
+  // --tiered-compilation).  The entry is emitted at the current position,
+  // or jumps to the given target of the loop.
+  bool IsOsrLoop(IterationStatement* node);
+  void GenerateOsrEntry(IterationStatement* node, JumpTarget* target = NULL);
+
 #ifdef DEBUG
   // True if the registers are valid for entry to a block.  There should
   // be no frame-external references to (non-reserved) registers.
@@ -720,10 +765,14 @@ class CodeGenerator: public AstVisitor {
   RegisterAllocator* allocator_;
   CodeGenState* state_;
   int loop_nesting_;
+  bool in_safe_int32_mode_;
+  bool safe_int32_mode_enabled_;
 
   // Jump targets.
   // The target of the return from the function.
   BreakTarget function_return_;
+  // The target of the bailout from a side-effect-free int32 subexpression.
+  BreakTarget* unsafe_bailout_;
 
   // True if the function return is shadowed (ie, jumping to the target
   // function_return_ does not jump to the true function return, but rather
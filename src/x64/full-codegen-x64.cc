@@ -61,6 +61,8 @@ void FullCodeGenerator::Generate(CompilationInfo* info) {
   SetFunctionPosition(function());
   Comment cmnt(masm_, "[ function compiled by full code generator");
 
+  EmitTierUpCheck();
+
   __ push(rbp);  // Caller's frame pointer.
   __ movq(rbp, rsp);
   __ push(rsi);  // Callee's context.
@@ -191,6 +193,60 @@ void FullCodeGenerator::Generate(CompilationInfo* info) {
 }
 
 
+void FullCodeGenerator::EmitTierUpCheck() {
+  if (!info_->has_tier_up_check()) return;
+  Comment cmnt(masm_, "[ Tier-up check");
+  // Call stubs embedding this code can still reach it after the function
+  // has been recompiled.  Continue in the current code of the function
+  // then, as frames find their code through the function.
+  Label current, ok;
+  __ movq(rcx, masm_->CodeObject(), RelocInfo::EMBEDDED_OBJECT);
+  __ lea(rcx, FieldOperand(rcx, Code::kHeaderSize));
+  __ cmpq(rcx, FieldOperand(rdi, JSFunction::kCodeEntryOffset));
+  __ j(equal, &current);
+  __ jmp(FieldOperand(rdi, JSFunction::kCodeEntryOffset));
+  __ bind(&current);
+
+  // Count the call and recompile the function once it gets hot.  The
+  // frame has not been built yet, so the recompiled code can be entered
+  // with a tail call.
+  __ movq(rcx, FieldOperand(rdi, JSFunction::kSharedFunctionInfoOffset));
+  __ subl(FieldOperand(rcx, SharedFunctionInfo::kTierUpCounterOffset),
+          Immediate(1));
+  __ j(greater, &ok);
+  __ Jump(Handle<Code>(Builtins::builtin(Builtins::LazyRecompile)),
+          RelocInfo::CODE_TARGET);
+  __ bind(&ok);
+}
+
+
+void FullCodeGenerator::EmitBackEdgeCheck(IterationStatement* stmt) {
+  if (!info_->has_tier_up_check()) return;
+  Comment cmnt(masm_, "[ Back edge check");
+  __ movq(rcx, Operand(rbp, JavaScriptFrameConstants::kFunctionOffset));
+  __ movq(rcx, FieldOperand(rcx, JSFunction::kSharedFunctionInfoOffset));
+  __ subl(FieldOperand(rcx, SharedFunctionInfo::kTierUpCounterOffset),
+          Immediate(1));
+  if (!FLAG_use_osr || !CanReplaceOnStack()) return;
+
+  // The function got hot in this loop.  Recompile it and continue the
+  // loop in the new code, which has the same frame layout.
+  Label ok;
+  __ j(greater, &ok);
+  __ push(Operand(rbp, JavaScriptFrameConstants::kFunctionOffset));
+  __ Push(Smi::FromInt(stmt->statement_pos()));
+  __ CallRuntime(Runtime::kCompileForOnStackReplacement, 2);
+  // rax: smi offset of the loop entry in the new code, or zero.
+  __ SmiTest(rax);
+  __ j(zero, &ok);
+  __ SmiToInteger64(rax, rax);
+  __ movq(rcx, Operand(rbp, JavaScriptFrameConstants::kFunctionOffset));
+  __ addq(rax, FieldOperand(rcx, JSFunction::kCodeEntryOffset));
+  __ jmp(rax);
+  __ bind(&ok);
+}
+
+
 void FullCodeGenerator::EmitReturnSequence() {
   Comment cmnt(masm_, "[ Return sequence");
   if (return_label_.is_bound()) {
@@ -683,7 +739,7 @@ void FullCodeGenerator::VisitSwitchStatement(SwitchStatement* stmt) {
     __ jmp(clause->body_target()->entry_label());
 
     __ bind(&slow_case);
-    CompareStub stub(equal, true);
+    ICCompareStub stub(Token::EQ_STRICT, CompareIC::DEFAULT);
     __ CallStub(&stub);
     __ testq(rax, rax);
     __ j(not_equal, &next_test);
@@ -3060,7 +3116,8 @@ void FullCodeGenerator::VisitCompareOperation(CompareOperation* expr) {
       __ jmp(if_false);
 
       __ bind(&slow_case);
-      CompareStub stub(cc, strict);
+      ICCompareStub stub(ICCompareStub::ComputeOperation(cc, strict),
+                         CompareIC::DEFAULT);
       __ CallStub(&stub);
       __ testq(rax, rax);
       Split(cc, if_true, if_false, fall_through);
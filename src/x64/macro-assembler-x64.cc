@@ -105,6 +105,48 @@ void MacroAssembler::RecordWriteHelper(Register object,
 }
 
 
+void MacroAssembler::RecordWriteSlot(Register object,
+                                     Register addr,
+                                     Register value) {
+  Label done, mark_region;
+
+  if (FLAG_store_buffer) {
+    // Only stores of new-space objects go to the store buffer.  The value
+    // register is used as scratch register from here on.
+    InNewSpace(value, value, not_equal, &mark_region);
+    InNewSpace(object, value, equal, &done);
+
+    // The region of a slot in the tail of a large object cannot be found
+    // from the slot address, see StoreBuffer::Mark.
+    movq(value, object);
+    xor_(value, addr);
+    testq(value, Immediate(~Page::kPageAlignmentMask));
+    j(not_zero, &mark_region);
+
+    // Fall back to region marks if the store buffer is full.
+    movq(kScratchRegister, ExternalReference::store_buffer_top());
+    movq(value, Operand(kScratchRegister, 0));
+    movq(kScratchRegister, ExternalReference::store_buffer_limit());
+    cmpq(value, Operand(kScratchRegister, 0));
+    j(equal, &mark_region);
+
+    movq(Operand(value, 0), addr);
+    addq(value, Immediate(kPointerSize));
+    movq(kScratchRegister, ExternalReference::store_buffer_top());
+    movq(Operand(kScratchRegister, 0), value);
+    jmp(&done);
+  }
+
+  bind(&mark_region);
+  // Test that the object address is not in the new space. We cannot
+  // update page dirty marks for new space pages.
+  InNewSpace(object, value, equal, &done);
+  RecordWriteHelper(object, addr, value);
+
+  bind(&done);
+}
+
+
 void MacroAssembler::RecordWrite(Register object,
                                  int offset,
                                  Register value,
@@ -148,9 +190,7 @@ void MacroAssembler::RecordWrite(Register object,
   Label done;
   JumpIfSmi(value, &done);
 
-  InNewSpace(object, value, equal, &done);
-
-  RecordWriteHelper(object, address, value);
+  RecordWriteSlot(object, address, value);
 
   bind(&done);
 
@@ -168,8 +208,6 @@ void MacroAssembler::RecordWriteNonSmi(Register object,
                                        int offset,
                                        Register scratch,
                                        Register index) {
-  Label done;
-
   if (FLAG_debug_code) {
     Label okay;
     JumpIfNotSmi(object, &okay);
@@ -187,10 +225,6 @@ void MacroAssembler::RecordWriteNonSmi(Register object,
     }
   }
 
-  // Test that the object address is not in the new space. We cannot
-  // update page dirty marks for new space pages.
-  InNewSpace(object, scratch, equal, &done);
-
   // The offset is relative to a tagged or untagged HeapObject pointer,
   // so either offset or offset + kHeapObjectTag must be a
   // multiple of kPointerSize.
@@ -199,6 +233,8 @@ void MacroAssembler::RecordWriteNonSmi(Register object,
 
   Register dst = index;
   if (offset != 0) {
+    // The store buffer needs the exact address of the slot.
+    if (IsAligned(offset, kPointerSize)) offset -= kHeapObjectTag;
     lea(dst, Operand(object, offset));
   } else {
     // array access: calculate the destination address in the same manner as
@@ -208,9 +244,7 @@ void MacroAssembler::RecordWriteNonSmi(Register object,
                           times_pointer_size,
                           FixedArray::kHeaderSize));
   }
-  RecordWriteHelper(object, dst, scratch);
-
-  bind(&done);
+  RecordWriteSlot(object, dst, scratch);
 
   // Clobber all input registers when running with the debug-code flag
   // turned on to provoke errors.
@@ -88,6 +88,15 @@ class MacroAssembler: public Assembler {
                          Register addr,
                          Register scratch);
 
+  // Record the store of the heap object |value| into the slot at |addr|
+  // of |object|.  With --store-buffer stores of new-space objects are
+  // recorded in the store buffer, otherwise the region covering |addr| is
+  // marked dirty.  Nothing is recorded for stores into new space objects.
+  // All registers are clobbered.
+  void RecordWriteSlot(Register object,
+                       Register addr,
+                       Register value);
+
   // Check if object is in new space. The condition cc can be equal or
   // not_equal. If it is equal a jump will be done if the object is on new
   // space. The register scratch can be object itself, but it will be clobbered.
@@ -44,7 +44,15 @@ void Result::ToRegister() {
   if (is_constant()) {
     Result fresh = CodeGeneratorScope::Current()->allocator()->Allocate();
     ASSERT(fresh.is_valid());
-    CodeGeneratorScope::Current()->masm()->Move(fresh.reg(), handle());
+    if (is_untagged_int32()) {
+      // Untagged constants are smis holding their int32 value.
+      fresh.set_untagged_int32(true);
+      CodeGeneratorScope::Current()->masm()->movl(
+          fresh.reg(),
+          Immediate(Smi::cast(*handle())->value()));
+    } else {
+      CodeGeneratorScope::Current()->masm()->Move(fresh.reg(), handle());
+    }
     // This result becomes a copy of the fresh one.
     fresh.set_type_info(type_info());
     *this = fresh;
@@ -62,9 +70,16 @@ void Result::ToRegister(Register target) {
       CodeGeneratorScope::Current()->masm()->movq(fresh.reg(), reg());
     } else {
       ASSERT(is_constant());
-      CodeGeneratorScope::Current()->masm()->Move(fresh.reg(), handle());
+      if (is_untagged_int32()) {
+        CodeGeneratorScope::Current()->masm()->movl(
+            fresh.reg(),
+            Immediate(Smi::cast(*handle())->value()));
+      } else {
+        CodeGeneratorScope::Current()->masm()->Move(fresh.reg(), handle());
+      }
     }
     fresh.set_type_info(type_info());
+    fresh.set_untagged_int32(is_untagged_int32());
     *this = fresh;
   } else if (is_register() && reg().is(target)) {
     ASSERT(CodeGeneratorScope::Current()->has_valid_frame());
@@ -808,6 +808,24 @@ static Object* GenerateCheckPropertyCell(MacroAssembler* masm,
 }
 
 
+// Checks the map of the receiver against each of the maps and jumps to
+// the corresponding handler on a match. Falls through on a mismatch.
+static void GenerateMapDispatch(MacroAssembler* masm,
+                                Register receiver,
+                                Register scratch,
+                                List<Map*>* maps,
+                                List<Code*>* handlers,
+                                Label* miss) {
+  ASSERT(maps->length() == handlers->length());
+  __ JumpIfSmi(receiver, miss);
+  __ movq(scratch, FieldOperand(receiver, HeapObject::kMapOffset));
+  for (int i = 0; i < maps->length(); i++) {
+    __ Cmp(scratch, Handle<Map>(maps->at(i)));
+    __ j(equal, Handle<Code>(handlers->at(i)), RelocInfo::CODE_TARGET);
+  }
+}
+
+
 #undef __
 
 #define __ ACCESS_MASM((masm()))
@@ -1577,6 +1595,38 @@ Object* CallStubCompiler::CompileCallGlobal(JSObject* object,
   return GetCode(NORMAL, name);
 }
 
+Object* CallStubCompiler::CompileCallPolymorphic(List<Map*>* maps,
+                                                 List<Code*>* handlers,
+                                                 String* name) {
+  // ----------- S t a t e -------------
+  // rcx                 : function name
+  // rsp[0]              : return address
+  // rsp[8]              : argument argc
+  // rsp[16]             : argument argc - 1
+  // ...
+  // rsp[argc * 8]       : argument 1
+  // rsp[(argc + 1) * 8] : argument 0 = receiver
+  // -----------------------------------
+  Label miss;
+
+  GenerateNameCheck(name, &miss);
+
+  // Get the receiver from the stack.
+  const int argc = arguments().immediate();
+  __ movq(rdx, Operand(rsp, (argc + 1) * kPointerSize));
+
+  GenerateMapDispatch(masm(), rdx, rbx, maps, handlers, &miss);
+
+  // Handle call cache miss.
+  __ bind(&miss);
+  Object* obj = GenerateMissBranch();
+  if (obj->IsFailure()) return obj;
+
+  // Return the generated code.
+  return GetPolymorphicCode(name);
+}
+
+
 
 Object* LoadStubCompiler::CompileLoadCallback(String* name,
                                               JSObject* object,
@@ -1765,6 +1815,26 @@ Object* LoadStubCompiler::CompileLoadGlobal(JSObject* object,
   return GetCode(NORMAL, name);
 }
 
+Object* LoadStubCompiler::CompileLoadPolymorphic(List<Map*>* maps,
+                                                 List<Code*>* handlers,
+                                                 String* name) {
+  // ----------- S t a t e -------------
+  //  -- rax    : receiver
+  //  -- rcx    : name
+  //  -- rsp[0] : return address
+  // -----------------------------------
+  Label miss;
+
+  GenerateMapDispatch(masm(), rax, rbx, maps, handlers, &miss);
+
+  __ bind(&miss);
+  GenerateLoadMiss(masm(), Code::LOAD_IC);
+
+  // Return the generated code.
+  return GetPolymorphicCode(name);
+}
+
+
 
 Object* KeyedLoadStubCompiler::CompileLoadCallback(String* name,
                                                    JSObject* receiver,
@@ -2096,6 +2166,29 @@ Object* StoreStubCompiler::CompileStoreGlobal(GlobalObject* object,
   return GetCode(NORMAL, name);
 }
 
+Object* StoreStubCompiler::CompileStorePolymorphic(List<Map*>* maps,
+                                                   List<Code*>* handlers,
+                                                   String* name) {
+  // ----------- S t a t e -------------
+  //  -- rax    : value
+  //  -- rcx    : name
+  //  -- rdx    : receiver
+  //  -- rsp[0] : return address
+  // -----------------------------------
+  Label miss;
+
+  GenerateMapDispatch(masm(), rdx, rbx, maps, handlers, &miss);
+
+  // Handle store cache miss.
+  __ bind(&miss);
+  Handle<Code> ic(Builtins::builtin(Builtins::StoreIC_Miss));
+  __ Jump(ic, RelocInfo::CODE_TARGET);
+
+  // Return the generated code.
+  return GetPolymorphicCode(name);
+}
+
+
 
 Object* KeyedLoadStubCompiler::CompileLoadField(String* name,
                                                 JSObject* receiver,
@@ -2626,6 +2719,20 @@ Object* ConstructStubCompiler::CompileConstructStub(
   __ Assert(not_equal, "Function constructed by construct stub.");
 #endif
 
+  // Leave the allocation to the generic stub while the allocation site of the
+  // constructor collects feedback, or when it tenures the objects.
+  // rdi: constructor
+  // rbx: initial map
+  Label allocate;
+  __ movq(rcx, FieldOperand(rdi, JSFunction::kSharedFunctionInfoOffset));
+  __ movq(rcx, FieldOperand(rcx, SharedFunctionInfo::kAllocationSiteOffset));
+  __ cmpq(rcx, r8);
+  __ j(equal, &allocate);
+  __ SmiCompare(FieldOperand(rcx, AllocationSite::kStateOffset),
+                Smi::FromInt(AllocationSite::kPending));
+  __ j(less, &generic_stub_call);
+  __ bind(&allocate);
+
   // Now allocate the JSObject in new space.
   // rdi: constructor
   // rbx: initial map
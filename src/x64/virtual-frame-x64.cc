@@ -248,6 +248,13 @@ void VirtualFrame::EmitPush(Heap::RootListIndex index, TypeInfo info) {
 }
 
 
+void VirtualFrame::PushUntaggedElement(Handle<Object> value) {
+  ASSERT(value->IsSmi());
+  elements_.Add(FrameElement::ConstantElement(value, FrameElement::NOT_SYNCED));
+  elements_[element_count() - 1].set_untagged_int32(true);
+}
+
+
 void VirtualFrame::Push(Expression* expr) {
   ASSERT(expr->IsTrivial());
 
@@ -768,6 +775,7 @@ Result VirtualFrame::Pop() {
   FrameElement element = elements_.RemoveLast();
   int index = element_count();
   ASSERT(element.is_valid());
+  ASSERT(element.is_untagged_int32() == cgen()->in_safe_int32_mode());
 
   // Get number type information of the result.
   TypeInfo info;
@@ -785,6 +793,7 @@ Result VirtualFrame::Pop() {
       ASSERT(temp.is_valid());
       __ pop(temp.reg());
       temp.set_type_info(info);
+      temp.set_untagged_int32(element.is_untagged_int32());
       return temp;
     }
 
@@ -797,6 +806,7 @@ Result VirtualFrame::Pop() {
   if (element.is_register()) {
     Unuse(element.reg());
   } else if (element.is_copy()) {
+    ASSERT(!element.is_untagged_int32());
     ASSERT(element.index() < index);
     index = element.index();
     element = elements_[index];
@@ -808,6 +818,7 @@ Result VirtualFrame::Pop() {
     // Memory elements could only be the backing store of a copy.
     // Allocate the original to a register.
     ASSERT(index <= stack_pointer_);
+    ASSERT(!element.is_untagged_int32());
     Result temp = cgen()->allocator()->Allocate();
     ASSERT(temp.is_valid());
     Use(temp.reg(), index);
@@ -821,10 +832,14 @@ Result VirtualFrame::Pop() {
     __ movq(temp.reg(), Operand(rbp, fp_relative(index)));
     return Result(temp.reg(), info);
   } else if (element.is_register()) {
-    return Result(element.reg(), info);
+    Result return_value(element.reg(), info);
+    return_value.set_untagged_int32(element.is_untagged_int32());
+    return return_value;
   } else {
     ASSERT(element.is_constant());
-    return Result(element.handle());
+    Result return_value(element.handle());
+    return_value.set_untagged_int32(element.is_untagged_int32());
+    return return_value;
   }
 }
 
@@ -911,7 +926,12 @@ void VirtualFrame::SyncElementBelowStackPointer(int index) {
       break;
 
     case FrameElement::CONSTANT:
-      __ Move(Operand(rbp, fp_relative(index)), element.handle());
+      if (element.is_untagged_int32()) {
+        __ movq(Operand(rbp, fp_relative(index)),
+                Immediate(Smi::cast(*element.handle())->value()));
+      } else {
+        __ Move(Operand(rbp, fp_relative(index)), element.handle());
+      }
       break;
 
     case FrameElement::COPY: {
@@ -953,8 +973,12 @@ void VirtualFrame::SyncElementByPushing(int index) {
       break;
 
     case FrameElement::CONSTANT:
-      __ Move(kScratchRegister, element.handle());
-      __ push(kScratchRegister);
+      if (element.is_untagged_int32()) {
+        __ push(Immediate(Smi::cast(*element.handle())->value()));
+      } else {
+        __ Move(kScratchRegister, element.handle());
+        __ push(kScratchRegister);
+      }
       break;
 
     case FrameElement::COPY: {
@@ -1248,6 +1272,80 @@ Result VirtualFrame::CallConstructor(int arg_count) {
 }
 
 
+void VirtualFrame::UntaggedPushFrameSlotAt(int index) {
+  ASSERT(index >= 0);
+  ASSERT(index <= element_count());
+  FrameElement original = elements_[index];
+  if (original.is_copy()) {
+    original = elements_[original.index()];
+    index = original.index();
+  }
+
+  switch (original.type()) {
+    case FrameElement::MEMORY:
+    case FrameElement::REGISTER: {
+      // Emit code to load the original element's data into a register.
+      // Push that register as a FrameElement on top of the frame.
+      Result fresh = cgen()->allocator()->Allocate();
+      ASSERT(fresh.is_valid());
+      Register fresh_reg = fresh.reg();
+      FrameElement new_element =
+          FrameElement::RegisterElement(fresh_reg,
+                                        FrameElement::NOT_SYNCED,
+                                        original.type_info());
+      new_element.set_untagged_int32(true);
+      Use(fresh_reg, element_count());
+      fresh.Unuse();  // BreakTarget does not handle a live Result well.
+      elements_.Add(new_element);
+      if (original.is_register()) {
+        __ movq(fresh_reg, original.reg());
+      } else {
+        ASSERT(original.is_memory());
+        __ movq(fresh_reg, Operand(rbp, fp_relative(index)));
+      }
+      // Now convert the value to int32, or bail out.  Every int32 value is
+      // a smi, so values of any other type bail out.
+      if (!original.type_info().IsSmi()) {
+        Condition is_smi = masm()->CheckSmi(fresh_reg);
+        cgen()->unsafe_bailout_->Branch(NegateCondition(is_smi));
+        // The slot cannot be assigned in a side-effect-free expression, so
+        // further loads from it in the expression need no check.  The
+        // branch has replaced this frame by a copy of it.
+        cgen()->frame()->elements_[index].set_type_info(TypeInfo::Smi());
+      }
+      __ SmiToInteger32(fresh_reg, fresh_reg);
+      break;
+    }
+    case FrameElement::CONSTANT: {
+      // Constant slots hold tagged values.  Push the smi of their int32
+      // value, or bail out.
+      Handle<Object> value = original.handle();
+      bool is_int32 = false;
+      int32_t int32_value = 0;
+      if (value->IsNumber()) {
+        double double_value = value->Number();
+        int32_value = DoubleToInt32(double_value);
+        is_int32 = double_value == int32_value &&
+            !(int32_value == 0 && signbit(double_value));
+      }
+      if (!is_int32) {
+        cgen()->unsafe_bailout_->Branch(equal);
+        cgen()->unsafe_bailout_->Branch(not_equal);
+        int32_value = 0;
+      }
+      // A branch replaces this frame by a copy of it.
+      cgen()->frame()->PushUntaggedElement(
+          Handle<Object>(Smi::FromInt(int32_value)));
+      break;
+    }
+    case FrameElement::COPY:
+    case FrameElement::INVALID:
+      UNREACHABLE();
+      break;
+  }
+}
+
+
 void VirtualFrame::PushTryHandler(HandlerType type) {
   ASSERT(cgen()->HasValidEntryRegisters());
   // Grow the expression stack by handler size less one (the return
@@ -237,6 +237,12 @@ class VirtualFrame : public ZoneObject {
     PushFrameSlotAt(local0_index() + index);
   }
 
+  // Push a copy of the value of a local frame slot on top of the frame,
+  // as an untagged int32 value.
+  void UntaggedPushLocalAt(int index) {
+    UntaggedPushFrameSlotAt(local0_index() + index);
+  }
+
   // Push the value of a local frame slot on top of the frame and invalidate
   // the local slot.  The slot should be written to before trying to read
   // from it again.
@@ -275,6 +281,12 @@ class VirtualFrame : public ZoneObject {
     PushFrameSlotAt(param0_index() + index);
   }
 
+  // Push a copy of the value of a parameter frame slot on top of the frame,
+  // as an untagged int32 value.
+  void UntaggedPushParameterAt(int index) {
+    UntaggedPushFrameSlotAt(param0_index() + index);
+  }
+
   // Push the value of a paramter frame slot on top of the frame and
   // invalidate the parameter slot.  The slot should be written to before
   // trying to read from it again.
@@ -404,6 +416,9 @@ class VirtualFrame : public ZoneObject {
   inline void Push(Handle<Object> value);
   inline void Push(Smi* value);
 
+  // Push an untagged int32 constant, given as the smi of its value.
+  void PushUntaggedElement(Handle<Object> value);
+
   // Pushing a result invalidates it (its contents become owned by the
   // frame).
   void Push(Result* result) {
@@ -413,6 +428,10 @@ class VirtualFrame : public ZoneObject {
       ASSERT(result->is_constant());
       Push(result->handle());
     }
+    if (cgen()->in_safe_int32_mode()) {
+      ASSERT(result->is_untagged_int32());
+      elements_[element_count() - 1].set_untagged_int32(true);
+    }
     result->Unuse();
   }
 
@@ -425,9 +444,21 @@ class VirtualFrame : public ZoneObject {
   // the frame.  Nip(k) is equivalent to x = Pop(), Drop(k), Push(x).
   inline void Nip(int num_dropped);
 
+  // Check that the frame has no elements containing untagged int32 elements.
+  bool HasNoUntaggedInt32Elements() {
+    for (int i = 0; i < element_count(); ++i) {
+      if (elements_[i].is_untagged_int32()) return false;
+    }
+    return true;
+  }
+
   inline void SetTypeForLocalAt(int index, TypeInfo info);
   inline void SetTypeForParamAt(int index, TypeInfo info);
 
+  // Forget the type information of all (spilled) frame elements, e.g.
+  // when the frame may have been filled by other code.
+  inline void ForgetTypeInfo();
+
  private:
   static const int kLocal0Offset = JavaScriptFrameConstants::kLocal0Offset;
   static const int kFunctionOffset = JavaScriptFrameConstants::kFunctionOffset;
@@ -520,6 +551,11 @@ class VirtualFrame : public ZoneObject {
   // the frame.
   inline void PushFrameSlotAt(int index);
 
+  // Push a copy of a frame slot (typically a local or parameter) on top of
+  // the frame, as an untagged int32 value.  Bails out if the value is not
+  // a smi.
+  void UntaggedPushFrameSlotAt(int index);
+
   // Push a the value of a frame slot (typically a local or parameter) on
   // top of the frame and invalidate the slot.
   void TakeFrameSlotAt(int index);
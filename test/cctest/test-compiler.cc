@@ -213,6 +213,74 @@ TEST(Sum) {
 }
 
 
+#ifdef V8_TARGET_ARCH_X64
+
+// Returns the number of heap numbers allocated by a call of the global
+// function with the given name, which must not allocate anything else in
+// new space.
+static int CountHeapNumberAllocations(const char* name, int iterations) {
+  v8::HandleScope scope;
+  v8::Local<v8::Function> fun = v8::Local<v8::Function>::Cast(
+      env->Global()->Get(v8::String::New(name)));
+  v8::Handle<v8::Value> args[] = {
+    v8::Number::New(1.5),
+    v8::Number::New(2.25),
+    v8::Number::New(0.125),
+    v8::Integer::New(iterations)
+  };
+
+  Heap::CollectGarbage(0, NEW_SPACE);
+  int gc_count = Heap::gc_count();
+  int size = Heap::new_space()->Size();
+  v8::Local<v8::Value> result = fun->Call(env->Global(), 4, args);
+  CHECK(result->IsNumber());
+  // The count is only right if no scavenge happened during the call.
+  CHECK_EQ(gc_count, Heap::gc_count());
+  return (Heap::new_space()->Size() - size) / HeapNumber::kSize;
+}
+
+
+TEST(UnboxedDoubleArithmetic) {
+  InitializeVM();
+  v8::HandleScope scope;
+  const char* source =
+      "function %s(a, b, c, n) {"
+      "  var s = 0.5;"
+      "  for (var i = 0; i < n; i++) {"
+      "    s = a * b + c * s - (a - c) / b;"
+      "    s += a * c - b;"
+      "  }"
+      "  return s;"
+      "}"
+      "%s(1.5, 2.25, 0.125, 10);";
+  EmbeddedVector<char, 512> buffer;
+
+  // The functions are compiled on their first call.
+  bool unbox_doubles = FLAG_unbox_doubles;
+  FLAG_unbox_doubles = false;
+  OS::SNPrintF(buffer, source, "boxed", "boxed");
+  CompileRun(buffer.start());
+  FLAG_unbox_doubles = true;
+  OS::SNPrintF(buffer, source, "unboxed", "unboxed");
+  CompileRun(buffer.start());
+  FLAG_unbox_doubles = unbox_doubles;
+
+  CHECK(CompileRun("boxed(1.5, 2.25, 0.125, 100) ==\n"
+                   "    unboxed(1.5, 2.25, 0.125, 100)")->BooleanValue());
+  CHECK(CompileRun("boxed(1, 2, 3, 100) == unboxed(1, 2, 3, 100)")->
+        BooleanValue());
+
+  // With unboxed doubles each statement of the loop only boxes its result.
+  const int kIterations = 1000;
+  int boxed = CountHeapNumberAllocations("boxed", kIterations);
+  int unboxed = CountHeapNumberAllocations("unboxed", kIterations);
+  CHECK_GE(2 * kIterations + 1, unboxed);
+  CHECK_GE(boxed, 4 * kIterations);
+}
+
+#endif  // V8_TARGET_ARCH_X64
+
+
 TEST(Print) {
   InitializeVM();
   v8::HandleScope scope;
@@ -990,3 +990,208 @@ TEST(TestCodeFlushing) {
   CHECK(function->shared()->is_compiled());
   CHECK(function->is_compiled());
 }
+
+
+TEST(ParallelScavenge) {
+  // Young objects referenced from handles, from an old array and from each
+  // other are copied by several threads.  With --verify-heap the heap is
+  // checked before and after each scavenge.
+  FLAG_parallel_scavenge = true;
+  FLAG_scavenge_threads = 4;
+#ifdef DEBUG
+  FLAG_verify_heap = true;
+#endif
+  InitializeVM();
+  v8::HandleScope scope;
+
+  static const int kLength = 200;
+  Handle<FixedArray> old_array = Factory::NewFixedArray(kLength, TENURED);
+  Handle<Object> shared = Factory::NewNumber(0.5);
+  Handle<String> flat = Factory::NewStringFromAscii(
+      CStrVector("abcdefghijklmnopqrstuvwxyz"));
+  for (int i = 0; i < kLength; i++) {
+    Handle<FixedArray> young = Factory::NewFixedArray(kLength);
+    for (int j = 0; j < kLength; j += 4) {
+      Handle<Object> number = Factory::NewNumber(i * kLength + j + 0.5);
+      young->set(j, *number);
+      young->set(j + 1, *shared);
+      // A flattened cons string is replaced by its first part.
+      Handle<String> cons = Factory::NewConsString(flat, flat);
+      FlattenString(cons);
+      young->set(j + 2, *cons);
+      young->set(j + 3, *young);
+    }
+    old_array->set(i, *young);
+  }
+
+  // The first scavenge copies the arrays within the new space and the
+  // second one promotes them.
+  for (int gc = 0; gc < 4; gc++) {
+    Heap::CollectGarbage(0, NEW_SPACE);
+    for (int i = 0; i < kLength; i++) {
+      FixedArray* young = FixedArray::cast(old_array->get(i));
+      for (int j = 0; j < kLength; j += 4) {
+        CHECK_EQ(i * kLength + j + 0.5, young->get(j)->Number());
+        CHECK_EQ(*shared, young->get(j + 1));
+        String* string = String::cast(young->get(j + 2));
+        CHECK_EQ(2 * flat->length(), string->length());
+        CHECK(string->IsFlat());
+        CHECK_EQ(young, young->get(j + 3));
+      }
+    }
+  }
+
+  FLAG_parallel_scavenge = false;
+#ifdef DEBUG
+  FLAG_verify_heap = false;
+#endif
+}
+
+
+static Handle<JSFunction> GetGlobalFunction(const char* name) {
+  Object* value =
+      Top::context()->global()->GetProperty(*Factory::LookupAsciiSymbol(name));
+  CHECK(value->IsJSFunction());
+  return Handle<JSFunction>(JSFunction::cast(value));
+}
+
+
+static Object* GetGlobalProperty(const char* name) {
+  return Top::context()->global()->GetProperty(
+      *Factory::LookupAsciiSymbol(name));
+}
+
+
+TEST(AllocationSitePretenuring) {
+  // Objects that survive the scavenge after their allocation make their
+  // allocation site tenure later objects, while the objects of a site that
+  // die young keep being allocated in the new space.
+  if (!FLAG_allocation_site_pretenuring) return;
+  InitializeVM();
+  v8::HandleScope scope;
+
+  // Each site has seen more than kMementoSampleSize allocations.
+  CompileRun("function Long() { this.x = 1; }"
+             "function Short() { this.x = 2; }"
+             "function LongArray() { return [1, 2, 3]; }"
+             "var keep = [];"
+             "for (var i = 0; i < 200; i++) {"
+             "  keep.push(new Long());"
+             "  keep.push(LongArray());"
+             "  new Short();"
+             "}");
+  Handle<JSFunction> long_function = GetGlobalFunction("Long");
+  Handle<JSFunction> short_function = GetGlobalFunction("Short");
+  Handle<AllocationSite> long_site(
+      AllocationSite::cast(long_function->shared()->allocation_site()));
+  Handle<AllocationSite> short_site(
+      AllocationSite::cast(short_function->shared()->allocation_site()));
+  CHECK_EQ(AllocationSite::kPending, long_site->state());
+  CHECK_EQ(AllocationSite::kPending, short_site->state());
+
+  Heap::CollectGarbage(0, NEW_SPACE);
+  CHECK_EQ(AllocationSite::kTenure, long_site->state());
+  CHECK_EQ(AllocationSite::kDontTenure, short_site->state());
+
+  CompileRun("var long_object = new Long();"
+             "var long_array = LongArray();"
+             "var short_object = new Short();");
+  CHECK(!Heap::InNewSpace(GetGlobalProperty("long_object")));
+  CHECK(!Heap::InNewSpace(GetGlobalProperty("long_array")));
+  CHECK(Heap::InNewSpace(GetGlobalProperty("short_object")));
+
+  // Full collections keep the decisions.
+  Heap::CollectAllGarbage(false);
+  CHECK_EQ(AllocationSite::kTenure, long_site->state());
+  CHECK_EQ(AllocationSite::kDontTenure, short_site->state());
+}
+
+
+TEST(MemoryReducer) {
+  // After the objects of a burst of allocation die, an idle notification
+  // compacts the heap and returns the empty chunks to the operating system.
+  InitializeVM();
+
+  {
+    v8::HandleScope scope;
+    static const int kArrays = 2000;
+    Handle<FixedArray> arrays = Factory::NewFixedArray(kArrays, TENURED);
+    for (int i = 0; i < kArrays; i++) {
+      arrays->set(i, *Factory::NewFixedArray(1000, TENURED));
+    }
+  }
+  // Mark-sweep collections keep the chunks of the dead arrays.
+  Heap::CollectAllGarbage(false);
+  int committed_before = Heap::CommittedMemory();
+
+  v8::HeapStatistics before;
+  v8::V8::GetHeapStatistics(&before);
+  CHECK(v8::V8::IdleNotification());
+  v8::HeapStatistics after;
+  v8::V8::GetHeapStatistics(&after);
+
+  CHECK(Heap::CommittedMemory() < committed_before);
+  CHECK_GT(after.reclaimed_heap_size(), before.reclaimed_heap_size());
+  CHECK_EQ(static_cast<int>(after.total_heap_size()),
+           Heap::CommittedMemory());
+}
+
+
+TEST(StoreBuffer) {
+  // Stores of young objects into old arrays are recorded in the store
+  // buffer instead of marking regions dirty.  Recorded slots are updated by
+  // scavenges and dropped once their objects are promoted.
+  FLAG_store_buffer = true;
+#ifdef DEBUG
+  FLAG_verify_heap = true;
+#endif
+  InitializeVM();
+  v8::HandleScope scope;
+  Heap::CollectAllGarbage(false);
+  CHECK_EQ(0, StoreBuffer::length());
+
+  static const int kLength = 100;
+  Handle<FixedArray> old_array = Factory::NewFixedArray(kLength, TENURED);
+  for (int i = 0; i < kLength; i++) {
+    old_array->set(i, *Factory::NewNumber(i + 0.5));
+  }
+  CHECK_EQ(kLength, StoreBuffer::length());
+  Address first_slot = old_array->address() + FixedArray::kHeaderSize;
+  CHECK(!Page::FromAddress(first_slot)->IsRegionDirty(first_slot));
+
+  Heap::CollectGarbage(0, NEW_SPACE);
+  CHECK(Heap::InNewSpace(old_array->get(0)));
+  CHECK_EQ(kLength, StoreBuffer::length());
+  Heap::CollectGarbage(0, NEW_SPACE);
+  CHECK(!Heap::InNewSpace(old_array->get(0)));
+  CHECK_EQ(0, StoreBuffer::length());
+  for (int i = 0; i < kLength; i++) {
+    CHECK_EQ(i + 0.5, old_array->get(i)->Number());
+  }
+
+  // Storing into more distinct slots than fit in the buffer turns the
+  // recorded slots into region marks.
+  Handle<Object> young = Factory::NewNumber(0.5);
+  int arrays = StoreBuffer::kStoreBufferLength / kLength + 1;
+  Handle<FixedArray> holder = Factory::NewFixedArray(arrays, TENURED);
+  for (int i = 0; i < arrays; i++) {
+    Handle<FixedArray> array = Factory::NewFixedArray(kLength, TENURED);
+    holder->set(i, *array);
+    for (int j = 0; j < kLength; j++) array->set(j, *young);
+  }
+  CHECK(StoreBuffer::length() < StoreBuffer::kStoreBufferLength / 2);
+  Address slot = FixedArray::cast(holder->get(0))->address() +
+      FixedArray::kHeaderSize;
+  CHECK(Page::FromAddress(slot)->IsRegionDirty(slot));
+  Heap::CollectGarbage(0, NEW_SPACE);
+  Heap::CollectGarbage(0, NEW_SPACE);
+  for (int i = 0; i < arrays; i++) {
+    FixedArray* array = FixedArray::cast(holder->get(i));
+    for (int j = 0; j < kLength; j++) CHECK_EQ(*young, array->get(j));
+  }
+
+  FLAG_store_buffer = false;
+#ifdef DEBUG
+  FLAG_verify_heap = false;
+#endif
+}
@@ -30,7 +30,9 @@
 #include "v8.h"
 
 #include "global-handles.h"
+#include "incremental-marking.h"
 #include "snapshot.h"
+#include "sweeper.h"
 #include "top.h"
 #include "cctest.h"
 
@@ -340,3 +342,237 @@ TEST(ObjectGroups) {
   // All objects should be gone. 5 global handles in total.
   CHECK_EQ(5, NumberOfWeakCalls);
 }
+
+
+TEST(ParallelMarking) {
+  InitializeVM();
+  FLAG_parallel_marking = true;
+  FLAG_marking_threads = 4;
+
+  NumberOfWeakCalls = 0;
+  v8::HandleScope handle_scope;
+
+  // A wide tree of fixed arrays gives the marking threads work to steal
+  // from each other.
+  const int kWidth = 200;
+  Handle<FixedArray> tree = Factory::NewFixedArray(kWidth, TENURED);
+  for (int i = 0; i < kWidth; i++) {
+    Handle<FixedArray> node = Factory::NewFixedArray(kWidth, TENURED);
+    for (int j = 0; j < kWidth; j++) {
+      node->set(j, *Factory::NewNumber(i * kWidth + j + 0.5, TENURED));
+    }
+    tree->set(i, *node);
+  }
+  Handle<Object> live =
+      GlobalHandles::Create(FixedArray::cast(tree->get(kWidth - 1))->get(0));
+  GlobalHandles::MakeWeak(live.location(),
+                          reinterpret_cast<void*>(1234),
+                          &WeakPointerCallback);
+
+  // Garbage with the same shape.
+  Handle<Object> dead;
+  {
+    HandleScope scope;
+    Handle<FixedArray> garbage = Factory::NewFixedArray(kWidth, TENURED);
+    for (int i = 0; i < kWidth; i++) {
+      garbage->set(i, *Factory::NewFixedArray(kWidth, TENURED));
+    }
+    dead = GlobalHandles::Create(garbage->get(0));
+  }
+  GlobalHandles::MakeWeak(dead.location(),
+                          reinterpret_cast<void*>(1234),
+                          &WeakPointerCallback);
+
+  CHECK(Heap::CollectGarbage(0, OLD_POINTER_SPACE));
+
+  // Only the garbage is gone.
+  CHECK_EQ(1, NumberOfWeakCalls);
+  for (int i = 0; i < kWidth; i++) {
+    FixedArray* node = FixedArray::cast(tree->get(i));
+    for (int j = 0; j < kWidth; j++) {
+      CHECK_EQ(i * kWidth + j + 0.5, node->get(j)->Number());
+    }
+  }
+
+  FLAG_parallel_marking = false;
+}
+
+
+TEST(ParallelMarkingFindsSameLiveObjects) {
+  InitializeVM();
+  // Code flushing is disabled during parallel marking, and maps reached
+  // through large arrays are handled differently by the sequential marker.
+  FLAG_flush_code = false;
+  FLAG_collect_maps = false;
+  FLAG_marking_threads = 3;
+
+  v8::HandleScope handle_scope;
+  CompileRun("var objects = [];"
+             "for (var i = 0; i < 10000; i++) {"
+             "  objects.push({ index: i, name: 'o' + i, next: objects[i - 1] });"
+             "}");
+
+  // Collect with the sequential marker until caches that age on every full
+  // GC, like the compilation cache, have been cleared.
+  FLAG_parallel_marking = false;
+  int sequential_size = -1;
+  for (int i = 0; i < 10 && sequential_size != Heap::SizeOfObjects(); i++) {
+    sequential_size = Heap::SizeOfObjects();
+    CHECK(Heap::CollectGarbage(0, OLD_POINTER_SPACE));
+  }
+  CHECK_EQ(sequential_size, Heap::SizeOfObjects());
+
+  FLAG_parallel_marking = true;
+  CHECK(Heap::CollectGarbage(0, OLD_POINTER_SPACE));
+  CHECK_EQ(sequential_size, Heap::SizeOfObjects());
+  CHECK(Heap::CollectGarbage(0, OLD_POINTER_SPACE));
+  CHECK_EQ(sequential_size, Heap::SizeOfObjects());
+  FLAG_parallel_marking = false;
+
+  CHECK_EQ(9999, CompileRun("objects[9999].index")->Int32Value());
+  CHECK_EQ(9998, CompileRun("objects[9999].next.index")->Int32Value());
+}
+
+
+static void StepIncrementalMarkingToCompletion() {
+  // Marking is normally started at the end of a scavenge.
+  CHECK(Heap::CollectGarbage(0, NEW_SPACE));
+  IncrementalMarking::Start();
+  while (!IncrementalMarking::IsComplete()) {
+    IncrementalMarking::Step(KB);
+  }
+}
+
+
+TEST(IncrementalMarkingWriteIntoMarkedObject) {
+  InitializeVM();
+
+  NumberOfWeakCalls = 0;
+  v8::HandleScope handle_scope;
+
+  // The old object is only reachable through a young object when marking
+  // starts, so incremental marking does not reach it.
+  Handle<FixedArray> marked = Factory::NewFixedArray(1, TENURED);
+  Handle<FixedArray> young = Factory::NewFixedArray(1);
+  {
+    HandleScope scope;
+    young->set(0, *Factory::NewFixedArray(1, TENURED));
+  }
+  Handle<Object> old = GlobalHandles::Create(young->get(0));
+  GlobalHandles::MakeWeak(old.location(),
+                          reinterpret_cast<void*>(1234),
+                          &WeakPointerCallback);
+
+  StepIncrementalMarkingToCompletion();
+
+  // Move the only reference into an object that has already been visited.
+  marked->set(0, young->get(0));
+  young->set(0, Smi::FromInt(0));
+
+  // Completed marking makes the next GC a full one.
+  CHECK(Heap::CollectGarbage(0, NEW_SPACE));
+  CHECK(!IncrementalMarking::IsMarking());
+  CHECK_EQ(0, NumberOfWeakCalls);
+  CHECK(marked->get(0)->IsFixedArray());
+
+  // Once unreferenced the object is collected.
+  marked->set(0, Smi::FromInt(0));
+  Heap::CollectAllGarbage(false);
+  CHECK_EQ(1, NumberOfWeakCalls);
+}
+
+
+TEST(IncrementalMarkingYoungObjectInMarkedObject) {
+  InitializeVM();
+
+  NumberOfWeakCalls = 0;
+  v8::HandleScope handle_scope;
+
+  Handle<FixedArray> marked = Factory::NewFixedArray(1, TENURED);
+  StepIncrementalMarkingToCompletion();
+
+  // A young object only referenced from a marked object survives.
+  {
+    HandleScope scope;
+    Handle<FixedArray> young = Factory::NewFixedArray(1);
+    young->set(0, Smi::FromInt(42));
+    marked->set(0, *young);
+  }
+  Heap::CollectAllGarbage(false);
+  CHECK(!IncrementalMarking::IsMarking());
+  CHECK_EQ(42, Smi::cast(FixedArray::cast(marked->get(0))->get(0))->value());
+
+  // Objects that are unreachable when marking starts are collected by the
+  // full GC that finishes marking.
+  Handle<Object> garbage;
+  {
+    HandleScope scope;
+    garbage = GlobalHandles::Create(*Factory::NewFixedArray(1, TENURED));
+  }
+  GlobalHandles::MakeWeak(garbage.location(),
+                          reinterpret_cast<void*>(1234),
+                          &WeakPointerCallback);
+  StepIncrementalMarkingToCompletion();
+  Heap::CollectAllGarbage(false);
+  CHECK_EQ(1, NumberOfWeakCalls);
+}
+
+
+// Fills the old pointer space with arrays of which every other one is
+// garbage, collects it with the given kind of sweeping and checks that the
+// free blocks are found.
+static void TestDeferredSweeping(const char* sweeping) {
+  InitializeVM();
+  FLAG_sweeping = sweeping;
+  FLAG_never_compact = true;
+
+  v8::HandleScope handle_scope;
+  const int kLength = 100;
+  Handle<FixedArray> live = Factory::NewFixedArray(kLength, TENURED);
+  {
+    HandleScope scope;
+    for (int i = 0; i < kLength; i++) {
+      Factory::NewFixedArray(kLength, TENURED);
+      Handle<FixedArray> element = Factory::NewFixedArray(kLength, TENURED);
+      element->set(0, Smi::FromInt(i));
+      live->set(i, *element);
+    }
+  }
+
+  CHECK(Heap::CollectGarbage(0, OLD_POINTER_SPACE));
+  CHECK(Sweeper::IsSweeping());
+
+  // The garbage arrays are replaced without growing the space.
+  int capacity = Heap::old_pointer_space()->Capacity();
+  {
+    HandleScope scope;
+    for (int i = 0; i < kLength; i++) {
+      Factory::NewFixedArray(kLength, TENURED);
+    }
+  }
+  CHECK_EQ(capacity, Heap::old_pointer_space()->Capacity());
+
+  // Iterating the heap finishes sweeping.
+  HeapIterator iterator;
+  for (HeapObject* obj = iterator.next(); obj != NULL; obj = iterator.next()) {
+    CHECK(!obj->IsMarked());
+  }
+  CHECK(!Sweeper::IsSweeping());
+
+  for (int i = 0; i < kLength; i++) {
+    CHECK_EQ(i, Smi::cast(FixedArray::cast(live->get(i))->get(0))->value());
+  }
+
+  FLAG_sweeping = "eager";
+  FLAG_never_compact = false;
+}
+
+
+TEST(LazySweeping) {
+  TestDeferredSweeping("lazy");
+}
+
+
+TEST(ConcurrentSweeping) {
+  TestDeferredSweeping("concurrent");
+}
@@ -0,0 +1,188 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Flags: --expose-gc
+
+// Test the transitions of the compare IC. Each test gets freshly compiled
+// functions, so the type feedback of one test does not leak into another.
+
+var counter = 0;
+
+function compare(op) {
+  // Make the source unique to bypass the compilation cache.
+  return new Function("a", "b", "return a " + op + " b; // " + counter++);
+}
+
+// Heap numbers, mixed with smis and NaN.
+function testNumbers(lt, lte, gt, gte, eq, seq) {
+  for (var i = 0; i < 3; i++) {
+    assertTrue(lt(1.5, 2.5));
+    assertFalse(lt(2.5, 1.5));
+    assertTrue(lt(1, 1.5));
+    assertFalse(lt(NaN, 1.5));
+    assertFalse(lt(1.5, NaN));
+    assertTrue(lte(1.5, 1.5));
+    assertFalse(lte(NaN, NaN));
+    assertTrue(gt(2.5, 2));
+    assertFalse(gt(NaN, 2.5));
+    assertTrue(gte(2.5, 2.5));
+    assertFalse(gte(2.5, NaN));
+    assertTrue(eq(1.5, 1.5));
+    assertFalse(eq(NaN, NaN));
+    assertTrue(eq(2, 2.0 + 0.5 - 0.5));
+    assertTrue(seq(0.5, 0.25 + 0.25));
+    assertFalse(seq(NaN, NaN));
+    assertTrue(seq(-0, 0));
+  }
+  // Leave the numbers state.
+  assertTrue(lt("a", "b"));
+  assertTrue(eq("1.5", 1.5));
+  assertFalse(seq("1.5", 1.5));
+  assertTrue(lt(1.5, 2.5));
+  assertTrue(eq(1.5, 1.5));
+}
+
+testNumbers(compare("<"), compare("<="), compare(">"), compare(">="),
+            compare("=="), compare("==="));
+
+// Symbols, widening to strings.
+function testSymbols(eq, seq) {
+  for (var i = 0; i < 3; i++) {
+    assertTrue(eq("foo", "foo"));
+    assertFalse(eq("foo", "bar"));
+    assertTrue(seq("foo", "foo"));
+    assertFalse(seq("foo", "bar"));
+  }
+  var foo = "f" + "oo".toString();
+  assertTrue(eq(foo, "foo"));
+  assertTrue(seq("foo", foo));
+  assertFalse(eq(foo, "bar"));
+  assertFalse(seq(foo, 1));
+  assertTrue(eq(foo + 1, "foo1"));
+}
+
+testSymbols(compare("=="), compare("==="));
+
+// Strings, with the relational operators.
+function testStrings(lt, lte, gt, gte) {
+  var s = "abc".substring(1);
+  for (var i = 0; i < 3; i++) {
+    assertTrue(lt("abc", "abd"));
+    assertFalse(lt("abd", "abc"));
+    assertTrue(lt("ab", "abc"));
+    assertTrue(lte(s, "bc"));
+    assertTrue(gt("b", "abc"));
+    assertTrue(gte("bc", s));
+    assertFalse(gte("a", s));
+  }
+  // Two byte strings, numbers and objects leave the strings state.
+  assertTrue(lt("ሴ", "ስ"));
+  assertTrue(lt("a", "ስ"));
+  assertTrue(lt(1, "2"));
+  assertTrue(lt("abc", "abd"));
+}
+
+testStrings(compare("<"), compare("<="), compare(">"), compare(">="));
+
+// Objects.
+function testObjects(eq, seq) {
+  var a = {};
+  var b = {};
+  var f = function() {};
+  var arr = [];
+  for (var i = 0; i < 3; i++) {
+    assertTrue(eq(a, a));
+    assertFalse(eq(a, b));
+    assertTrue(seq(b, b));
+    assertFalse(seq(a, b));
+    assertTrue(eq(f, f));
+    assertFalse(seq(arr, a));
+  }
+  // Comparing an object to a primitive leaves the objects state.
+  var o = { valueOf: function() { return 42; } };
+  assertTrue(eq(o, 42));
+  assertFalse(seq(o, 42));
+  assertFalse(eq(a, null));
+  assertTrue(eq(a, a));
+  assertFalse(eq(a, b));
+}
+
+testObjects(compare("=="), compare("==="));
+
+// Mixed types go straight to the generic state.
+function testGeneric(lt, eq, seq) {
+  for (var i = 0; i < 3; i++) {
+    assertTrue(eq(null, undefined));
+    assertFalse(seq(null, undefined));
+    assertTrue(lt("1", 2));
+    assertTrue(eq(true, 1));
+    assertTrue(lt(1.5, 2.5));
+    assertTrue(eq("foo", "foo"));
+  }
+}
+
+testGeneric(compare("<"), compare("=="), compare("==="));
+
+// Compare ICs in switch statements and loop conditions.
+function testSwitch(x) {
+  switch (x) {
+    case 1.5: return "number";
+    case "foo": return "symbol";
+    case Object: return "object";
+    default: return "default";
+  }
+}
+
+for (var i = 0; i < 3; i++) {
+  assertEquals("number", testSwitch(1.5));
+  assertEquals("symbol", testSwitch("foo"));
+  assertEquals("symbol", testSwitch("f" + "oo".toString()));
+  assertEquals("object", testSwitch(Object));
+  assertEquals("default", testSwitch({}));
+}
+
+function testLoop(n) {
+  var count = 0;
+  for (var x = 0.5; x < n; x += 1) count++;
+  return count;
+}
+
+assertEquals(10, testLoop(10.5));
+assertEquals(0, testLoop(NaN));
+assertEquals(3, testLoop("3"));
+
+// The call sites survive a garbage collection in any state.
+var lt = compare("<");
+var eq = compare("==");
+assertTrue(lt(1.5, 2.5));
+assertTrue(eq("foo", "foo"));
+gc();
+assertTrue(lt(1.5, 2.5));
+assertFalse(lt(NaN, 2.5));
+assertTrue(eq("foo", "foo"));
+assertFalse(eq("foo", "bar"));
@@ -230,6 +230,67 @@ TestInvalid('{} ""');
 TestInvalid('{"x":true} ""');
 TestInvalid('"Garbage""After string"');
 
+// Integers that do not fit in a smi and long digit sequences.
+assertEquals(1234567890, JSON.parse("1234567890"));
+assertEquals(-1234567890, JSON.parse("-1234567890"));
+assertEquals(12345678901234567890, JSON.parse("12345678901234567890"));
+assertEquals(1e400, JSON.parse("1e400"));
+assertEquals(-Infinity, 1 / JSON.parse("-0"));
+
+// Strings with and without escapes, from ASCII and two-byte sources.
+assertEquals("\u1234", JSON.parse('"\\u1234"'));
+assertEquals("\u1234x\u00e6", JSON.parse('"\u1234x\u00e6"'));
+assertEquals(["\u1234", "abc"], JSON.parse('["\u1234", "abc"]'));
+assertEquals({"\u00e6\u1234": "\n"}, JSON.parse('{"\u00e6\\u1234": "\\n"}'));
+assertEquals("abc\ndef", JSON.parse('"abc\\ndef"'));
+assertEquals(" \t ", JSON.parse(' \t\r\n" \\t " \n'));
+
+// Array index property names become elements.
+var indexObject = JSON.parse('{"0": "a", "x": "b", "10": "c", "01": "d"}');
+assertEquals("a", indexObject[0]);
+assertEquals("b", indexObject.x);
+assertEquals("c", indexObject[10]);
+assertEquals("d", indexObject["01"]);
+
+// The last of several properties with the same name wins.
+assertEquals({"a": 3, "b": 2}, JSON.parse('{"a": 1, "b": 2, "a": 3}'));
+
+// Objects with many properties and many objects with the same properties.
+var manyKeys = [];
+for (var i = 0; i < 100; i++) manyKeys.push('"key' + i + '": ' + i);
+var manyKeysObject = JSON.parse("{" + manyKeys.join(",") + "}");
+for (var i = 0; i < 100; i++) assertEquals(i, manyKeysObject["key" + i]);
+var records = [];
+for (var i = 0; i < 100; i++) {
+  records.push('{"id": ' + i + ', "name": "n' + i + '", "ok": true}');
+}
+var parsedRecords = JSON.parse("[" + records.join(",") + "]");
+assertEquals(100, parsedRecords.length);
+for (var i = 0; i < 100; i++) {
+  assertEquals({id: i, name: "n" + i, ok: true}, parsedRecords[i]);
+}
+parsedRecords[5].extra = 42;
+assertEquals(42, parsedRecords[5].extra);
+assertEquals(undefined, parsedRecords[6].extra);
+
+// Deeply nested input overflows the stack rather than crashing.
+var deepArray = "";
+for (var i = 0; i < 100000; i++) deepArray += "[";
+assertThrows(function () { JSON.parse(deepArray); }, RangeError);
+
+TestInvalid('');
+TestInvalid(' ');
+TestInvalid('[1,]');
+TestInvalid('{"x": 1,}');
+TestInvalid('{"x" 1}');
+TestInvalid('{"x": 1 "y": 2}');
+TestInvalid('[1 2]');
+TestInvalid('"\t"');
+TestInvalid('tru');
+TestInvalid('nul');
+TestInvalid('[1, tr]');
+TestInvalid('"\u00e6');
+
 // Stringify
 
 assertEquals("true", JSON.stringify(true));
@@ -308,6 +369,44 @@ assertEquals('{}',
                                              if (k == "d") return function(){};
                                              return v; }));
 
+// Stringify objects and arrays of all kinds of values.
+assertEquals('{"a":1,"b":[1.5,-0.25,1e+21,null],"c":{"d":"e"},"f":false}',
+             JSON.stringify({a: 1, b: [1.5, -0.25, 1e21, NaN],
+                             c: {d: "e"}, f: false}));
+assertEquals('[0,null,null,null,{}]',
+             JSON.stringify([-0, undefined, function() {}, /x/, {}]));
+assertEquals('{"0":"a","2":"b","x":"c"}',
+             JSON.stringify({x: "c", 2: "b", 0: "a"}));
+assertEquals('"\\u0001\\u001f\u007f\\u00e6\\u1234\\ud800/"',
+             JSON.stringify("\u0001\u001f\u007f\u00e6\u1234\ud800/"));
+assertEquals('{"\\u00e6":"\\n"}', JSON.stringify({"\u00e6": "\n"}));
+var arrayWithProperty = [1, 2];
+arrayWithProperty.x = 3;
+assertEquals('[1,2]', JSON.stringify(arrayWithProperty));
+var slowObject = {a: 1, b: 2, c: 3};
+delete slowObject.b;
+assertEquals('{"a":1,"c":3}', JSON.stringify(slowObject));
+var deepJSONArray = [];
+for (var i = 0; i < 100; i++) deepJSONArray = [deepJSONArray, i];
+assertEquals(deepJSONArray, JSON.parse(JSON.stringify(deepJSONArray)));
+
+// Getters, toJSON methods and wrappers are honored inside nested objects.
+var getterCalls = 0;
+var withGetter = {a: 1};
+withGetter.__defineGetter__("b", function() { getterCalls++; return 2; });
+assertEquals('{"x":{"a":1,"b":2}}', JSON.stringify({x: withGetter}));
+assertEquals(1, getterCalls);
+function Point(x, y) { this.x = x; this.y = y; }
+Point.prototype.toJSON = function() { return [this.x, this.y]; };
+assertEquals('[[1,2],{"p":[3,4]}]',
+             JSON.stringify([new Point(1, 2), {p: new Point(3, 4)}]));
+assertEquals('{"n":1,"s":"x","b":true}',
+             JSON.stringify({n: new Number(1), s: new String("x"),
+                             b: new Boolean(true)}));
+var nestedCircular = {a: [{}]};
+nestedCircular.a[0].b = nestedCircular;
+assertThrows(function () { JSON.stringify(nestedCircular); }, TypeError);
+
 TestInvalid('1); throw "foo"; (1');
 
 var x = 0;
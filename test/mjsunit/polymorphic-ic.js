@@ -0,0 +1,116 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Test the polymorphic state of load, store and call inline caches:
+// sites that see a few receiver maps, changes to the prototypes and
+// the holders behind the maps already checked, and the transition to
+// the megamorphic state.
+
+function A() { this.x = 1; }
+function B() { this.y = 0; this.x = 2; }
+function C() { this.y = 0; this.z = 0; this.x = 3; }
+function D() { this.w = 0; this.x = 4; }
+function E() { this.v = 0; this.x = 5; }
+
+A.prototype.f = function() { return 'A'; };
+B.prototype.f = function() { return 'B'; };
+C.prototype.f = function() { return 'C'; };
+D.prototype.f = function() { return 'D'; };
+E.prototype.f = function() { return 'E'; };
+
+function load(o) { return o.x; }
+function store(o, v) { o.x = v; }
+function call(o) { return o.f(); }
+
+function test(objects) {
+  for (var i = 0; i < 10; i++) {
+    for (var j = 0; j < objects.length; j++) {
+      var o = objects[j];
+      store(o, j + i);
+      assertEquals(j + i, load(o));
+    }
+  }
+}
+
+function testCalls(objects, expected) {
+  for (var i = 0; i < 10; i++) {
+    for (var j = 0; j < objects.length; j++) {
+      assertEquals(expected[j], call(objects[j]));
+    }
+  }
+}
+
+var a = new A(), b = new B(), c = new C(), d = new D(), e = new E();
+
+// Polymorphic with up to four maps, then megamorphic.
+test([a, b]);
+test([a, b, c, d]);
+test([a, b, c, d, e]);
+testCalls([a, b], ['A', 'B']);
+testCalls([a, b, c], ['A', 'B', 'C']);
+
+// Changing a prototype replaces the handler for its map.
+B.prototype.f = function() { return 'B2'; };
+testCalls([a, b, c], ['A', 'B2', 'C']);
+
+// Shadowing the prototype method on a receiver changes its map.
+c.f = function() { return 'C2'; };
+testCalls([a, b, c], ['A', 'B2', 'C2']);
+
+// Loads of properties that are missing on some of the receivers.
+function loadY(o) { return o.y; }
+for (var i = 0; i < 10; i++) {
+  assertEquals(undefined, loadY(a));
+  assertEquals(0, loadY(b));
+  assertEquals(undefined, loadY(d));
+}
+A.prototype.y = 'proto';
+for (var i = 0; i < 10; i++) {
+  assertEquals('proto', loadY(a));
+  assertEquals(0, loadY(b));
+  assertEquals(undefined, loadY(d));
+}
+
+// Stores that add a property use a map transition.
+function addZ(o, v) { o.z = v; }
+for (var i = 0; i < 10; i++) {
+  var objects = [new A(), new B(), new D()];
+  for (var j = 0; j < objects.length; j++) {
+    addZ(objects[j], i);
+    assertEquals(i, objects[j].z);
+  }
+}
+
+// Values and objects mixed at a call site.
+function callToString(o) { return o.toString(); }
+var values = [a, 1, 'str', b];
+var expected = ['[object Object]', '1', 'str', '[object Object]'];
+for (var i = 0; i < 10; i++) {
+  for (var j = 0; j < values.length; j++) {
+    assertEquals(expected[j], callToString(values[j]));
+  }
+}
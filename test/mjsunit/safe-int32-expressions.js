@@ -0,0 +1,144 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Test side-effect-free int32 expressions.  Each function computes an
+// expression with at least three bit operations on local variables,
+// parameters and literals, which is compiled without tagging the
+// intermediate values.  The reference functions compute the same
+// expressions with function calls in them, which disables that code path.
+
+function id(x) { return x; }
+
+function f1(a, b, c) { return ((a ^ b) & c) | (a << 3) | (b >>> 2); }
+function r1(a, b, c) {
+  return ((id(a) ^ b) & c) | (a << 3) | (b >>> 2);
+}
+
+function f2(a, b) { return ((a | 0) + (b | 0)) ^ (a >> 1) ^ (b << 1); }
+function r2(a, b) { return ((id(a) | 0) + (b | 0)) ^ (a >> 1) ^ (b << 1); }
+
+function f3(a, b) { return (a & 0xffffffff) ^ (b | 1) ^ (a >>> 0); }
+function r3(a, b) { return (id(a) & 0xffffffff) ^ (b | 1) ^ (a >>> 0); }
+
+function f4(a, b) { return ((a / b) | 0) ^ (a % b) ^ (a & b) ^ 1; }
+function r4(a, b) { return ((id(a) / b) | 0) ^ (a % b) ^ (a & b) ^ 1; }
+
+function f5(a, b) { return (a * b) ^ (a & 3) ^ (b & 5) ^ (-a); }
+function r5(a, b) { return (id(a) * b) ^ (a & 3) ^ (b & 5) ^ (-a); }
+
+function f6(a) { return -(a & 1) ^ (a | 0) ^ (a >> 1); }
+function r6(a) { return -(id(a) & 1) ^ (a | 0) ^ (a >> 1); }
+
+// Results that are not int32 values: uint32 results of >>>, overflow,
+// fractions, and negative zero.
+function f7(a, b) { return ((a | b) >>> (b & 0)) + (a & b & 1); }
+function r7(a, b) { return ((id(a) | b) >>> (b & 0)) + (a & b & 1); }
+
+function f8(a, b) { return ((a & b) + (a | b)) * (a ^ b) + (a >> b); }
+function r8(a, b) { return ((id(a) & b) + (a | b)) * (a ^ b) + (a >> b); }
+
+function f9(a, b) { return ((a & 7) - (b & 7)) / ((a | b) & 3 ^ 1); }
+function r9(a, b) { return ((id(a) & 7) - (b & 7)) / ((a | b) & 3 ^ 1); }
+
+function f10(a, b) { return -((a & 3) ^ (b & 3) ^ (a & b & 0)); }
+function r10(a, b) { return -((id(a) & 3) ^ (b & 3) ^ (a & b & 0)); }
+
+function f11(a, b) { return ((a & 15) % ((b & 3) | 1)) * ((a | b) ^ a ^ b); }
+function r11(a, b) {
+  return ((id(a) & 15) % ((b & 3) | 1)) * ((a | b) ^ a ^ b);
+}
+
+// Shifts by variable amounts.
+function f12(a, b) { return (a << b) ^ (a >> b) ^ (a >>> (b + 1)); }
+function r12(a, b) { return (id(a) << b) ^ (a >> b) ^ (a >>> (b + 1)); }
+
+// Many live values at once.
+function f13(a, b) {
+  var c = a + 1, d = b - 1, e = a ^ b;
+  return ((a & b) | (c & d)) ^ ((e << 2) | (a >>> 3)) ^
+         ((b << 5) + (c >> 1)) ^ ((d & e) - (a | c)) ^ (e * 3);
+}
+function r13(a, b) {
+  var c = a + 1, d = b - 1, e = a ^ b;
+  return ((id(a) & b) | (c & d)) ^ ((e << 2) | (a >>> 3)) ^
+         ((b << 5) + (c >> 1)) ^ ((d & e) - (a | c)) ^ (e * 3);
+}
+
+// Literals that are not int32 values.
+function f14(a, b) { return ((a | b) ^ (a & b) ^ (a << 1)) + 0.5; }
+function r14(a, b) { return ((id(a) | b) ^ (a & b) ^ (a << 1)) + 0.5; }
+
+function f15(a, b) { return -0 - ((a | b) ^ (a & b) ^ (a << 1)); }
+function r15(a, b) { return -0 - ((id(a) | b) ^ (a & b) ^ (a << 1)); }
+
+var pairs = [[f1, r1], [f2, r2], [f3, r3], [f4, r4], [f5, r5], [f6, r6],
+             [f7, r7], [f8, r8], [f9, r9], [f10, r10], [f11, r11],
+             [f12, r12], [f13, r13], [f14, r14], [f15, r15]];
+
+var values = [0, 1, -1, 2, 3, 7, 31, 32, 33, 65536, 123456789,
+              0x3fffffff, 0x40000000, 0x7fffffff, -0x80000000, 0x80000000,
+              0xffffffff, 1e20, 1.5, -2.5, -0, NaN, Infinity, -Infinity,
+              "12", "x", null, undefined, true,
+              {valueOf: function() { return 5; }}];
+
+for (var p = 0; p < pairs.length; p++) {
+  var f = pairs[p][0];
+  var r = pairs[p][1];
+  for (var i = 0; i < values.length; i++) {
+    for (var j = 0; j < values.length; j++) {
+      var a = values[i];
+      var b = values[j];
+      assertEquals(r(a, b, 0x5555), f(a, b, 0x5555),
+                   f.name + "(" + a + ", " + b + ")");
+    }
+  }
+}
+
+// A hash loop in the style of crypto code.
+function hash(s) {
+  var h = 0x811c9dc5;
+  for (var i = 0; i < s.length; i++) {
+    var c = s.charCodeAt(i);
+    h = (h ^ c) & 0xffffffff;
+    h = ((h << 1) + (h << 4) + (h << 7) + (h << 8) + (h << 24) + h) | 0;
+  }
+  return h;
+}
+
+function referenceHash(s) {
+  var h = 0x811c9dc5;
+  for (var i = 0; i < s.length; i++) {
+    var c = s.charCodeAt(i);
+    h = (id(h) ^ c) & 0xffffffff;
+    h = ((id(h) << 1) + (h << 4) + (h << 7) + (h << 8) + (h << 24) + h) | 0;
+  }
+  return h;
+}
+
+var text = "";
+for (var i = 0; i < 100; i++) text += String.fromCharCode(32 + i);
+assertEquals(referenceHash(text), hash(text));
@@ -0,0 +1,161 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Flags: --tiered-compilation --tier-up-threshold=20 --expose-gc
+
+// Test that loops of functions called only once keep computing the same
+// results when they continue in the recompiled code of their function
+// (on-stack replacement).
+
+function sum(n) {
+  var s = 0;
+  for (var i = 0; i < n; i++) s += i;
+  return s;
+}
+assertEquals(4999950000, sum(100000));
+
+// The loop variable stops being a smi in the full code.
+function overflow(n) {
+  var x = 1073741820;
+  for (var i = 0; i < n; i++) x++;
+  return x;
+}
+assertEquals(1073742820, overflow(1000));
+
+// Locals that are smis before the loop hold doubles when it is replaced.
+function doubles(n) {
+  var x = 0;
+  var i = 0;
+  while (i < n) {
+    x = x + 0.5;
+    i++;
+  }
+  return x;
+}
+assertEquals(500, doubles(1000));
+
+function doWhile(n) {
+  var i = 0;
+  var c = 0;
+  do {
+    c += 2;
+    if (i % 3 == 0) continue;
+    c--;
+  } while (++i < n);
+  return c;
+}
+assertEquals(1334, doWhile(1000));
+
+function infinite() {
+  var i = 0;
+  while (true) {
+    if (++i > 1000) break;
+  }
+  do {
+    if (++i > 2000) break;
+  } while (true);
+  for (;;) {
+    if (++i > 3000) return i;
+  }
+}
+assertEquals(3001, infinite());
+
+function nested(n) {
+  var s = 0;
+  for (var i = 0; i < n; i++) {
+    for (var j = 0; j < n; j++) s += j;
+  }
+  return s;
+}
+assertEquals(4950 * 100, nested(100));
+
+// Arguments object and context allocated by the full code.
+function withArguments() {
+  var s = 0;
+  for (var i = 0; i < 1000; i++) s += arguments.length + arguments[0];
+  return s;
+}
+assertEquals(5000, withArguments(3, 4));
+
+function withContext(n) {
+  var t = 0;
+  var get = function() { return t; };
+  for (var i = 0; i < n; i++) t++;
+  return get();
+}
+assertEquals(1000, withContext(1000));
+
+// Loops that keep state on the stack stay in the full code.
+function inTry(n) {
+  var s = 0;
+  try {
+    for (var i = 0; i < n; i++) s += i;
+  } catch (e) { }
+  return s;
+}
+assertEquals(499500, inTry(1000));
+
+function inForIn(o) {
+  var s = 0;
+  for (var p in o) {
+    for (var i = 0; i < 1000; i++) s += o[p];
+  }
+  return s;
+}
+assertEquals(3000, inForIn({a: 1, b: 2}));
+
+function inSwitch(n) {
+  var s = 0;
+  switch (n) {
+    case 1000:
+      for (var i = 0; i < n; i++) s += i;
+  }
+  return s;
+}
+assertEquals(499500, inSwitch(1000));
+
+// Recursive activations keep the loop in the full code.
+function recursive(depth) {
+  var s = 0;
+  for (var i = 0; i < 100; i++) {
+    s += (depth > 0 && i == 50) ? recursive(depth - 1) : 1;
+  }
+  return s;
+}
+assertEquals(10000, recursive(100));
+
+// Allocation and garbage collection in the replaced loop.
+function allocate(n) {
+  var a = [];
+  for (var i = 0; i < n; i++) {
+    a.push({ value: i });
+    if (i % 500 == 0) gc();
+  }
+  return a[n - 1].value;
+}
+assertEquals(1999, allocate(2000));
@@ -0,0 +1,94 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Flags: --tiered-compilation --tier-up-threshold=20 --expose-gc
+
+// Test that functions keep computing the same results when they are
+// recompiled with the optimizing code generator after getting hot,
+// including while activations of their full-codegen code are on the stack.
+
+function add(a, b) { return a + b; }
+for (var i = 0; i < 100; i++) assertEquals(2 * i + 1, add(i, i + 1));
+assertEquals("ab", add("a", "b"));
+
+// Arguments adaptation on entry to code with a tier-up check.
+function count() { return arguments.length; }
+for (var i = 0; i < 100; i++) {
+  assertEquals(0, count());
+  assertEquals(3, count(1, 2, 3));
+}
+
+function missing(a, b, c) { return typeof c; }
+for (var i = 0; i < 100; i++) assertEquals("undefined", missing(i));
+
+// Loops count towards recompilation on the next call.
+function sum(n) {
+  var s = 0;
+  for (var i = 0; i < n; i++) s += i;
+  var j = 0;
+  while (j < n) j++;
+  do { j--; } while (j > 0);
+  for (var p in { a: 1, b: 2 }) s += p.length;
+  return s;
+}
+for (var i = 0; i < 10; i++) assertEquals(4950 + 2, sum(100));
+
+// Recursion keeps activations of the hot function on the stack.
+function fib(n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }
+assertEquals(6765, fib(20));
+assertEquals(6765, fib(20));
+
+// Closures created from the same function literal share the counter.
+var adders = [];
+for (var i = 0; i < 10; i++) {
+  adders.push(function(x, y) { return x + y; });
+}
+for (var k = 0; k < 20; k++) {
+  for (var i = 0; i < adders.length; i++) assertEquals(i + k, adders[i](i, k));
+}
+
+// Constructors and exceptions.
+function Thing(x) {
+  if (x < 0) throw "negative";
+  this.value = x * 2;
+}
+for (var i = 0; i < 100; i++) {
+  assertEquals(2 * i, new Thing(i).value);
+  assertThrows("new Thing(-1)");
+}
+
+// Recompilation interleaved with garbage collection.
+function allocate(n) {
+  var a = [];
+  for (var i = 0; i < n; i++) a.push({ i: i });
+  return a.length;
+}
+for (var i = 0; i < 50; i++) {
+  assertEquals(i, allocate(i));
+  if (i % 10 == 0) gc();
+}
@@ -0,0 +1,109 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Test arithmetic expressions in loops that are computed with unboxed
+// doubles, including the fallback to generic code for non-number operands.
+
+function tree(a, b, c, n) {
+  var s = 0;
+  for (var i = 0; i < n; i++) {
+    s = a * b + c / (a - b) - c;
+  }
+  return s;
+}
+
+assertEquals(1.5 * 2.5 + 0.5 / (1.5 - 2.5) - 0.5, tree(1.5, 2.5, 0.5, 3));
+assertEquals(1 * 2 + 3 / (1 - 2) - 3, tree(1, 2, 3, 3));
+assertEquals(Infinity, tree(1.5, 1.5, 0.5, 3));
+assertTrue(isNaN(tree(NaN, 1, 2, 3)));
+assertEquals(0, tree(1, 2, 3, 0));
+assertEquals(1.5 * 2 + 3 / (1.5 - 2) - 3, tree(1.5, 2, 3, 3));
+
+// Strings and objects take the generic path, with conversions in the
+// order of the operations.
+assertEquals(tree(1.5, 2.5, 0.5, 3), tree("1.5", 2.5, 0.5, 3));
+var log = [];
+function logged(name, value) {
+  return { valueOf: function() { log.push(name); return value; } };
+}
+tree(logged("a", 1.5), logged("b", 2.5), logged("c", 0.5), 1);
+assertEquals(["a", "b", "a", "b", "c", "c"], log);
+
+// Addition of strings.
+function concat(a, b, n) {
+  var s;
+  for (var i = 0; i < n; i++) s = a + b + a * 1.5;
+  return s;
+}
+assertEquals("abNaN", concat("a", "b", 2));
+assertEquals(1 + 2.5 + 1.5, concat(1, 2.5, 2));
+assertEquals("1.5x2.25", concat(1.5, "x", 2));
+
+// Negative zero survives.
+function negativeZero(a, b, n) {
+  var s;
+  for (var i = 0; i < n; i++) s = a * b * 1.5 / 2;
+  return s;
+}
+assertEquals(-Infinity, 1 / negativeZero(-0.5, 0, 2));
+
+// Compound assignments.
+function compound(a, b, n) {
+  var s = 0.5;
+  for (var i = 0; i < n; i++) {
+    s += a * b;
+    s -= b / a;
+  }
+  return s;
+}
+var expected = 0.5;
+for (var i = 0; i < 10; i++) {
+  expected += 1.5 * 2.5;
+  expected -= 2.5 / 1.5;
+}
+assertEquals(expected, compound(1.5, 2.5, 10));
+assertEquals(compound(1.5, 5, 1), compound(1.5, "5", 1));
+
+// Repeated variables and literals.
+function poly(x, n) {
+  var y;
+  for (var i = 0; i < n; i++) y = x * x * 0.5 + x * 1.25 - 3;
+  return y;
+}
+assertEquals(2.5 * 2.5 * 0.5 + 2.5 * 1.25 - 3, poly(2.5, 2));
+assertEquals(2 * 2 * 0.5 + 2 * 1.25 - 3, poly(2, 2));
+
+// Enough iterations to run into scavenges.
+function sum(a, b, n) {
+  var s = 0;
+  for (var i = 0; i < n; i++) s = s + a * b - a / b;
+  return s;
+}
+expected = 0;
+for (var i = 0; i < 100000; i++) expected += 1.5 * 0.25 - 1.5 / 0.25;
+assertEquals(expected, sum(1.5, 0.25, 100000));
@@ -31,12 +31,15 @@
     'gcc_version%': 'unknown',
     'v8_target_arch%': '<(target_arch)',
     'v8_use_snapshot%': 'true',
+    # Log2 of the page size of the paged heap spaces, see src/globals.h.
+    'v8_page_size_bits%': 13,
   },
   'target_defaults': {
     'defines': [
       'ENABLE_LOGGING_AND_PROFILING',
       'ENABLE_DEBUGGER_SUPPORT',
       'ENABLE_VMSTATE_TRACKING',
+      'V8_PAGE_SIZE_BITS=<(v8_page_size_bits)',
     ],
     'conditions': [
       ['OS!="mac"', {
@@ -368,6 +371,10 @@
         '../../src/ic-inl.h',
         '../../src/ic.cc',
         '../../src/ic.h',
+        '../../src/incremental-marking.cc',
+        '../../src/incremental-marking.h',
+        '../../src/inlining.cc',
+        '../../src/inlining.h',
         '../../src/interpreter-irregexp.cc',
         '../../src/interpreter-irregexp.h',
         '../../src/jump-target-inl.h',
@@ -375,6 +382,10 @@
         '../../src/jump-target.h',
         '../../src/jsregexp.cc',
         '../../src/jsregexp.h',
+        '../../src/json-parser.cc',
+        '../../src/json-parser.h',
+        '../../src/json-stringifier.cc',
+        '../../src/json-stringifier.h',
         '../../src/list-inl.h',
         '../../src/list.h',
         '../../src/liveedit.cc',
@@ -399,6 +410,8 @@
         '../../src/objects.h',
         '../../src/oprofile-agent.h',
         '../../src/oprofile-agent.cc',
+        '../../src/parallel-scavenger.cc',
+        '../../src/parallel-scavenger.h',
         '../../src/parser.cc',
         '../../src/parser.h',
         '../../src/platform.h',
@@ -441,10 +454,14 @@
         '../../src/spaces-inl.h',
         '../../src/spaces.cc',
         '../../src/spaces.h',
+        '../../src/store-buffer.cc',
+        '../../src/store-buffer.h',
         '../../src/string-stream.cc',
         '../../src/string-stream.h',
         '../../src/stub-cache.cc',
         '../../src/stub-cache.h',
+        '../../src/sweeper.cc',
+        '../../src/sweeper.h',
         '../../src/token.cc',
         '../../src/token.h',
         '../../src/top.cc',
@@ -474,6 +491,7 @@
         '../../src/vm-state-inl.h',
         '../../src/vm-state.cc',
         '../../src/vm-state.h',
+        '../../src/work-stealing-deque.h',
         '../../src/zone-inl.h',
         '../../src/zone.cc',
         '../../src/zone.h',